@@ -0,0 +1,5 @@
+#include <benchmark/benchmark.h>
+
+
+//run with --benchmark_out=<file> --benchmark_out_format=json for machine readable results
+BENCHMARK_MAIN();
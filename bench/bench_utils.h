@@ -0,0 +1,18 @@
+//helpers shared by all the benchmarks, the element types are the ones from the gtest suite
+#ifndef __MY_STL_BENCH_UTILS_H
+#define __MY_STL_BENCH_UTILS_H
+
+#include "../test/test_objects.h"
+#include <cstdlib>  //for rand
+
+
+//build the ith element of type T, every test object can be built from an int
+template <typename T>
+inline T make_value(int i) {
+    return T(i);
+}
+
+//the size range every container benchmark runs over
+#define MY_STL_BENCH_SIZES  RangeMultiplier(8)->Range(8, 1 << 18)
+
+#endif
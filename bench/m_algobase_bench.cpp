@@ -0,0 +1,70 @@
+#include "../src/m_algobase.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include "bench_utils.h"
+
+
+//copy bandwidth over contiguous ranges, my_stl::copy against std::copy
+struct my_stl_copy {
+    template <typename T>
+    static T* copy(const T* first, const T* last, T* result) {return my_stl::copy(first, last, result);}
+};
+
+struct std_copy {
+    template <typename T>
+    static T* copy(const T* first, const T* last, T* result) {return std::copy(first, last, result);}
+};
+
+template <typename Impl, typename T>
+static void BM_Copy(benchmark::State& state) {
+    const int n = state.range(0);
+    const std::vector<T> source(n, make_value<T>(3));
+    std::vector<T> dest(n);
+    for (auto _: state) {
+        Impl::copy(source.data(), source.data() + n, dest.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(T));
+}
+
+#define BENCH_COPY(T)                                                                       \
+    BENCHMARK_TEMPLATE(BM_Copy, my_stl_copy, T)->MY_STL_BENCH_SIZES;                        \
+    BENCHMARK_TEMPLATE(BM_Copy, std_copy, T)->MY_STL_BENCH_SIZES
+
+BENCH_COPY(int);
+BENCH_COPY(Test_FOO_Simple);
+BENCH_COPY(Test_FOO_Array);
+BENCH_COPY(Test_FOO_Heap);
+
+//fill bandwidth, my_stl::fill against std::fill
+template <typename T>
+static void BM_FillMyStl(benchmark::State& state) {
+    const int n = state.range(0);
+    std::vector<T> dest(n);
+    const T value = make_value<T>(3);
+    for (auto _: state) {
+        my_stl::fill(dest.data(), dest.data() + n, value);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(T));
+}
+
+template <typename T>
+static void BM_FillStd(benchmark::State& state) {
+    const int n = state.range(0);
+    std::vector<T> dest(n);
+    const T value = make_value<T>(3);
+    for (auto _: state) {
+        std::fill(dest.data(), dest.data() + n, value);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_FillMyStl, int)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_FillStd, int)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_FillMyStl, short)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_FillStd, short)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_FillMyStl, Test_FOO_Simple)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_FillStd, Test_FOO_Simple)->MY_STL_BENCH_SIZES;
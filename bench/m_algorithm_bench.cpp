@@ -0,0 +1,124 @@
+#include "../src/m_algorithm.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "bench_utils.h"
+
+
+//my_stl::sort and friends against the std ones on the same inputs
+struct my_stl_sort {
+    template <typename T>
+    static void sort(T* first, T* last) {my_stl::sort(first, last);}
+    template <typename T>
+    static void stable_sort(T* first, T* last) {my_stl::stable_sort(first, last);}
+    template <typename T>
+    static void nth_element(T* first, T* nth, T* last) {my_stl::nth_element(first, nth, last);}
+};
+
+struct std_sort {
+    template <typename T>
+    static void sort(T* first, T* last) {std::sort(first, last);}
+    template <typename T>
+    static void stable_sort(T* first, T* last) {std::stable_sort(first, last);}
+    template <typename T>
+    static void nth_element(T* first, T* nth, T* last) {std::nth_element(first, nth, last);}
+};
+
+//random, sorted but for one in a hundred swapped, and few distinct keys
+enum {random_input, mostly_sorted_input, few_keys_input};
+
+template <typename T>
+static std::vector<T> make_input(int n, int shape) {
+    std::vector<T> res;
+    srand(n);
+    for (int i = 0; i < n; ++i) {
+        res.push_back(make_value<T>(shape == random_input ? rand() : shape == few_keys_input ? rand() % 16 : i));
+    }
+    if (shape == mostly_sorted_input) {
+        for (int i = 0; i < n / 100; ++i) {
+            std::swap(res[rand() % n], res[rand() % n]);
+        }
+    }
+    return res;
+}
+
+template <typename Impl, typename T, int Shape>
+static void BM_Sort(benchmark::State& state) {
+    const std::vector<T> input = make_input<T>(state.range(0), Shape);
+    std::vector<T> v;
+    for (auto _: state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        Impl::sort(v.data(), v.data() + v.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+template <typename Impl, typename T>
+static void BM_StableSort(benchmark::State& state) {
+    const std::vector<T> input = make_input<T>(state.range(0), random_input);
+    std::vector<T> v;
+    for (auto _: state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        Impl::stable_sort(v.data(), v.data() + v.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+template <typename Impl, typename T>
+static void BM_NthElement(benchmark::State& state) {
+    const std::vector<T> input = make_input<T>(state.range(0), random_input);
+    std::vector<T> v;
+    for (auto _: state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        Impl::nth_element(v.data(), v.data() + v.size() / 2, v.data() + v.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+#define BENCH_SORT(T)                                                                          \
+    BENCHMARK_TEMPLATE(BM_Sort, my_stl_sort, T, random_input)->MY_STL_BENCH_SIZES;             \
+    BENCHMARK_TEMPLATE(BM_Sort, std_sort, T, random_input)->MY_STL_BENCH_SIZES;                \
+    BENCHMARK_TEMPLATE(BM_Sort, my_stl_sort, T, mostly_sorted_input)->MY_STL_BENCH_SIZES;      \
+    BENCHMARK_TEMPLATE(BM_Sort, std_sort, T, mostly_sorted_input)->MY_STL_BENCH_SIZES;         \
+    BENCHMARK_TEMPLATE(BM_Sort, my_stl_sort, T, few_keys_input)->MY_STL_BENCH_SIZES;           \
+    BENCHMARK_TEMPLATE(BM_Sort, std_sort, T, few_keys_input)->MY_STL_BENCH_SIZES;              \
+    BENCHMARK_TEMPLATE(BM_StableSort, my_stl_sort, T)->MY_STL_BENCH_SIZES;                     \
+    BENCHMARK_TEMPLATE(BM_StableSort, std_sort, T)->MY_STL_BENCH_SIZES;                        \
+    BENCHMARK_TEMPLATE(BM_NthElement, my_stl_sort, T)->MY_STL_BENCH_SIZES;                     \
+    BENCHMARK_TEMPLATE(BM_NthElement, std_sort, T)->MY_STL_BENCH_SIZES
+
+BENCH_SORT(int);
+BENCH_SORT(double);
+BENCH_SORT(long long);
+
+//radix sort of random keys against the comparison sorts
+template <typename T>
+static void BM_RadixSort(benchmark::State& state) {
+    const std::vector<T> input = make_input<T>(state.range(0), random_input);
+    std::vector<T> v;
+    for (auto _: state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        my_stl::radix_sort(v.data(), v.data() + v.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_RadixSort, unsigned)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_Sort, my_stl_sort, unsigned, random_input)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_Sort, std_sort, unsigned, random_input)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_RadixSort, unsigned long long)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_RadixSort, float)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_Sort, my_stl_sort, float, random_input)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_Sort, std_sort, float, random_input)->MY_STL_BENCH_SIZES;
@@ -0,0 +1,65 @@
+#include "../src/m_alloc.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+
+//every allocator under test is wrapped into the same static byte interface
+struct default_alloc_bytes {
+    static void* allocate(size_t n) {return my_stl::__default_alloc<0>::allocate(n);}
+    static void deallocate(void* p, size_t n) {my_stl::__default_alloc<0>::deallocate(p, n);}
+};
+
+struct malloc_alloc_bytes {
+    static void* allocate(size_t n) {return my_stl::__malloc_alloc<0>::allocate(n);}
+    static void deallocate(void* p, size_t n) {my_stl::__malloc_alloc<0>::deallocate(p, n);}
+};
+
+struct new_allocator_bytes {
+    static void* allocate(size_t n) {return my_stl::new_allocator<char>::allocate(n);}
+    static void deallocate(void* p, size_t n) {my_stl::new_allocator<char>::deallocate((char*)p, n);}
+};
+
+struct std_allocator_bytes {
+    static void* allocate(size_t n) {return std::allocator<char>().allocate(n);}
+    static void deallocate(void* p, size_t n) {std::allocator<char>().deallocate((char*)p, n);}
+};
+
+#define BENCH_ALLOC(func)                                                     \
+    BENCHMARK_TEMPLATE(func, default_alloc_bytes)->RangeMultiplier(2)->Range(8, 512);   \
+    BENCHMARK_TEMPLATE(func, malloc_alloc_bytes)->RangeMultiplier(2)->Range(8, 512);    \
+    BENCHMARK_TEMPLATE(func, new_allocator_bytes)->RangeMultiplier(2)->Range(8, 512);   \
+    BENCHMARK_TEMPLATE(func, std_allocator_bytes)->RangeMultiplier(2)->Range(8, 512)
+
+//latency of a single allocate/deallocate pair of the given size
+template <typename Alloc>
+static void BM_AllocFreePair(benchmark::State& state) {
+    const size_t bytes = state.range(0);
+    for (auto _: state) {
+        void* p = Alloc::allocate(bytes);
+        benchmark::DoNotOptimize(p);
+        Alloc::deallocate(p, bytes);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCH_ALLOC(BM_AllocFreePair);
+
+//allocate a batch of blocks and free them in the same order, closer to what a node based
+//container does
+template <typename Alloc>
+static void BM_AllocBatch(benchmark::State& state) {
+    const size_t bytes = state.range(0);
+    const int batch = 4096;
+    std::vector<void*> blocks(batch);
+    for (auto _: state) {
+        for (int i = 0; i < batch; ++i) {
+            blocks[i] = Alloc::allocate(bytes);
+        }
+        benchmark::DoNotOptimize(blocks.data());
+        for (int i = 0; i < batch; ++i) {
+            Alloc::deallocate(blocks[i], bytes);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCH_ALLOC(BM_AllocBatch);
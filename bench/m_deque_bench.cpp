@@ -0,0 +1,74 @@
+#include "../src/m_deque.h"
+#include "../src/m_list.h"
+#include "../src/m_vector.h"
+#include <benchmark/benchmark.h>
+#include <deque>
+#include <list>
+#include "bench_utils.h"
+
+
+//deque against std::deque, and list which is what a queue would use without it
+#define BENCH_QUEUE(func, T)                                                  \
+    BENCHMARK_TEMPLATE(func, my_stl::deque<T>)->MY_STL_BENCH_SIZES;           \
+    BENCHMARK_TEMPLATE(func, std::deque<T>)->MY_STL_BENCH_SIZES;              \
+    BENCHMARK_TEMPLATE(func, my_stl::list<T>)->MY_STL_BENCH_SIZES
+
+//a FIFO work queue holding n elements, one pushed at the back for every one popped at
+//the front. The blocks emptied at the front are reused at the back
+template <typename Queue>
+static void BM_QueueFifo(benchmark::State& state) {
+    typedef typename Queue::value_type T;
+    const int n = state.range(0);
+    Queue queue;
+    for (int i = 0; i < n; ++i) {
+        queue.push_back(make_value<T>(i));
+    }
+    const T value = make_value<T>(1);
+    for (auto _: state) {
+        for (int i = 0; i < 64; ++i) {
+            queue.pop_front();
+            queue.push_back(value);
+        }
+        benchmark::DoNotOptimize(&queue.front());
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCH_QUEUE(BM_QueueFifo, int);
+BENCH_QUEUE(BM_QueueFifo, Test_FOO_Heap);
+
+//grow from empty at both ends
+template <typename Queue>
+static void BM_QueuePushBothEnds(benchmark::State& state) {
+    typedef typename Queue::value_type T;
+    const int n = state.range(0);
+    const T value = make_value<T>(1);
+    for (auto _: state) {
+        Queue queue;
+        for (int i = 0; i < n; i += 2) {
+            queue.push_back(value);
+            queue.push_front(value);
+        }
+        benchmark::DoNotOptimize(&queue.front());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_QUEUE(BM_QueuePushBothEnds, int);
+BENCH_QUEUE(BM_QueuePushBothEnds, Test_FOO_Heap);
+
+//the deque by index, against vector
+template <typename Sequence>
+static void BM_SequenceIndex(benchmark::State& state) {
+    const int n = state.range(0);
+    Sequence seq(n, 1);
+    for (auto _: state) {
+        long sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += seq[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_SequenceIndex, my_stl::deque<int>)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_SequenceIndex, std::deque<int>)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_SequenceIndex, my_stl::vector<int>)->MY_STL_BENCH_SIZES;
@@ -0,0 +1,51 @@
+#include "../src/m_execution.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "bench_utils.h"
+
+
+//the policy overloads with seq and par on large ranges, par scales with the cores of the
+//machine (a single core machine runs it serially, the numbers are the same)
+#define MY_STL_EXECUTION_SIZES  RangeMultiplier(8)->Range(1 << 12, 1 << 24)
+
+template <typename Policy>
+static void BM_ExecutionFill(benchmark::State& state) {
+    std::vector<long long> v(state.range(0));
+    for (auto _: state) {
+        my_stl::fill(Policy(), v.data(), v.data() + v.size(), 42LL);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * v.size() * sizeof(long long));
+}
+BENCHMARK_TEMPLATE(BM_ExecutionFill, my_stl::execution::sequenced_policy)->MY_STL_EXECUTION_SIZES;
+BENCHMARK_TEMPLATE(BM_ExecutionFill, my_stl::execution::parallel_policy)->MY_STL_EXECUTION_SIZES;
+
+template <typename Policy>
+static void BM_ExecutionCopy(benchmark::State& state) {
+    std::vector<long long> src(state.range(0), 7), dst(state.range(0));
+    for (auto _: state) {
+        my_stl::copy(Policy(), src.data(), src.data() + src.size(), dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * src.size() * sizeof(long long));
+}
+BENCHMARK_TEMPLATE(BM_ExecutionCopy, my_stl::execution::sequenced_policy)->MY_STL_EXECUTION_SIZES;
+BENCHMARK_TEMPLATE(BM_ExecutionCopy, my_stl::execution::parallel_policy)->MY_STL_EXECUTION_SIZES;
+
+template <typename Policy>
+static void BM_ExecutionSort(benchmark::State& state) {
+    std::vector<int> input(state.range(0));
+    srand(state.range(0));
+    for (auto& x : input) x = rand();
+    std::vector<int> v;
+    for (auto _: state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        my_stl::sort(Policy(), v.data(), v.data() + v.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_ExecutionSort, my_stl::execution::sequenced_policy)->MY_STL_EXECUTION_SIZES;
+BENCHMARK_TEMPLATE(BM_ExecutionSort, my_stl::execution::parallel_policy)->MY_STL_EXECUTION_SIZES;
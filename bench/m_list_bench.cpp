@@ -0,0 +1,126 @@
+#include "../src/m_list_parallel.h"
+#include <benchmark/benchmark.h>
+#include <list>
+#include <vector>
+#include <utility>     //for std::swap
+#include "bench_utils.h"
+
+
+//the node pool keeps the nodes of one list next to each other
+template <typename T>
+using pool_list = my_stl::list<T, my_stl::node_pool<>>;
+
+#define BENCH_LIST(func, T)                                                   \
+    BENCHMARK_TEMPLATE(func, my_stl::list<T>)->MY_STL_BENCH_SIZES;            \
+    BENCHMARK_TEMPLATE(func, pool_list<T>)->MY_STL_BENCH_SIZES;               \
+    BENCHMARK_TEMPLATE(func, std::list<T>)->MY_STL_BENCH_SIZES
+
+template <typename List>
+static void BM_ListPushBack(benchmark::State& state) {
+    typedef typename List::value_type T;
+    const int n = state.range(0);
+    const T value = make_value<T>(1);
+    for (auto _: state) {
+        List l;
+        for (int i = 0; i < n; ++i) {
+            l.push_back(value);
+        }
+        benchmark::DoNotOptimize(&l.front());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_LIST(BM_ListPushBack, int);
+BENCH_LIST(BM_ListPushBack, Test_FOO_Simple);
+BENCH_LIST(BM_ListPushBack, Test_FOO_Array);
+BENCH_LIST(BM_ListPushBack, Test_FOO_Heap);
+
+//the same random sequence for every list type
+static std::vector<int> random_ints(int n) {
+    std::vector<int> res(n);
+    srand(n);
+    for (int i = 0; i < n; ++i) {
+        res[i] = rand();
+    }
+    return res;
+}
+
+template <typename List>
+static void BM_ListSortInt(benchmark::State& state) {
+    const std::vector<int> input = random_ints(state.range(0));
+    for (auto _: state) {
+        state.PauseTiming();
+        List l(input.begin(), input.end());
+        state.ResumeTiming();
+        l.sort();
+        benchmark::DoNotOptimize(&l.front());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCH_LIST(BM_ListSortInt, int);
+
+//sort of larger nodes by a comparator
+struct simple_less {
+    bool operator()(const Test_FOO_Simple& lhs, const Test_FOO_Simple& rhs) const {
+        return lhs.getIntMember() < rhs.getIntMember();
+    }
+};
+
+template <typename List>
+static void BM_ListSortSimple(benchmark::State& state) {
+    const std::vector<int> input = random_ints(state.range(0));
+    for (auto _: state) {
+        state.PauseTiming();
+        List l;
+        for (int x: input) {
+            l.push_back(Test_FOO_Simple(x));
+        }
+        state.ResumeTiming();
+        l.sort(simple_less());
+        benchmark::DoNotOptimize(&l.front());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCH_LIST(BM_ListSortSimple, Test_FOO_Simple);
+
+//sorted but for one in a hundred elements swapped, the runs are long
+static std::vector<int> mostly_sorted_ints(int n) {
+    std::vector<int> res(n);
+    srand(n);
+    for (int i = 0; i < n; ++i) {
+        res[i] = i;
+    }
+    for (int i = 0; i < n / 100; ++i) {
+        std::swap(res[rand() % n], res[rand() % n]);
+    }
+    return res;
+}
+
+template <typename List>
+static void BM_ListSortMostlySorted(benchmark::State& state) {
+    const std::vector<int> input = mostly_sorted_ints(state.range(0));
+    for (auto _: state) {
+        state.PauseTiming();
+        List l(input.begin(), input.end());
+        state.ResumeTiming();
+        l.sort();
+        benchmark::DoNotOptimize(&l.front());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCH_LIST(BM_ListSortMostlySorted, int);
+
+//the random ints again, sorted with one thread per core
+template <typename List>
+static void BM_ListParallelSortInt(benchmark::State& state) {
+    const std::vector<int> input = random_ints(state.range(0));
+    for (auto _: state) {
+        state.PauseTiming();
+        List l(input.begin(), input.end());
+        state.ResumeTiming();
+        my_stl::parallel_sort(l);
+        benchmark::DoNotOptimize(&l.front());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_ListParallelSortInt, my_stl::list<int>)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_ListParallelSortInt, pool_list<int>)->MY_STL_BENCH_SIZES;
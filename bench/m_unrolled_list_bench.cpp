@@ -0,0 +1,50 @@
+#include "../src/m_unrolled_list.h"
+#include "../src/m_vector.h"
+#include <benchmark/benchmark.h>
+#include <list>
+#include <vector>
+#include "bench_utils.h"
+
+
+//unrolled_list sits between list and vector, both are measured next to it
+#define BENCH_SEQUENCE(func, T)                                               \
+    BENCHMARK_TEMPLATE(func, my_stl::unrolled_list<T>)->MY_STL_BENCH_SIZES;   \
+    BENCHMARK_TEMPLATE(func, my_stl::list<T>)->MY_STL_BENCH_SIZES;            \
+    BENCHMARK_TEMPLATE(func, std::list<T>)->MY_STL_BENCH_SIZES;               \
+    BENCHMARK_TEMPLATE(func, my_stl::vector<T>)->MY_STL_BENCH_SIZES
+
+template <typename Sequence>
+static void BM_SequenceIterate(benchmark::State& state) {
+    const int n = state.range(0);
+    Sequence seq;
+    for (int i = 0; i < n; ++i) {
+        seq.push_back(i);
+    }
+    for (auto _: state) {
+        long sum = 0;
+        for (auto it = seq.begin(); it != seq.end(); ++it) {
+            sum += *it;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_SEQUENCE(BM_SequenceIterate, int);
+
+//insert in the middle, the position is found by walking from the front
+template <typename Sequence>
+static void BM_SequenceInsertMiddle(benchmark::State& state) {
+    const int n = state.range(0);
+    for (auto _: state) {
+        Sequence seq;
+        auto middle = seq.begin();
+        for (int i = 0; i < n; ++i) {
+            middle = seq.insert(middle, i);
+            //every other insert moves the position one to the back
+            if (i & 1)  ++middle;
+        }
+        benchmark::DoNotOptimize(&seq.front());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_SEQUENCE(BM_SequenceInsertMiddle, int);
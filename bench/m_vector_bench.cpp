@@ -0,0 +1,160 @@
+#include "../src/m_vector.h"
+#include "../src/m_small_vector.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "bench_utils.h"
+
+
+//every benchmark is registered twice, for my_stl::vector and std::vector of the same element
+//type, so the two show up next to each other in the output
+#define BENCH_VECTOR(func, T)                                                 \
+    BENCHMARK_TEMPLATE(func, my_stl::vector<T>)->MY_STL_BENCH_SIZES;          \
+    BENCHMARK_TEMPLATE(func, std::vector<T>)->MY_STL_BENCH_SIZES
+
+#define BENCH_VECTOR_ALL_TYPES(func)                                          \
+    BENCH_VECTOR(func, int);                                                  \
+    BENCH_VECTOR(func, Test_FOO_Simple);                                      \
+    BENCH_VECTOR(func, Test_FOO_Array);                                       \
+    BENCH_VECTOR(func, Test_FOO_Heap)
+
+//grow from empty by push_back, the cost is dominated by reallocation
+template <typename Vec>
+static void BM_VectorPushBack(benchmark::State& state) {
+    typedef typename Vec::value_type T;
+    const int n = state.range(0);
+    const T value = make_value<T>(1);
+    for (auto _: state) {
+        Vec v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(value);
+        }
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_VECTOR_ALL_TYPES(BM_VectorPushBack);
+//the same with the other growth policies, fewer reallocations or less slack
+BENCHMARK_TEMPLATE(BM_VectorPushBack, my_stl::vector<int, my_stl::__malloc_alloc<0>,
+        my_stl::one_and_half_growth<>>)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_VectorPushBack, my_stl::vector<int, my_stl::__malloc_alloc<0>,
+        my_stl::double_growth<16>>)->MY_STL_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_VectorPushBack, my_stl::vector<int, my_stl::__malloc_alloc<0>,
+        my_stl::size_class_growth<>>)->MY_STL_BENCH_SIZES;
+
+//the same with the storage reserved up front
+template <typename Vec>
+static void BM_VectorPushBackReserved(benchmark::State& state) {
+    typedef typename Vec::value_type T;
+    const int n = state.range(0);
+    const T value = make_value<T>(1);
+    for (auto _: state) {
+        Vec v;
+        v.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            v.push_back(value);
+        }
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_VECTOR_ALL_TYPES(BM_VectorPushBackReserved);
+
+//fill construction, goes through uninitialized_fill
+template <typename Vec>
+static void BM_VectorFillConstruct(benchmark::State& state) {
+    typedef typename Vec::value_type T;
+    const int n = state.range(0);
+    const T value = make_value<T>(7);
+    for (auto _: state) {
+        Vec v(n, value);
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_VECTOR_ALL_TYPES(BM_VectorFillConstruct);
+
+//copy construction, goes through uninitialized_copy
+template <typename Vec>
+static void BM_VectorCopy(benchmark::State& state) {
+    typedef typename Vec::value_type T;
+    const int n = state.range(0);
+    const Vec source(n, make_value<T>(3));
+    for (auto _: state) {
+        Vec v(source);
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_VECTOR_ALL_TYPES(BM_VectorCopy);
+
+//insert a block in the middle of a full vector, reallocates every time
+template <typename Vec>
+static void BM_VectorInsertMiddle(benchmark::State& state) {
+    typedef typename Vec::value_type T;
+    const int n = state.range(0);
+    const T value = make_value<T>(5);
+    for (auto _: state) {
+        state.PauseTiming();
+        Vec v(n, value);
+        state.ResumeTiming();
+        v.insert(v.begin() + n / 2, n / 4 + 1, value);
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_VECTOR(BM_VectorInsertMiddle, int);
+BENCH_VECTOR(BM_VectorInsertMiddle, Test_FOO_Heap);
+
+//batch ingestion: n elements from an array, in the middle and at the end of a vector of n
+template <typename Vec>
+static void BM_VectorRangeInsert(benchmark::State& state) {
+    typedef typename Vec::value_type T;
+    const int n = state.range(0);
+    std::vector<T> batch(n, make_value<T>(1));
+    for (auto _: state) {
+        Vec v(n, make_value<T>(2));
+        v.insert(v.begin() + n / 2, batch.data(), batch.data() + n);
+        v.insert(v.end(), batch.data(), batch.data() + n);
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * n);
+}
+BENCH_VECTOR_ALL_TYPES(BM_VectorRangeInsert);
+
+//y[i] += a * x[i] through operator[], the loop vectorizes only if the access is unchecked
+template <typename Vec>
+static void BM_VectorIndexAxpy(benchmark::State& state) {
+    const size_t n = state.range(0);
+    Vec x(n, 1.5), y(n, 0.5);
+    const double a = 3.0;
+    for (auto _: state) {
+        for (size_t i = 0; i < n; ++i) {
+            y[i] += a * x[i];
+        }
+        benchmark::DoNotOptimize(&y[0]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCH_VECTOR(BM_VectorIndexAxpy, double);
+
+//many short vectors, the case small_vector is for: up to 8 elements there is no allocation
+template <typename Vec>
+static void BM_VectorShortLived(benchmark::State& state) {
+    typedef typename Vec::value_type T;
+    const int n = state.range(0);
+    const T value = make_value<T>(1);
+    for (auto _: state) {
+        Vec v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(value);
+        }
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_VectorShortLived, my_stl::small_vector<int, 8>)->DenseRange(1, 9, 4)->Arg(32);
+BENCHMARK_TEMPLATE(BM_VectorShortLived, my_stl::vector<int>)->DenseRange(1, 9, 4)->Arg(32);
+BENCHMARK_TEMPLATE(BM_VectorShortLived, std::vector<int>)->DenseRange(1, 9, 4)->Arg(32);
+BENCHMARK_TEMPLATE(BM_VectorShortLived, my_stl::small_vector<Test_FOO_Heap, 8>)->DenseRange(1, 9, 4)->Arg(32);
+BENCHMARK_TEMPLATE(BM_VectorShortLived, my_stl::vector<Test_FOO_Heap>)->DenseRange(1, 9, 4)->Arg(32);
@@ -6,10 +6,17 @@
 #define __MY_STL_ALGOBASE_H
 
 #include "m_type_traits.h"
-#include <string.h>    //for memmove
+#include <string.h>    //for memmove, memset
 #include <cstddef>    //for ptrdiff_t  size_t
+#include <utility>    //for std::move
 #include "m_iterator.h"
 
+//the vectorized fill uses SSE2 (always there on x86-64) and AVX2 when the cpu has it
+#if defined(__x86_64__) && defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define __MY_STL_SIMD_FILL
+#include <immintrin.h>
+#endif
+
 
 namespace my_stl {
     //copy function, optimized in the following way
@@ -63,7 +70,7 @@ namespace my_stl {
     struct __copy_dispatch {
         OutputIterator operator()(InputIterator first, InputIterator last, OutputIterator result) {
             return __copy(first, last, result, 
-                    typename iterator_traits<InputIterator>::iterator_categoty());
+                    typename iterator_traits<InputIterator>::iterator_category());
         }
     };
 
@@ -92,7 +99,7 @@ namespace my_stl {
     template<typename InputIterator, typename OutputIterator>
     inline OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result, 
             input_iterator_tag) {
-        for (; first != last; ++first, ++last) {
+        for (; first != last; ++first, ++result) {
             *result = *first;
         }
         return result;
@@ -113,8 +120,8 @@ namespace my_stl {
     template<typename _TYPE> 
     inline _TYPE* __copy_t(_TYPE* first, _TYPE* last, _TYPE* result, __true_type) {
         //so the pointer is pointing to the type with trivial operator=
-        //we only need to call memmove()
-        memmove(result, first, sizeof(_TYPE) * (last - first));
+        //we only need to call memmove(), an empty range may be two null pointers
+        if (last != first)  memmove((void*)result, (const void*)first, sizeof(_TYPE) * (last - first));
         return result + (last - first);
     }
 
@@ -131,8 +138,8 @@ namespace my_stl {
     template<typename _TYPE> 
     inline _TYPE* __copy_t(const _TYPE* first, const _TYPE* last, _TYPE* result, __true_type) {
         //so the pointer is pointing to the type with trivial operator=
-        //we only need to call memmove()
-        memmove(result, first, sizeof(_TYPE) * (last - first));
+        //we only need to call memmove(), an empty range may be two null pointers
+        if (last != first)  memmove((void*)result, (const void*)first, sizeof(_TYPE) * (last - first));
         return result + (last - first);
     }
 
@@ -167,7 +174,7 @@ namespace my_stl {
     struct __copy_backward_dispatch {
         _BI2 operator()(_BI1 first, _BI1 last, _BI2 result) {
             return __copy_backward(first, last, result, 
-                    typename iterator_traits<_BI1>::iterator_categoty());
+                    typename iterator_traits<_BI1>::iterator_category());
         }
     };
 
@@ -196,7 +203,7 @@ namespace my_stl {
         //so the pointer is pointing to the type with trivial operator=
         //we only need to call memmove()
         ptrdiff_t distance = last - first;
-        memmove(result - distance, first,  sizeof(_TYPE) * distance);
+        memmove((void*)(result - distance), (const void*)first, sizeof(_TYPE) * distance);
         return result - distance;
     }
 
@@ -215,7 +222,7 @@ namespace my_stl {
         //so the pointer is pointing to the type with trivial operator=
         //we only need to call memmove()
         ptrdiff_t distance = last - first;
-        memmove(result - distance, first,  sizeof(_TYPE) * distance);
+        memmove((void*)(result - distance), (const void*)first, sizeof(_TYPE) * distance);
         return result - distance;
     }
 
@@ -236,7 +243,7 @@ namespace my_stl {
     inline _BI2 __copy_backward(_BI1 first, _BI1 last, _BI2 result, 
             bidirectional_iterator_tag) {
         while (first != last) {
-            --result = --last;
+            *--result = *--last;
         }
         return result;
     }
@@ -259,12 +266,223 @@ namespace my_stl {
         return __copy_backward_dispatch<_BI1, _BI2>()(first, last, result);
     }
 
+    //-----------------------------------------------------------------------------------
+    //************************* move and move_backward *********************************
+    //__________________________________________________________________________________
+    //same as copy and copy_backward, but the elements are moved with std::move, for types
+    //with trivial operator= moving is copying, so they go straight to copy (memmove)
+    template<typename InputIterator, typename OutputIterator>
+    inline OutputIterator __move(InputIterator first, InputIterator last, OutputIterator result,
+            __true_type) {
+        return my_stl::copy(first, last, result);
+    }
+
+    template<typename InputIterator, typename OutputIterator>
+    inline OutputIterator __move(InputIterator first, InputIterator last, OutputIterator result,
+            __false_type) {
+        for (; first != last; ++first, ++result) {
+            *result = std::move(*first);
+        }
+        return result;
+    }
+
+    template<typename InputIterator, typename OutputIterator>
+    inline OutputIterator move(InputIterator first, InputIterator last, OutputIterator result) {
+        typedef typename iterator_traits<InputIterator>::value_type _value_type;
+        return __move(first, last, result,
+                typename __type_traits<_value_type>::has_trivial_assignment_operator());
+    }
+
+    template<typename _BI1, typename _BI2>
+    inline _BI2 __move_backward(_BI1 first, _BI1 last, _BI2 result, __true_type) {
+        return my_stl::copy_backward(first, last, result);
+    }
+
+    template<typename _BI1, typename _BI2>
+    inline _BI2 __move_backward(_BI1 first, _BI1 last, _BI2 result, __false_type) {
+        while (first != last) {
+            *--result = std::move(*--last);
+        }
+        return result;
+    }
+
+    template<typename _BI1, typename _BI2>
+    inline _BI2 move_backward(_BI1 first, _BI1 last, _BI2 result) {
+        typedef typename iterator_traits<_BI1>::value_type _value_type;
+        return __move_backward(first, last, result,
+                typename __type_traits<_value_type>::has_trivial_assignment_operator());
+    }
+
+    //-----------------------------------------------------------------------------------
+    //****************************** fill and fill_n ***********************************
+    //__________________________________________________________________________________
+    //fill is optimized in the following way
+    //1. for T* of trivially copyable type, the objects are just copies of the bytes of val
+    //      I. 1 byte or all-zero value, use memset()
+    //      II. 2, 4, 8 bytes, broadcast val into a vector register and store it with AVX2 or
+    //          SSE2, the cpu is checked once at runtime
+    //      III. other sizes, double the filled prefix by memcpy()
+    //2. all the other iterators and types, *first = val one by one
+#ifdef __MY_STL_SIMD_FILL
+    //store the 16 bytes pattern over [p, p + bytes), bytes has to be a multiple of the
+    //period of the pattern
+    inline void __fill_pattern_sse2(char* p, size_t bytes, __m128i pattern) {
+        for (; bytes >= 64; bytes -= 64, p += 64) {
+            _mm_storeu_si128((__m128i*)p, pattern);
+            _mm_storeu_si128((__m128i*)(p + 16), pattern);
+            _mm_storeu_si128((__m128i*)(p + 32), pattern);
+            _mm_storeu_si128((__m128i*)(p + 48), pattern);
+        }
+        for (; bytes >= 16; bytes -= 16, p += 16) {
+            _mm_storeu_si128((__m128i*)p, pattern);
+        }
+        if (bytes) {
+            alignas(16) char tail[16];
+            _mm_store_si128((__m128i*)tail, pattern);
+            memcpy(p, tail, bytes);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    inline void __fill_pattern_avx2(char* p, size_t bytes, __m128i pattern) {
+        __m256i wide = _mm256_broadcastsi128_si256(pattern);
+        for (; bytes >= 128; bytes -= 128, p += 128) {
+            _mm256_storeu_si256((__m256i*)p, wide);
+            _mm256_storeu_si256((__m256i*)(p + 32), wide);
+            _mm256_storeu_si256((__m256i*)(p + 64), wide);
+            _mm256_storeu_si256((__m256i*)(p + 96), wide);
+        }
+        for (; bytes >= 32; bytes -= 32, p += 32) {
+            _mm256_storeu_si256((__m256i*)p, wide);
+        }
+        __fill_pattern_sse2(p, bytes, pattern);
+    }
+
+    inline bool __cpu_has_avx2() noexcept {
+        static const bool has_avx2 = __builtin_cpu_supports("avx2");
+        return has_avx2;
+    }
+#endif
+
+    //fill n objects of size 2, 4 or 8 at first with the bytes of *val
+    inline void __fill_broadcast(void* first, size_t n, const void* val, size_t size) {
+        char* p = (char*)first;
+#ifdef __MY_STL_SIMD_FILL
+        alignas(16) char buf[16];
+        for (size_t i = 0; i < 16; i += size) {
+            memcpy(buf + i, val, size);
+        }
+        __m128i pattern = _mm_load_si128((const __m128i*)buf);
+        if (__cpu_has_avx2()) {
+            __fill_pattern_avx2(p, n * size, pattern);
+        }
+        else {
+            __fill_pattern_sse2(p, n * size, pattern);
+        }
+#else
+        for (; n > 0; --n, p += size) {
+            memcpy(p, val, size);
+        }
+#endif
+    }
+
+    //whether every byte of the object is zero, such a value can be filled by memset(0)
+    template <typename _Tp>
+    inline bool __is_zero_bits(const _Tp& value) noexcept {
+        const unsigned char* p = (const unsigned char*)&value;
+        for (size_t i = 0; i < sizeof(_Tp); ++i) {
+            if (p[i])   return false;
+        }
+        return true;
+    }
+
+    //fill [first, first + n) with val, for types which can be copied by bytes. It works on raw
+    //memory as well, uninitialized_fill uses it
+    template <typename _Tp>
+    _Tp* __fill_trivial(_Tp* first, size_t n, const _Tp& val) {
+        //a short range is not worth the setup, and the compiler can unroll the loop
+        if (n * sizeof(_Tp) < 64) {
+            const _Tp v = val;
+            for (size_t i = 0; i < n; ++i) {
+                first[i] = v;
+            }
+        }
+        else if (sizeof(_Tp) == 1 || __is_zero_bits(val)) {
+            unsigned char byte;
+            memcpy(&byte, &val, 1);
+            memset((void*)first, byte, n * sizeof(_Tp));
+        }
+        else if (sizeof(_Tp) == 2 || sizeof(_Tp) == 4 || sizeof(_Tp) == 8) {
+            __fill_broadcast((void*)first, n, (const void*)&val, sizeof(_Tp));
+        }
+        else {
+            //val may be in the range, take it before we overwrite the first one
+            const _Tp v = val;
+            memcpy((void*)first, (const void*)&v, sizeof(_Tp));
+            size_t filled = 1;
+            while (filled < n) {
+                size_t count = filled < n - filled ? filled : n - filled;
+                memcpy((void*)(first + filled), (const void*)first, count * sizeof(_Tp));
+                filled += count;
+            }
+        }
+        return first + n;
+    }
+
     template <typename ForwardIterator, typename TYPE>
-    void fill(ForwardIterator first, ForwardIterator last, const TYPE& val) {
+    void __fill(ForwardIterator first, ForwardIterator last, const TYPE& val) {
         while (first != last) {
             *first = val;
             ++first;
         }
     }
+
+    template <typename _Tp>
+    inline void __fill(_Tp* first, _Tp* last, const _Tp& val, __true_type) {
+        __fill_trivial(first, last - first, val);
+    }
+
+    template <typename _Tp>
+    inline void __fill(_Tp* first, _Tp* last, const _Tp& val, __false_type) {
+        __fill(first, last, val);
+    }
+
+    template <typename ForwardIterator, typename TYPE>
+    inline void fill(ForwardIterator first, ForwardIterator last, const TYPE& val) {
+        __fill(first, last, val);
+    }
+
+    template <typename _Tp>
+    inline void fill(_Tp* first, _Tp* last, const _Tp& val) {
+        __fill(first, last, val, typename is_trivially_copyable<_Tp>::type());
+    }
+
+    template <typename OutputIterator, typename Size, typename TYPE>
+    OutputIterator __fill_n(OutputIterator first, Size n, const TYPE& val) {
+        for (; n > 0; --n, ++first) {
+            *first = val;
+        }
+        return first;
+    }
+
+    template <typename _Tp, typename Size>
+    inline _Tp* __fill_n(_Tp* first, Size n, const _Tp& val, __true_type) {
+        return n > 0 ? __fill_trivial(first, n, val) : first;
+    }
+
+    template <typename _Tp, typename Size>
+    inline _Tp* __fill_n(_Tp* first, Size n, const _Tp& val, __false_type) {
+        return __fill_n(first, n, val);
+    }
+
+    template <typename OutputIterator, typename Size, typename TYPE>
+    inline OutputIterator fill_n(OutputIterator first, Size n, const TYPE& val) {
+        return __fill_n(first, n, val);
+    }
+
+    template <typename _Tp, typename Size>
+    inline _Tp* fill_n(_Tp* first, Size n, const _Tp& val) {
+        return __fill_n(first, n, val, typename is_trivially_copyable<_Tp>::type());
+    }
 }
 #endif
@@ -2,6 +2,907 @@
 #define __M_STL_ALGORITHM_H
 
 #include "m_functional.h"
+#include "m_algobase.h"
+#include "m_iterator.h"
+#include "m_type_traits.h"
+#include "m_alloc.h"          //for the buffers of stable_sort and radix_sort
+#include "m_construct.h"      //for destroy
+#include <cstddef>            //for size_t
+#include <string.h>           //for memcpy, memset
+#include <new>                //for std::bad_alloc
+#include <utility>            //for std::move, std::swap, std::pair
 
-#endif
+namespace my_stl {
+    //-----------------------------------------------------------------------
+    //-----------------------------helpers-----------------------------------
+    //-----------------------------------------------------------------------
+    template <typename _Iter1, typename _Iter2>
+    inline void __iter_swap(_Iter1 a, _Iter2 b) {
+        using std::swap;
+        swap(*a, *b);
+    }
+
+    //floor(log2(n)), n > 0
+    template <typename _Size>
+    inline int __lg(_Size n) {
+        int k = 0;
+        for (; n > 1; n >>= 1) ++k;
+        return k;
+    }
+
+    template <typename _BidirectionalIter>
+    inline void __reverse(_BidirectionalIter first, _BidirectionalIter last) {
+        for (; first != last && first != --last; ++first) {
+            my_stl::__iter_swap(first, last);
+        }
+    }
+
+    //swap [first, middle) and [middle, last) by three reversals
+    template <typename _RandomIter>
+    inline _RandomIter __rotate(_RandomIter first, _RandomIter middle, _RandomIter last) {
+        my_stl::__reverse(first, middle);
+        my_stl::__reverse(middle, last);
+        my_stl::__reverse(first, last);
+        return first + (last - middle);
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------for_each and transform--------------------
+    //-----------------------------------------------------------------------
+    template <typename _InputIter, typename _Function>
+    inline _Function for_each(_InputIter first, _InputIter last, _Function fn) {
+        for (; first != last; ++first) {
+            fn(*first);
+        }
+        return fn;
+    }
+
+    template <typename _InputIter, typename _OutputIter, typename _UnaryOp>
+    inline _OutputIter transform(_InputIter first, _InputIter last, _OutputIter result, _UnaryOp op) {
+        for (; first != last; ++first, ++result) {
+            *result = op(*first);
+        }
+        return result;
+    }
+
+    template <typename _InputIter1, typename _InputIter2, typename _OutputIter, typename _BinaryOp>
+    inline _OutputIter transform(_InputIter1 first1, _InputIter1 last1, _InputIter2 first2,
+            _OutputIter result, _BinaryOp op) {
+        for (; first1 != last1; ++first1, ++first2, ++result) {
+            *result = op(*first1, *first2);
+        }
+        return result;
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------heap--------------------------------------
+    //-----------------------------------------------------------------------
+    //the max heap (by comp) of the sgi implementation, used by partial_sort and as the
+    //fallback of sort. hole is where value goes, it sinks to a leaf and then comes up again
+    template <typename _RandomIter, typename _Distance, typename _Tp, typename _Comp>
+    void __adjust_heap(_RandomIter first, _Distance hole, _Distance len, _Tp value, _Comp& comp) {
+        const _Distance top = hole;
+        _Distance child = 2 * hole + 2;
+        for (; child < len; child = 2 * child + 2) {
+            if (comp(*(first + child), *(first + (child - 1)))) --child;
+            *(first + hole) = std::move(*(first + child));
+            hole = child;
+        }
+        if (child == len) {
+            *(first + hole) = std::move(*(first + (child - 1)));
+            hole = child - 1;
+        }
+        //push it up again
+        for (_Distance parent = (hole - 1) / 2; hole > top && comp(*(first + parent), value);
+                parent = (hole - 1) / 2) {
+            *(first + hole) = std::move(*(first + parent));
+            hole = parent;
+        }
+        *(first + hole) = std::move(value);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    void __make_heap(_RandomIter first, _RandomIter last, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::difference_type _Distance;
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        const _Distance len = last - first;
+        if (len < 2)    return;
+        for (_Distance parent = (len - 2) / 2; ; --parent) {
+            _Tp value(std::move(*(first + parent)));
+            my_stl::__adjust_heap(first, parent, len, std::move(value), comp);
+            if (parent == 0)    return;
+        }
+    }
+
+    //put the top of the heap [first, last) at result and value, which was at result, into the heap
+    template <typename _RandomIter, typename _Comp>
+    inline void __pop_heap(_RandomIter first, _RandomIter last, _RandomIter result, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::difference_type _Distance;
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        _Tp value(std::move(*result));
+        *result = std::move(*first);
+        my_stl::__adjust_heap(first, _Distance(0), _Distance(last - first), std::move(value), comp);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    void __sort_heap(_RandomIter first, _RandomIter last, _Comp& comp) {
+        for (; last - first > 1; --last) {
+            my_stl::__pop_heap(first, last - 1, last - 1, comp);
+        }
+    }
+
+    //leave the middle - first smallest elements in [first, middle) as a heap
+    template <typename _RandomIter, typename _Comp>
+    void __heap_select(_RandomIter first, _RandomIter middle, _RandomIter last, _Comp& comp) {
+        my_stl::__make_heap(first, middle, comp);
+        for (_RandomIter i = middle; i < last; ++i) {
+            if (comp(*i, *first))   my_stl::__pop_heap(first, middle, i, comp);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------sort--------------------------------------
+    //-----------------------------------------------------------------------
+    //pattern-defeating quicksort (Orson Peters): an introsort whose pivot is a median of 3
+    //(a median of 3 medians for the large ranges). It notices the patterns that usually hurt:
+    //  a partition without any swap tries a bounded insertion sort, so sorted runs are O(n);
+    //  a pivot equal to the one before (the element left of the range) puts all its equal
+    //  elements on the left in one go, so many duplicates are O(n log k);
+    //  an unbalanced partition shuffles a few elements, and after log(n) of them the range
+    //  is heap sorted, so the worst case stays O(n log n).
+    //small ranges are insertion sorted. For arithmetic types compared with less or greater
+    //the partition is the branchless block partition of BlockQuicksort
+    enum {
+        __insertion_sort_threshold = 24,
+        __ninther_threshold = 128,
+        __partial_insertion_sort_limit = 8,
+        __partition_block_size = 64,
+        __partition_cacheline_size = 64
+    };
+
+    template <typename _Tp, typename _Comp>
+    struct __is_branchless_comp: false_type {};
+
+    template <typename _Tp>
+    struct __is_branchless_comp<_Tp, less<_Tp>>: integral_constant<bool, is_arithmetic<_Tp>::value> {};
+
+    template <typename _Tp>
+    struct __is_branchless_comp<_Tp, greater<_Tp>>: integral_constant<bool, is_arithmetic<_Tp>::value> {};
+
+    template <typename _RandomIter, typename _Comp>
+    void __insertion_sort(_RandomIter first, _RandomIter last, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        if (first == last)  return;
+        for (_RandomIter cur = first + 1; cur != last; ++cur) {
+            _RandomIter sift = cur;
+            _RandomIter sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)) {
+                _Tp tmp(std::move(*sift));
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (sift != first && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    //an element not greater than all of [first, last) sits right before first
+    template <typename _RandomIter, typename _Comp>
+    void __unguarded_insertion_sort(_RandomIter first, _RandomIter last, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        if (first == last)  return;
+        for (_RandomIter cur = first + 1; cur != last; ++cur) {
+            _RandomIter sift = cur;
+            _RandomIter sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)) {
+                _Tp tmp(std::move(*sift));
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    //the insertion sort that gives up (false) once it has moved too many elements, the
+    //elements before first are not greater than any of the range
+    template <typename _RandomIter, typename _Comp>
+    bool __partial_insertion_sort(_RandomIter first, _RandomIter last, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        if (first == last)  return true;
+        size_t limit = 0;
+        for (_RandomIter cur = first + 1; cur != last; ++cur) {
+            _RandomIter sift = cur;
+            _RandomIter sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)) {
+                _Tp tmp(std::move(*sift));
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (sift != first && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+                limit += cur - sift;
+            }
+            if (limit > __partial_insertion_sort_limit) return false;
+        }
+        return true;
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline void __sort2(_RandomIter a, _RandomIter b, _Comp& comp) {
+        if (comp(*b, *a))   my_stl::__iter_swap(a, b);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline void __sort3(_RandomIter a, _RandomIter b, _RandomIter c, _Comp& comp) {
+        my_stl::__sort2(a, b, comp);
+        my_stl::__sort2(b, c, comp);
+        my_stl::__sort2(a, b, comp);
+    }
+
+    //partition [first, last) around the pivot *first: the elements less than it go left,
+    //the rest right. There is an element not less than the pivot in the range, and unless
+    //the range is leftmost one not greater than it before first, so the scans need no bound.
+    //Returns where the pivot ends up and whether nothing had to be swapped
+    template <typename _RandomIter, typename _Comp>
+    std::pair<_RandomIter, bool> __partition_right(_RandomIter first, _RandomIter last, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        _RandomIter begin = first;
+        _Tp pivot(std::move(*first));
+        while (comp(*++first, pivot));
+        //nothing smaller than the pivot to stop the scan from the right
+        if (first - 1 == begin) {
+            while (first < last && !comp(*--last, pivot));
+        }
+        else {
+            while (!comp(*--last, pivot));
+        }
+        const bool already_partitioned = first >= last;
+        while (first < last) {
+            my_stl::__iter_swap(first, last);
+            while (comp(*++first, pivot));
+            while (!comp(*--last, pivot));
+        }
+        _RandomIter pivot_pos = first - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return std::pair<_RandomIter, bool>(pivot_pos, already_partitioned);
+    }
+
+    //swap the misplaced elements found by the block partition, with a cyclic permutation
+    //when the two counts differ (it is the same set of moves either way)
+    template <typename _RandomIter>
+    inline void __swap_offsets(_RandomIter first, _RandomIter last, unsigned char* offsets_l,
+            unsigned char* offsets_r, size_t num, bool use_swaps) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        if (use_swaps) {
+            for (size_t i = 0; i < num; ++i) {
+                my_stl::__iter_swap(first + offsets_l[i], last - offsets_r[i]);
+            }
+        }
+        else if (num > 0) {
+            _RandomIter l = first + offsets_l[0];
+            _RandomIter r = last - offsets_r[0];
+            _Tp tmp(std::move(*l));
+            *l = std::move(*r);
+            for (size_t i = 1; i < num; ++i) {
+                l = first + offsets_l[i];
+                *r = std::move(*l);
+                r = last - offsets_r[i];
+                *l = std::move(*r);
+            }
+            *r = std::move(tmp);
+        }
+    }
+
+    //__partition_right for the cheap comparisons: a block of elements from each side is
+    //compared first, writing the offsets of the misplaced ones without a branch, then the
+    //misplaced ones are swapped
+    template <typename _RandomIter, typename _Comp>
+    std::pair<_RandomIter, bool> __partition_right_branchless(_RandomIter first, _RandomIter last,
+            _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        _RandomIter begin = first;
+        _Tp pivot(std::move(*first));
+        while (comp(*++first, pivot));
+        if (first - 1 == begin) {
+            while (first < last && !comp(*--last, pivot));
+        }
+        else {
+            while (!comp(*--last, pivot));
+        }
+        const bool already_partitioned = first >= last;
+        if (!already_partitioned) {
+            my_stl::__iter_swap(first, last);
+            ++first;
+            alignas(__partition_cacheline_size) unsigned char offsets_l[__partition_block_size];
+            alignas(__partition_cacheline_size) unsigned char offsets_r[__partition_block_size];
+            _RandomIter offsets_l_base = first;
+            _RandomIter offsets_r_base = last;
+            size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+            while (first < last) {
+                //how many of the unknown elements each side takes this round
+                const size_t num_unknown = last - first;
+                const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+                if (left_split >= __partition_block_size) {
+                    for (size_t i = 0; i < __partition_block_size; ) {
+                        for (int k = 0; k < 8; ++k) {
+                            offsets_l[num_l] = i++;
+                            num_l += !comp(*first, pivot);
+                            ++first;
+                        }
+                    }
+                }
+                else {
+                    for (size_t i = 0; i < left_split; ) {
+                        offsets_l[num_l] = i++;
+                        num_l += !comp(*first, pivot);
+                        ++first;
+                    }
+                }
+                if (right_split >= __partition_block_size) {
+                    for (size_t i = 0; i < __partition_block_size; ) {
+                        for (int k = 0; k < 8; ++k) {
+                            offsets_r[num_r] = ++i;
+                            num_r += comp(*--last, pivot);
+                        }
+                    }
+                }
+                else {
+                    for (size_t i = 0; i < right_split; ) {
+                        offsets_r[num_r] = ++i;
+                        num_r += comp(*--last, pivot);
+                    }
+                }
+                const size_t num = num_l < num_r ? num_l : num_r;
+                my_stl::__swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l,
+                        offsets_r + start_r, num, num_l == num_r);
+                num_l -= num;
+                num_r -= num;
+                start_l += num;
+                start_r += num;
+                if (num_l == 0) {
+                    start_l = 0;
+                    offsets_l_base = first;
+                }
+                if (num_r == 0) {
+                    start_r = 0;
+                    offsets_r_base = last;
+                }
+            }
+            //one side still has misplaced elements, move them to the middle
+            if (num_l) {
+                while (num_l--) my_stl::__iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+                first = last;
+            }
+            if (num_r) {
+                while (num_r--) {
+                    my_stl::__iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                    ++first;
+                }
+                last = first;
+            }
+        }
+        _RandomIter pivot_pos = first - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return std::pair<_RandomIter, bool>(pivot_pos, already_partitioned);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline std::pair<_RandomIter, bool> __partition_right(_RandomIter first, _RandomIter last,
+            _Comp& comp, __true_type) {
+        return my_stl::__partition_right_branchless(first, last, comp);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline std::pair<_RandomIter, bool> __partition_right(_RandomIter first, _RandomIter last,
+            _Comp& comp, __false_type) {
+        return my_stl::__partition_right(first, last, comp);
+    }
+
+    //the pivot *first equals the element before first, so no element of the range is less
+    //than it: put the equal ones left, they are done
+    template <typename _RandomIter, typename _Comp>
+    _RandomIter __partition_left(_RandomIter first, _RandomIter last, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        _RandomIter begin = first, end = last;
+        _Tp pivot(std::move(*first));
+        while (comp(pivot, *--last));
+        //nothing greater than the pivot to stop the scan from the left
+        if (last + 1 == end) {
+            while (first < last && !comp(pivot, *++first));
+        }
+        else {
+            while (!comp(pivot, *++first));
+        }
+        while (first < last) {
+            my_stl::__iter_swap(first, last);
+            while (comp(pivot, *--last));
+            while (!comp(pivot, *++first));
+        }
+        *begin = std::move(*last);
+        *last = std::move(pivot);
+        return last;
+    }
+
+    template <typename _RandomIter, typename _Comp, typename _Branchless>
+    void __pdqsort_loop(_RandomIter first, _RandomIter last, _Comp& comp, int bad_allowed,
+            bool leftmost, _Branchless __branchless) {
+        typedef typename iterator_traits<_RandomIter>::difference_type _Distance;
+        while (true) {
+            const _Distance size = last - first;
+            if (size < __insertion_sort_threshold) {
+                if (leftmost)   my_stl::__insertion_sort(first, last, comp);
+                else    my_stl::__unguarded_insertion_sort(first, last, comp);
+                return;
+            }
+            //the pivot goes to first
+            const _Distance s2 = size / 2;
+            if (size > __ninther_threshold) {
+                my_stl::__sort3(first, first + s2, last - 1, comp);
+                my_stl::__sort3(first + 1, first + (s2 - 1), last - 2, comp);
+                my_stl::__sort3(first + 2, first + (s2 + 1), last - 3, comp);
+                my_stl::__sort3(first + (s2 - 1), first + s2, first + (s2 + 1), comp);
+                my_stl::__iter_swap(first, first + s2);
+            }
+            else {
+                my_stl::__sort3(first + s2, first, last - 1, comp);
+            }
+            //the pivot equals the one of the partition before, whose right part this is
+            if (!leftmost && !comp(*(first - 1), *first)) {
+                first = my_stl::__partition_left(first, last, comp) + 1;
+                continue;
+            }
+            std::pair<_RandomIter, bool> part = my_stl::__partition_right(first, last, comp, __branchless);
+            _RandomIter pivot_pos = part.first;
+            const _Distance l_size = pivot_pos - first;
+            const _Distance r_size = last - (pivot_pos + 1);
+            if (l_size < size / 8 || r_size < size / 8) {
+                if (--bad_allowed == 0) {
+                    my_stl::__make_heap(first, last, comp);
+                    my_stl::__sort_heap(first, last, comp);
+                    return;
+                }
+                //break the pattern that gave the bad pivot
+                if (l_size >= __insertion_sort_threshold) {
+                    my_stl::__iter_swap(first, first + l_size / 4);
+                    my_stl::__iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                    if (l_size > __ninther_threshold) {
+                        my_stl::__iter_swap(first + 1, first + (l_size / 4 + 1));
+                        my_stl::__iter_swap(first + 2, first + (l_size / 4 + 2));
+                        my_stl::__iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                        my_stl::__iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                    }
+                }
+                if (r_size >= __insertion_sort_threshold) {
+                    my_stl::__iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                    my_stl::__iter_swap(last - 1, last - r_size / 4);
+                    if (r_size > __ninther_threshold) {
+                        my_stl::__iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                        my_stl::__iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                        my_stl::__iter_swap(last - 2, last - (1 + r_size / 4));
+                        my_stl::__iter_swap(last - 3, last - (2 + r_size / 4));
+                    }
+                }
+            }
+            else if (part.second && my_stl::__partial_insertion_sort(first, pivot_pos, comp) &&
+                    my_stl::__partial_insertion_sort(pivot_pos + 1, last, comp)) {
+                //nothing was swapped and both sides were (nearly) sorted already
+                return;
+            }
+            //recurse into the left part, loop on the right one
+            my_stl::__pdqsort_loop(first, pivot_pos, comp, bad_allowed, leftmost, __branchless);
+            first = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline void __sort(_RandomIter first, _RandomIter last, _Comp& comp, random_access_iterator_tag) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        if (last - first < 2)   return;
+        my_stl::__pdqsort_loop(first, last, comp, my_stl::__lg(last - first), true,
+                typename __is_branchless_comp<_Tp, _Comp>::type());
+    }
+
+    //sort [first, last) by comp, not stable
+    template <typename _RandomIter, typename _Comp>
+    inline void sort(_RandomIter first, _RandomIter last, _Comp comp) {
+        my_stl::__sort(first, last, comp, typename iterator_traits<_RandomIter>::iterator_category());
+    }
 
+    template <typename _RandomIter>
+    inline void sort(_RandomIter first, _RandomIter last) {
+        my_stl::sort(first, last, less<typename iterator_traits<_RandomIter>::value_type>());
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------stable sort-------------------------------
+    //-----------------------------------------------------------------------
+    //the scratch memory of the sorts, as the sgi _Temporary_buffer: len elements from alloc,
+    //built by moving *seed along the buffer and back, so _Tp needs no default constructor.
+    //If there is no memory for them begin() is null
+    template <typename _Tp>
+    class __temporary_buffer {
+        private:
+            typedef my_simple_alloc<_Tp, alloc> _Buf_alloc;
+            _Tp* __buf;
+            size_t __len;
+
+        public:
+            template <typename _Iter>
+            __temporary_buffer(_Iter seed, size_t len): __buf(nullptr), __len(0) {
+                try {
+                    __buf = _Buf_alloc::allocate(len);
+                }
+                catch (const std::bad_alloc&) {
+                    return;
+                }
+                size_t built = 0;
+                try {
+                    for (; built < len; ++built) {
+                        new (__buf + built) _Tp(std::move(built ? __buf[built - 1] : *seed));
+                    }
+                    *seed = std::move(__buf[len - 1]);
+                }
+                catch (...) {
+                    destroy(__buf, __buf + built);
+                    _Buf_alloc::deallocate(__buf, len);
+                    throw;
+                }
+                __len = len;
+            }
+
+            __temporary_buffer(const __temporary_buffer&) = delete;
+            __temporary_buffer& operator=(const __temporary_buffer&) = delete;
+
+            ~__temporary_buffer() {
+                if (__buf) {
+                    destroy(__buf, __buf + __len);
+                    _Buf_alloc::deallocate(__buf, __len);
+                }
+            }
+
+            _Tp* begin() const {return __buf;}
+            size_t size() const {return __len;}
+    };
+
+    //a top down merge sort: runs of __stable_sort_chunk are insertion sorted, and only the
+    //left half of a merge goes to the buffer, so it takes (n + 1) / 2 elements. Halves
+    //already in order are not merged. Without the memory for the buffer the merges are
+    //done in place by rotations, O(n log^2 n)
+    enum {__stable_sort_chunk = 16};
+
+    //merge [first, middle) (moved to buf) and [middle, last) into [first, last)
+    template <typename _RandomIter, typename _Tp, typename _Comp>
+    void __merge_with_buffer(_RandomIter first, _RandomIter middle, _RandomIter last,
+            _Tp* buf, _Comp& comp) {
+        _Tp* buf_last = buf;
+        for (_RandomIter i = first; i != middle; ++i, ++buf_last) {
+            *buf_last = std::move(*i);
+        }
+        _RandomIter out = first;
+        while (buf != buf_last && middle != last) {
+            //the left one wins the ties, to be stable
+            if (comp(*middle, *buf)) {
+                *out = std::move(*middle);
+                ++middle;
+            }
+            else {
+                *out = std::move(*buf);
+                ++buf;
+            }
+            ++out;
+        }
+        for (; buf != buf_last; ++buf, ++out) {
+            *out = std::move(*buf);
+        }
+    }
+
+    template <typename _RandomIter, typename _Tp, typename _Comp>
+    void __stable_sort_with_buffer(_RandomIter first, _RandomIter last, _Tp* buf, _Comp& comp) {
+        if (last - first <= __stable_sort_chunk) {
+            my_stl::__insertion_sort(first, last, comp);
+            return;
+        }
+        _RandomIter middle = first + (last - first) / 2;
+        my_stl::__stable_sort_with_buffer(first, middle, buf, comp);
+        my_stl::__stable_sort_with_buffer(middle, last, buf, comp);
+        if (comp(*middle, *(middle - 1))) {
+            my_stl::__merge_with_buffer(first, middle, last, buf, comp);
+        }
+    }
+
+    //the merge of the sgi __inplace_stable_sort: split the longer half in the middle, find
+    //where that element goes in the other half, rotate and merge the two pieces
+    template <typename _RandomIter, typename _Distance, typename _Comp>
+    void __merge_without_buffer(_RandomIter first, _RandomIter middle, _RandomIter last,
+            _Distance len1, _Distance len2, _Comp& comp) {
+        if (len1 == 0 || len2 == 0) return;
+        if (len1 + len2 == 2) {
+            if (comp(*middle, *first))  my_stl::__iter_swap(first, middle);
+            return;
+        }
+        _RandomIter first_cut, second_cut;
+        _Distance len11, len22;
+        if (len1 > len2) {
+            len11 = len1 / 2;
+            first_cut = first + len11;
+            //the first element of [middle, last) not less than *first_cut
+            _RandomIter lo = middle;
+            for (_Distance n = len2; n > 0; ) {
+                _Distance half = n / 2;
+                if (comp(*(lo + half), *first_cut)) {
+                    lo += half + 1;
+                    n -= half + 1;
+                }
+                else {
+                    n = half;
+                }
+            }
+            second_cut = lo;
+            len22 = second_cut - middle;
+        }
+        else {
+            len22 = len2 / 2;
+            second_cut = middle + len22;
+            //the first element of [first, middle) greater than *second_cut
+            _RandomIter lo = first;
+            for (_Distance n = len1; n > 0; ) {
+                _Distance half = n / 2;
+                if (!comp(*second_cut, *(lo + half))) {
+                    lo += half + 1;
+                    n -= half + 1;
+                }
+                else {
+                    n = half;
+                }
+            }
+            first_cut = lo;
+            len11 = first_cut - first;
+        }
+        _RandomIter new_middle = my_stl::__rotate(first_cut, middle, second_cut);
+        my_stl::__merge_without_buffer(first, first_cut, new_middle, len11, len22, comp);
+        my_stl::__merge_without_buffer(new_middle, second_cut, last, len1 - len11, len2 - len22, comp);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    void __inplace_stable_sort(_RandomIter first, _RandomIter last, _Comp& comp) {
+        if (last - first <= __stable_sort_chunk) {
+            my_stl::__insertion_sort(first, last, comp);
+            return;
+        }
+        _RandomIter middle = first + (last - first) / 2;
+        my_stl::__inplace_stable_sort(first, middle, comp);
+        my_stl::__inplace_stable_sort(middle, last, comp);
+        my_stl::__merge_without_buffer(first, middle, last, middle - first, last - middle, comp);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    void __stable_sort(_RandomIter first, _RandomIter last, _Comp& comp, random_access_iterator_tag) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        const size_t len = last - first;
+        if (len <= __stable_sort_chunk) {
+            my_stl::__insertion_sort(first, last, comp);
+            return;
+        }
+        __temporary_buffer<_Tp> buf(first, (len + 1) / 2);
+        if (buf.begin()) {
+            my_stl::__stable_sort_with_buffer(first, last, buf.begin(), comp);
+        }
+        else {
+            my_stl::__inplace_stable_sort(first, last, comp);
+        }
+    }
+
+    //sort [first, last) by comp, the equal elements keep their order
+    template <typename _RandomIter, typename _Comp>
+    inline void stable_sort(_RandomIter first, _RandomIter last, _Comp comp) {
+        my_stl::__stable_sort(first, last, comp, typename iterator_traits<_RandomIter>::iterator_category());
+    }
+
+    template <typename _RandomIter>
+    inline void stable_sort(_RandomIter first, _RandomIter last) {
+        my_stl::stable_sort(first, last, less<typename iterator_traits<_RandomIter>::value_type>());
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------partial sort------------------------------
+    //-----------------------------------------------------------------------
+    //the middle - first smallest elements sorted in [first, middle), the rest in any order
+    template <typename _RandomIter, typename _Comp>
+    inline void __partial_sort(_RandomIter first, _RandomIter middle, _RandomIter last, _Comp& comp,
+            random_access_iterator_tag) {
+        my_stl::__heap_select(first, middle, last, comp);
+        my_stl::__sort_heap(first, middle, comp);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline void partial_sort(_RandomIter first, _RandomIter middle, _RandomIter last, _Comp comp) {
+        my_stl::__partial_sort(first, middle, last, comp,
+                typename iterator_traits<_RandomIter>::iterator_category());
+    }
+
+    template <typename _RandomIter>
+    inline void partial_sort(_RandomIter first, _RandomIter middle, _RandomIter last) {
+        my_stl::partial_sort(first, middle, last, less<typename iterator_traits<_RandomIter>::value_type>());
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------nth element-------------------------------
+    //-----------------------------------------------------------------------
+    //introselect: partition as sort does but only go on with the side holding nth, after
+    //2 log(n) rounds fall back to the heap select
+    template <typename _RandomIter, typename _Comp>
+    void __nth_element(_RandomIter first, _RandomIter nth, _RandomIter last, _Comp& comp,
+            random_access_iterator_tag) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        if (first == last || nth == last)   return;
+        int depth_limit = 2 * my_stl::__lg(last - first);
+        while (last - first > 3) {
+            if (depth_limit-- == 0) {
+                my_stl::__heap_select(first, nth + 1, last, comp);
+                my_stl::__iter_swap(first, nth);
+                return;
+            }
+            my_stl::__sort3(first + (last - first) / 2, first, last - 1, comp);
+            _RandomIter cut = my_stl::__partition_right(first, last, comp,
+                    typename __is_branchless_comp<_Tp, _Comp>::type()).first;
+            if (cut == nth) return;
+            if (nth < cut)  last = cut;
+            else    first = cut + 1;
+        }
+        my_stl::__insertion_sort(first, last, comp);
+    }
+
+    //put the element that would be at nth if [first, last) were sorted there, with none of
+    //the elements before it greater and none after it less
+    template <typename _RandomIter, typename _Comp>
+    inline void nth_element(_RandomIter first, _RandomIter nth, _RandomIter last, _Comp comp) {
+        my_stl::__nth_element(first, nth, last, comp, typename iterator_traits<_RandomIter>::iterator_category());
+    }
+
+    template <typename _RandomIter>
+    inline void nth_element(_RandomIter first, _RandomIter nth, _RandomIter last) {
+        my_stl::nth_element(first, nth, last, less<typename iterator_traits<_RandomIter>::value_type>());
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------radix sort--------------------------------
+    //-----------------------------------------------------------------------
+    //LSD radix sort for integer and floating point keys. A key is mapped to the unsigned
+    //integer of its size with the same order: a signed integer gets its sign bit flipped,
+    //a negative float all its bits and a positive one its sign bit (so -0 goes before 0,
+    //-NaN first and NaN last). The counts of all the digits are taken in one pass, and a
+    //digit every key has in common costs no pass. The elements go back and forth between
+    //the range and a buffer from alloc. The digits are 11 bits for the long ranges of 4 and
+    //8 byte keys (fewer passes over the data), 8 bits otherwise. Short ranges are insertion
+    //sorted, and with no memory for the buffer it is a stable_sort by key. Stable
+    enum {__radix_sort_threshold = 64, __radix_long_range = 1 << 16};
+
+    template <size_t _Size> struct __radix_unsigned;
+    template <> struct __radix_unsigned<1> {typedef unsigned char type;};
+    template <> struct __radix_unsigned<2> {typedef unsigned short type;};
+    template <> struct __radix_unsigned<4> {typedef unsigned int type;};
+    template <> struct __radix_unsigned<8> {typedef unsigned long long type;};
+
+    template <typename _Key>
+    inline typename __radix_unsigned<sizeof(_Key)>::type __radix_encode(_Key k, __true_type) {
+        typedef typename __radix_unsigned<sizeof(_Key)>::type _Unsigned;
+        _Unsigned u = static_cast<_Unsigned>(k);
+        //the negative ones first
+        if (_Key(-1) < _Key(0)) u ^= _Unsigned(1) << (sizeof(_Key) * 8 - 1);
+        return u;
+    }
+
+    template <typename _Key>
+    inline typename __radix_unsigned<sizeof(_Key)>::type __radix_encode(_Key k, __false_type) {
+        typedef typename __radix_unsigned<sizeof(_Key)>::type _Unsigned;
+        _Unsigned u;
+        memcpy(&u, &k, sizeof(_Key));
+        const _Unsigned sign = _Unsigned(1) << (sizeof(_Key) * 8 - 1);
+        return (u & sign) ? _Unsigned(~u) : _Unsigned(u | sign);
+    }
+
+    template <typename _Tp>
+    struct __radix_identity {
+        const _Tp& operator()(const _Tp& x) const {
+            return x;
+        }
+    };
+
+    //move [first, last) to result, the digit of every element tells where
+    template <typename _InputIter, typename _OutputIter, typename _KeyOf>
+    void __radix_scatter(_InputIter first, _InputIter last, _OutputIter result, size_t* offsets,
+            int shift, size_t mask, _KeyOf& key_of) {
+        for (; first != last; ++first) {
+            const size_t digit = (key_of(*first) >> shift) & mask;
+            *(result + offsets[digit]++) = std::move(*first);
+        }
+    }
+
+    template <typename _RandomIter, typename _KeyFn>
+    void __radix_sort(_RandomIter first, _RandomIter last, _KeyFn& key_fn, random_access_iterator_tag) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        typedef typename remove_cv<typename remove_reference<decltype(key_fn(*first))>::type>::type _Key;
+        static_assert(is_integer<_Key>::value || (is_floating_point<_Key>::value && sizeof(_Key) <= 8),
+                "radix_sort sorts by integer, float or double keys");
+        typedef typename __radix_unsigned<sizeof(_Key)>::type _Unsigned;
+        typedef typename is_integer<_Key>::type _Is_integer;
+        auto key_of = [&key_fn](const _Tp& x) -> _Unsigned {
+            return my_stl::__radix_encode(_Key(key_fn(x)), _Is_integer());
+        };
+        auto comp = [&key_of](const _Tp& x, const _Tp& y) {return key_of(x) < key_of(y);};
+        const size_t len = last - first;
+        if (len < __radix_sort_threshold) {
+            my_stl::__insertion_sort(first, last, comp);
+            return;
+        }
+        __temporary_buffer<_Tp> buf(first, len);
+        if (!buf.begin()) {
+            my_stl::stable_sort(first, last, comp);
+            return;
+        }
+        const int bits = sizeof(_Key) >= 4 && len >= __radix_long_range ? 11 : 8;
+        const size_t radix = size_t(1) << bits, mask = radix - 1;
+        const int passes = (sizeof(_Key) * 8 + bits - 1) / bits;
+        typedef my_simple_alloc<size_t, alloc> _Count_alloc;
+        size_t* counts = _Count_alloc::allocate(passes * radix);
+        memset(counts, 0, passes * radix * sizeof(size_t));
+        try {
+            for (_RandomIter i = first; i != last; ++i) {
+                const _Unsigned k = key_of(*i);
+                for (int p = 0; p < passes; ++p) {
+                    ++counts[p * radix + ((k >> (p * bits)) & mask)];
+                }
+            }
+            bool in_buf = false;
+            for (int p = 0; p < passes; ++p) {
+                size_t* offsets = counts + p * radix;
+                const int shift = p * bits;
+                //every key has this digit
+                if (offsets[(key_of(in_buf ? *buf.begin() : *first) >> shift) & mask] == len) {
+                    continue;
+                }
+                for (size_t d = 0, sum = 0; d < radix; ++d) {
+                    const size_t c = offsets[d];
+                    offsets[d] = sum;
+                    sum += c;
+                }
+                if (in_buf) {
+                    my_stl::__radix_scatter(buf.begin(), buf.begin() + len, first, offsets, shift, mask, key_of);
+                }
+                else {
+                    my_stl::__radix_scatter(first, last, buf.begin(), offsets, shift, mask, key_of);
+                }
+                in_buf = !in_buf;
+            }
+            if (in_buf) {
+                _Tp* b = buf.begin();
+                for (_RandomIter i = first; i != last; ++i, ++b) {
+                    *i = std::move(*b);
+                }
+            }
+        }
+        catch (...) {
+            _Count_alloc::deallocate(counts, passes * radix);
+            throw;
+        }
+        _Count_alloc::deallocate(counts, passes * radix);
+    }
+
+    //sort [first, last) by the integer or floating point key_fn(x), the elements with equal
+    //keys keep their order
+    template <typename _RandomIter, typename _KeyFn>
+    inline void radix_sort(_RandomIter first, _RandomIter last, _KeyFn key_fn) {
+        my_stl::__radix_sort(first, last, key_fn, typename iterator_traits<_RandomIter>::iterator_category());
+    }
+
+    template <typename _RandomIter>
+    inline void radix_sort(_RandomIter first, _RandomIter last) {
+        my_stl::radix_sort(first, last, __radix_identity<typename iterator_traits<_RandomIter>::value_type>());
+    }
+}
+
+#endif
@@ -8,6 +8,9 @@
 #include <cstdlib> //for exit
 #include <iostream> //for cerr
 #include <climits>  //for UINT_MAX
+#include <mutex>    //for the lock of the central memory pool
+#include <cstring>  //for memmove, memcpy
+#include "m_type_traits.h"  //for declval
 
 namespace my_stl {
     //this is a naive implementation of the allocator function
@@ -107,10 +110,22 @@ namespace my_stl {
                 free(p);
             }
 
+            //realloc keeps the content, and may grow the block in place (or remap the pages
+            //for big blocks) instead of copying
             static void* reallocate(void *p, size_t old_size, size_t new_size) {
-                void* res = realloc(p, new_size);
-                if (!res)   res = oom_malloc(new_size);
-                return res;
+                return oom_realloc(p, new_size);
+            }
+
+            //the bytes malloc really hands out for a request of n, glibc on 64 bit keeps an 8 byte
+            //header in 16 byte steps (32 at least), blocks from mmap come in whole pages. For
+            //other libcs we don't know, so it is n itself
+            static size_t good_size(size_t n) noexcept {
+            #if defined(__GLIBC__) && __SIZEOF_POINTER__ == 8
+                if (n >= (size_t(128) << 10)) return ((n + 16 + 4095) & ~size_t(4095)) - 16;
+                return n + 8 < 32 ? 24 : ((n + 8 + 15) & ~size_t(15)) - 8;
+            #else
+                return n;
+            #endif
             }
 
             static void (*set_malloc_alloc_oom_handler(void (*handler)())) (){
@@ -135,20 +150,21 @@ namespace my_stl {
             }
             (*__malloc_alloc_oom_handler)();
             void* res = malloc(size);
-            if (!res)   return res;
+            if (res)   return res;
         }
     }
 
     template <int inst>
     void *__malloc_alloc<inst>::oom_realloc(void * p, size_t n) {
+        //the first try is made here too, so p goes to realloc at one place only
         while (true) {
+            void* res = realloc(p, n);
+            if (res)   return res;
             if (!__malloc_alloc_oom_handler) {
                 std::cerr << "out of memory" << std::endl;
                 exit(1);
             }
             (*__malloc_alloc_oom_handler)();
-            void* res = realloc(p, n);
-            if (!res)   return res;
         }
     }
     // the second level allocator uses memory pool to allocate memory, this allocator
@@ -159,6 +175,15 @@ namespace my_stl {
     //-----------------------------second level allocator----------------------------
     //modified it to be a template such that there is no dual initialization for static
     //members of memory pool
+    //
+    //modified 10/17/2026, the pool is now shared by all threads: every thread keeps a cache
+    //of free lists (thread_cache) in front of the central free lists, allocate and deallocate
+    //only touch the cache of the calling thread, and objects travel between the cache and the
+    //central pool in batches of __N_OBJS under pool_lock
+    //
+    //the pool also remembers every chunk it got from malloc, trim() finds the chunks whose
+    //objects are all back on the central free lists and gives them back to the system, this
+    //happens automatically once heap_size grows past the high water mark
     template <int inst>
     class __default_alloc {
         private:
@@ -167,6 +192,9 @@ namespace my_stl {
             static constexpr size_t __NFREELISTS = __MAX_BYTES / __ALIGN;
             //default 20 chunks of memory at max each time
             static constexpr int __N_OBJS = 20;
+            //once a thread cache holds more than this many objects of one size, a batch of
+            //__N_OBJS goes back to the central free list so that other threads can use them
+            static constexpr int __CACHE_LIMIT = 2 * __N_OBJS;
             //we have a guarantee that char is gonna occupy 1 byte of memory, the union will take 4 or 8 (depend on platform)
             //bytes of memory
             
@@ -174,13 +202,56 @@ namespace my_stl {
             static char *start_free;
             static char *end_free;
             static size_t heap_size;
+            //bytes sitting on the central free lists
+            static size_t free_bytes;
+            //automatic trim kicks in when heap_size is above high_water_mark and free_bytes
+            //reached trim_threshold, the threshold keeps us from rescanning after every release
+            static size_t high_water_mark;
+            static size_t trim_threshold;
+
+            //every block we got from malloc, sorted by address
+            struct chunk_info {
+                char* base;
+                size_t size;
+            };
+            static chunk_info* chunks;
+            static size_t n_chunks;
+            static size_t chunk_capacity;
 
             union obj{
                 obj* free_list_next;
                 char data;
             };
-            //a free list array of free memories
-            static obj* volatile free_list[__NFREELISTS];
+            //a free list array of free memories, this is the central pool shared by every thread
+            //and is only touched with pool_lock held
+            static obj* free_list[__NFREELISTS];
+            static std::mutex pool_lock;
+
+            //per thread free lists, count keeps the length of each list so we know when
+            //to give a batch back
+            struct thread_cache {
+                obj* free_list[__NFREELISTS];
+                int count[__NFREELISTS];
+
+                thread_cache(): free_list(), count() {}
+
+                //when the thread exits, everything it still caches goes back to the central pool
+                ~thread_cache() {
+                    for (size_t index = 0; index < __NFREELISTS; ++index) {
+                        if (!free_list[index])  continue;
+                        obj* tail = free_list[index];
+                        while (tail -> free_list_next)  tail = tail -> free_list_next;
+                        push_to_central(index, free_list[index], tail, count[index]);
+                        free_list[index] = nullptr;
+                        count[index] = 0;
+                    }
+                }
+            };
+
+            static thread_cache& get_thread_cache() {
+                static thread_local thread_cache cache;
+                return cache;
+            }
             
             //if the size if not the multiple of 8, we want to round up
             static size_t round_up(size_t n) {
@@ -188,8 +259,54 @@ namespace my_stl {
             }
 
             //for a size below 128, get the index in the free list
+            //a request of 0 bytes is served from the smallest list
             static size_t get_list_index(size_t n) {
-                return (n + __ALIGN - 1)/ __ALIGN - 1;
+                return n ? (n + __ALIGN - 1)/ __ALIGN - 1 : 0;
+            }
+
+            //link the chain [head, tail] of n_objs objects in front of the central free list
+            static void push_to_central(size_t index, obj* head, obj* tail, int n_objs) {
+                std::lock_guard<std::mutex> guard(pool_lock);
+                tail -> free_list_next = free_list[index];
+                free_list[index] = head;
+                free_bytes += n_objs * (index + 1) * __ALIGN;
+                if (heap_size > high_water_mark && free_bytes >= trim_threshold) {
+                    trim_locked();
+                }
+            }
+
+            //the thread cache for this size is empty, take a batch from the central free list,
+            //or carve a new batch out of the memory pool if the central list is empty as well
+            static void *fetch_from_central(thread_cache& cache, size_t index) {
+                std::lock_guard<std::mutex> guard(pool_lock);
+                obj* head = free_list[index];
+                if (!head) {
+                    return refill(cache, (index + 1) * __ALIGN);
+                }
+                obj* tail = head;
+                int taken = 1;
+                for (; taken < __N_OBJS && tail -> free_list_next; ++taken) {
+                    tail = tail -> free_list_next;
+                }
+                free_list[index] = tail -> free_list_next;
+                tail -> free_list_next = nullptr;
+                free_bytes -= taken * (index + 1) * __ALIGN;
+                //first object goes to the caller, the rest stay in the thread cache
+                cache.free_list[index] = head -> free_list_next;
+                cache.count[index] = taken - 1;
+                return head;
+            }
+
+            //give the first __N_OBJS objects of a full thread cache list back to the central pool
+            static void release_to_central(thread_cache& cache, size_t index) {
+                obj* head = cache.free_list[index];
+                obj* tail = head;
+                for (int i = 1; i < __N_OBJS; ++i) {
+                    tail = tail -> free_list_next;
+                }
+                cache.free_list[index] = tail -> free_list_next;
+                cache.count[index] -= __N_OBJS;
+                push_to_central(index, head, tail, __N_OBJS);
             }
 
 
@@ -197,9 +314,9 @@ namespace my_stl {
             //refill and chunk_alloc is implemented as state of art (also the core of the memory pool)
             //the job of refill is to maintain a array of linkedlist, while each of node is a chunk of memory
             //if by any chance that there is no memory chunck in the list to return, it will ask memory from memory pool
-
-
-            static char *refill(size_t n) {
+            //
+            //the new chunks go straight into the thread cache of the caller, must hold pool_lock
+            static char *refill(thread_cache& cache, size_t n) {
                 //memory pool is defined to allocate 20 chunks of the given size at a time
                 int n_objs = __N_OBJS;
                 //n_objs is passed by reference, so that we get the exact number of chunks being allocated
@@ -207,8 +324,8 @@ namespace my_stl {
                 //there are total n_objs chunks being allocated, so there are n_obj * n chars 
                 if (n_objs == 1)    return chunk;
                 char *ret = chunk;
-                obj* volatile *my_free_list = free_list + get_list_index(n);
-                obj* current_obj = *my_free_list = (obj *) (chunk + n);
+                size_t index = get_list_index(n);
+                obj* current_obj = cache.free_list[index] = (obj *) (chunk + n);
                 for (int i = 1; ;++i) {
                     obj* next_obj = (obj *)((char *)current_obj + n);
                     if (i == n_objs - 1) {
@@ -217,16 +334,18 @@ namespace my_stl {
                     }
                     current_obj = current_obj -> free_list_next = next_obj;
                 }
+                cache.count[index] = n_objs - 1;
                 return ret;
             }
 
             //add n_objs chunk with n bytes into the list
             //memory pool is maintained by this funciton, while use start_free and end_free to represent its start and end
             // assume n is already a multiple of 8, we want to allocate n_objs * n bytes of memory int
+            //must hold pool_lock
             static char *chunk_alloc(size_t n, int& n_objs) {
                 char *result;
-                int total_bytes = n * n_objs;
-                int bytes_left = end_free - start_free;
+                size_t total_bytes = n * n_objs;
+                size_t bytes_left = end_free - start_free;
                 //if there is already enough memory in the pool, we'll just return that
                 if (bytes_left >= total_bytes) {
                     result = start_free;
@@ -242,9 +361,17 @@ namespace my_stl {
                 }
                 //literally no memory left to allocated to even one chunk
                 else {
+                    //the few bytes left in the pool still make a smaller object, put them on
+                    //their free list instead of losing them (also lets the chunk be trimmed later)
+                    if (bytes_left > 0) {
+                        obj **my_free_list = free_list + get_list_index(bytes_left);
+                        ((obj *) start_free) -> free_list_next = *my_free_list;
+                        *my_free_list = (obj *) start_free;
+                        free_bytes += bytes_left;
+                    }
                     //we need to ask for more memory from heap to fill the memory, theoretically, it should grow up exponentially
                     //
-                    int bytes_request = (total_bytes << 1) + round_up(heap_size >> 4);
+                    size_t bytes_request = (total_bytes << 1) + round_up(heap_size >> 4);
                     start_free = (char *)malloc(bytes_request);
                     //if there is no memory enough for us to fill
                     if (!start_free) {
@@ -252,10 +379,11 @@ namespace my_stl {
                         //and find one to adjust into the memory pool
                         //we should never consider the chunk size less than n, cuz that will create disaster in multithread scenario
                         for (size_t chunk_size = n + __ALIGN; chunk_size <= __MAX_BYTES; chunk_size += __ALIGN) {
-                            obj *volatile *my_free_list = free_list + get_list_index(chunk_size);
+                            obj **my_free_list = free_list + get_list_index(chunk_size);
                             obj *chunk = *my_free_list;
                             if (chunk) {
                                 *my_free_list = chunk -> free_list_next;
+                                free_bytes -= chunk_size;
                                 start_free = (char *) chunk;
                                 end_free = start_free + chunk_size;
                                 //recursively call chunk_alloc to allocate more memory
@@ -265,15 +393,108 @@ namespace my_stl {
                         //now we have real trouble, there is no memory left whatsoever in the pool, should call the malloc_alloc to
                         //trigger the handler and hopely that should return a valid memory address
                         start_free = (char *)__malloc_alloc<inst>::allocate(total_bytes);
+                        bytes_request = total_bytes;
                     }
                     //do not quite understand this mechanism, need to be tested
                     heap_size += bytes_request;
                     end_free = start_free + bytes_request;
+                    register_chunk(start_free, bytes_request);
                     //now we should have enough memory, recursively call to allocate memory
                     return chunk_alloc(n, n_objs);
                 }
             }
 
+            //index of the chunk that holds p, n_chunks if p is not in any chunk we know
+            static size_t find_chunk(const char* p) {
+                size_t lo = 0, hi = n_chunks;
+                //find the first chunk whose base is greater than p
+                while (lo < hi) {
+                    size_t mid = (lo + hi) / 2;
+                    if (chunks[mid].base <= p)  lo = mid + 1;
+                    else    hi = mid;
+                }
+                if (lo == 0 || p >= chunks[lo - 1].base + chunks[lo - 1].size)  return n_chunks;
+                return lo - 1;
+            }
+
+            //remember a new malloc block, if the registry itself cannot grow the block is
+            //just never trimmed
+            static void register_chunk(char* base, size_t size) {
+                if (n_chunks == chunk_capacity) {
+                    size_t new_capacity = chunk_capacity ? chunk_capacity * 2 : 16;
+                    chunk_info* grown = (chunk_info *) realloc(chunks, new_capacity * sizeof(chunk_info));
+                    if (!grown) return;
+                    chunks = grown;
+                    chunk_capacity = new_capacity;
+                }
+                size_t pos = n_chunks;
+                for (; pos > 0 && chunks[pos - 1].base > base; --pos) {}
+                memmove(chunks + pos + 1, chunks + pos, (n_chunks - pos) * sizeof(chunk_info));
+                chunks[pos].base = base;
+                chunks[pos].size = size;
+                ++n_chunks;
+            }
+
+            //must hold pool_lock. A chunk can go back to the system once all of its bytes are
+            //either on the central free lists or in the part of the pool not carved yet.
+            //we add up the free bytes of each chunk, unlink the objects of the chunks that are
+            //entirely free and release them, returns the number of bytes released
+            static size_t trim_locked() {
+                size_t released = 0;
+                size_t* chunk_free = n_chunks ? (size_t *) calloc(n_chunks, sizeof(size_t)) : nullptr;
+                if (chunk_free) {
+                    for (size_t index = 0; index < __NFREELISTS; ++index) {
+                        for (obj* cur = free_list[index]; cur; cur = cur -> free_list_next) {
+                            size_t which = find_chunk((char *) cur);
+                            if (which != n_chunks)  chunk_free[which] += (index + 1) * __ALIGN;
+                        }
+                    }
+                    size_t pool_chunk = start_free != end_free ? find_chunk(start_free) : n_chunks;
+                    if (pool_chunk != n_chunks)    chunk_free[pool_chunk] += end_free - start_free;
+
+                    bool any = false;
+                    for (size_t i = 0; i < n_chunks; ++i) {
+                        any = any || chunk_free[i] == chunks[i].size;
+                    }
+                    if (any) {
+                        //drop every free object that lives in a chunk about to be released
+                        for (size_t index = 0; index < __NFREELISTS; ++index) {
+                            obj** link = free_list + index;
+                            while (*link) {
+                                size_t which = find_chunk((char *) *link);
+                                if (which != n_chunks && chunk_free[which] == chunks[which].size) {
+                                    *link = (*link) -> free_list_next;
+                                    free_bytes -= (index + 1) * __ALIGN;
+                                }
+                                else {
+                                    link = &(*link) -> free_list_next;
+                                }
+                            }
+                        }
+                        if (pool_chunk != n_chunks && chunk_free[pool_chunk] == chunks[pool_chunk].size) {
+                            start_free = end_free = nullptr;
+                        }
+                        //release the chunks and compact the registry
+                        size_t kept = 0;
+                        for (size_t i = 0; i < n_chunks; ++i) {
+                            if (chunk_free[i] == chunks[i].size) {
+                                __malloc_alloc<inst>::deallocate(chunks[i].base, chunks[i].size);
+                                heap_size -= chunks[i].size;
+                                released += chunks[i].size;
+                            }
+                            else {
+                                chunks[kept++] = chunks[i];
+                            }
+                        }
+                        n_chunks = kept;
+                    }
+                    free(chunk_free);
+                }
+                //wait until another quarter of the heap comes back before scanning again
+                trim_threshold = free_bytes + (heap_size >> 2);
+                return released;
+            }
+
         public:
             //allocate memory for given size
             static void *allocate(size_t n) {
@@ -281,27 +502,73 @@ namespace my_stl {
                 if (n > __MAX_BYTES) {
                     return __malloc_alloc<inst>::allocate(n);
                 }
-                obj* volatile * my_free_list = free_list + get_list_index(n);
-                obj* volatile res = *my_free_list;
+                size_t index = get_list_index(n);
+                thread_cache& cache = get_thread_cache();
+                obj* res = cache.free_list[index];
                 if (!res) {
-                    return refill(round_up(n));
+                    return fetch_from_central(cache, index);
                 }
-                *my_free_list = res -> free_list_next;
+                cache.free_list[index] = res -> free_list_next;
+                --cache.count[index];
                 return res;
             }
 
             //deallocate memory for given size and address
+            //memory can be given back from any thread, not only the one allocated it
             static void deallocate(void *p, size_t n) {
                 if (n > __MAX_BYTES) {
                     __malloc_alloc<inst>::deallocate(p, n);
                     return;
                 }
-                obj* volatile *my_free_list = free_list + get_list_index(n);
-                obj* volatile head = (obj *) p;
-                head -> free_list_next = *my_free_list;
-                *my_free_list = head;
+                size_t index = get_list_index(n);
+                thread_cache& cache = get_thread_cache();
+                obj* head = (obj *) p;
+                head -> free_list_next = cache.free_list[index];
+                cache.free_list[index] = head;
+                if (++cache.count[index] > __CACHE_LIMIT) {
+                    release_to_central(cache, index);
+                }
+            }
+            //resize a block given by allocate(old_sz), the content is kept
+            static void *reallocate(void *p, size_t old_sz, size_t new_sz);
+
+            //the bytes a request of n really takes, small ones get the whole __ALIGN step
+            static size_t good_size(size_t n) noexcept {
+                return n > __MAX_BYTES ? __malloc_alloc<inst>::good_size(n) : round_up(n);
+            }
+
+            //give the chunks that are completely free back to the system, the objects cached
+            //by the calling thread are flushed first, objects cached by other threads keep
+            //their chunks alive. Returns the number of bytes released
+            static size_t trim() {
+                thread_cache& cache = get_thread_cache();
+                for (size_t index = 0; index < __NFREELISTS; ++index) {
+                    if (!cache.free_list[index])    continue;
+                    obj* tail = cache.free_list[index];
+                    while (tail -> free_list_next)  tail = tail -> free_list_next;
+                    push_to_central(index, cache.free_list[index], tail, cache.count[index]);
+                    cache.free_list[index] = nullptr;
+                    cache.count[index] = 0;
+                }
+                std::lock_guard<std::mutex> guard(pool_lock);
+                return trim_locked();
+            }
+
+            //trim automatically whenever the pool holds more than bytes, returns the old mark
+            //(the default is never)
+            static size_t set_high_water_mark(size_t bytes) {
+                std::lock_guard<std::mutex> guard(pool_lock);
+                size_t old = high_water_mark;
+                high_water_mark = bytes;
+                trim_threshold = 0;
+                return old;
+            }
+
+            //bytes currently held from the system by the pool
+            static size_t pool_size() {
+                std::lock_guard<std::mutex> guard(pool_lock);
+                return heap_size;
             }
-            static void *reallocate(void *p, size_t old_sz, size_t new_size);
     };
 
     template <int inst>
@@ -313,9 +580,48 @@ namespace my_stl {
     template <int inst>
     size_t __default_alloc<inst>::heap_size = 0;
 
+    template <int inst>
+    size_t __default_alloc<inst>::free_bytes = 0;
+
+    template <int inst>
+    size_t __default_alloc<inst>::high_water_mark = size_t(-1);
+
+    template <int inst>
+    size_t __default_alloc<inst>::trim_threshold = 0;
+
+    template <int inst>
+    typename __default_alloc<inst>::chunk_info* __default_alloc<inst>::chunks = nullptr;
+
+    template <int inst>
+    size_t __default_alloc<inst>::n_chunks = 0;
+
+    template <int inst>
+    size_t __default_alloc<inst>::chunk_capacity = 0;
+
+    template <int inst>
+    std::mutex __default_alloc<inst>::pool_lock;
+
+    //1. both sizes above __MAX_BYTES: the block came from malloc, let realloc resize it
+    //2. both sizes fall into the same free list: the block is already big enough, keep it
+    //3. otherwise move into a block of the new size and copy what fits
+    template <int inst>
+    void *__default_alloc<inst>::reallocate(void *p, size_t old_sz, size_t new_sz) {
+        if (old_sz > __MAX_BYTES && new_sz > __MAX_BYTES) {
+            return __malloc_alloc<inst>::reallocate(p, old_sz, new_sz);
+        }
+        if (old_sz <= __MAX_BYTES && new_sz <= __MAX_BYTES &&
+                get_list_index(old_sz) == get_list_index(new_sz)) {
+            return p;
+        }
+        void* res = allocate(new_sz);
+        memcpy(res, p, old_sz < new_sz ? old_sz : new_sz);
+        deallocate(p, old_sz);
+        return res;
+    }
+
     //for 8, 16, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120, 128
     template <int inst>
-    typename __default_alloc<inst>::obj* volatile __default_alloc<inst>::free_list[__NFREELISTS] = 
+    typename __default_alloc<inst>::obj* __default_alloc<inst>::free_list[__NFREELISTS] = 
     {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,nullptr,
         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
     
@@ -325,6 +631,34 @@ namespace my_stl {
         typedef __default_alloc<0> alloc;
     #endif
 
+    //whether Alloc provides reallocate(p, old_bytes, new_bytes), containers of trivially
+    //relocatable objects grow through it when it is there
+    template <typename Alloc>
+    struct __has_reallocate {
+        private:
+            template <typename _A>
+            static auto __test(int) -> decltype(declval<_A&>().reallocate((void*)0, size_t(0), size_t(0)),
+                    true_type());
+            template <typename _A>
+            static false_type __test(...);
+        public:
+            typedef decltype(__test<Alloc>(0)) type;
+            static constexpr bool value = type::value;
+    };
+
+    //the bytes Alloc really hands out for a request of n, through Alloc::good_size(n) if it
+    //has one. Containers can round their capacity up to it for free
+    template <typename Alloc>
+    inline auto __alloc_good_size(size_t n, int) noexcept -> decltype(Alloc::good_size(n)) {
+        return Alloc::good_size(n);
+    }
+
+    template <typename Alloc>
+    inline size_t __alloc_good_size(size_t n, long) noexcept {return n;}
+
+    template <typename Alloc>
+    inline size_t __alloc_good_size(size_t n) noexcept {return __alloc_good_size<Alloc>(n, 0);}
+
     //testing the naive allocator we can see that it is not doing very well, in SGI implementation
     //the allocator is divided into two levels: first level is using malloc and free to allocate 
     //and manage memory, the second level(sub-allocator) is using complex memory pool
@@ -349,7 +683,7 @@ namespace my_stl {
             //nested class template with only one data member
             template <class _Tp1> 
             struct rebind{
-                typedef my_simple_alloc<_Tp1> other;
+                typedef my_simple_alloc<_Tp1, Alloc> other;
             };
             /*                 //generic copy constructor */
             /*                 template<class _Tp1> allocator(const allocator<_Tp1>&); */
@@ -370,6 +704,28 @@ namespace my_stl {
                 Alloc::deallocate(p, n * sizeof(_Tp));
             }
 
+            //resize the storage of old_n objects to new_n objects, the objects are moved
+            //bitwise so this is only for types that can be relocated by memcpy
+            static pointer reallocate(pointer p, size_type old_n, size_type new_n) {
+                return (pointer) Alloc::reallocate(p, old_n * sizeof(_Tp), new_n * sizeof(_Tp));
+            }
+
+            //the same calls made on an allocator instance, for containers that keep a
+            //(possibly stateful) Alloc object, e.g. an arena. Alloc only has to provide
+            //allocate(bytes) and deallocate(p, bytes), as static or member functions
+            static pointer allocate(Alloc& __a, size_type n) {
+                return (pointer) __a.allocate(n * sizeof(_Tp));
+            }
+
+            static void deallocate(Alloc& __a, pointer p, size_type n) {
+                __a.deallocate(p, n * sizeof(_Tp));
+            }
+
+            //only if __has_reallocate<Alloc>
+            static pointer reallocate(Alloc& __a, pointer p, size_type old_n, size_type new_n) {
+                return (pointer) __a.reallocate(p, old_n * sizeof(_Tp), new_n * sizeof(_Tp));
+            }
+
             //the max volumn
             static size_type max_size() {
                 return UINT_MAX / sizeof (_Tp);
@@ -381,6 +737,315 @@ namespace my_stl {
             //destroy this object
             static void destroy(pointer p) {p -> ~_Tp();};
     };
+
+    //--------------------------node pool, a stateful per container allocator------------------
+    //node based containers (list) ask for objects of one size, one at a time. node_pool carves
+    //them out of slabs of N objects taken from Alloc and recycles the freed ones through an
+    //intrusive free list, so the nodes of a container sit next to each other and allocating or
+    //freeing one is a couple of pointer moves.
+    //every container keeps its own pool (a node_pool instance is a pointer to a refcounted
+    //control block). Nodes moving between two containers (splice, merge) still have to be
+    //freed somewhere, so the two pools are joined: the smaller block hands its slabs and free
+    //list to the larger one and forwards to it, like a union-find. The memory is given back
+    //once the last container using any of the joined pools is gone, or by shrink_to_fit
+    template <typename Alloc = __malloc_alloc<0>, size_t N = 64>
+    class node_pool {
+        private:
+            struct __free_obj {
+                __free_obj* next;
+            };
+
+            struct __block {
+                __block* forward;       //the block we have been joined into, null for a root
+                size_t refs;            //pools and joined blocks pointing to this block
+                size_t obj_size;        //fixed by the first allocation
+                __free_obj* free_head;
+                __free_obj* free_tail;
+                char** slabs;           //sorted by address
+                size_t n_slabs;
+                size_t slab_capacity;
+            };
+
+            __block* __pool;
+
+            static __block* __new_block() {
+                __block* b = (__block*) Alloc::allocate(sizeof(__block));
+                b -> forward = nullptr;
+                b -> refs = 1;
+                b -> obj_size = 0;
+                b -> free_head = b -> free_tail = nullptr;
+                b -> slabs = nullptr;
+                b -> n_slabs = b -> slab_capacity = 0;
+                return b;
+            }
+
+            static size_t __slab_bytes(const __block* b) noexcept {
+                return N * b -> obj_size;
+            }
+
+            //drop one reference, a root gives its slabs back when nobody uses it, a joined
+            //block just lets go of the block it forwards to
+            static void __release(__block* b) noexcept {
+                while (b && --b -> refs == 0) {
+                    __block* next = b -> forward;
+                    for (size_t i = 0; i < b -> n_slabs; ++i) {
+                        Alloc::deallocate(b -> slabs[i], __slab_bytes(b));
+                    }
+                    free(b -> slabs);
+                    Alloc::deallocate(b, sizeof(__block));
+                    b = next;
+                }
+            }
+
+            //the root of our block, every forward we follow is cut short for the next time
+            __block* __root() noexcept {
+                while (__pool && __pool -> forward) {
+                    __block* next = __pool -> forward;
+                    ++next -> refs;
+                    __release(__pool);
+                    __pool = next;
+                }
+                return __pool;
+            }
+
+            //position of the slab holding p, or n_slabs if p is not from this pool
+            static size_t __find_slab(const __block* b, const char* p) noexcept {
+                size_t lo = 0, hi = b -> n_slabs;
+                while (lo < hi) {
+                    size_t mid = (lo + hi) / 2;
+                    if (b -> slabs[mid] <= p)   lo = mid + 1;
+                    else    hi = mid;
+                }
+                if (lo == 0 || p >= b -> slabs[lo - 1] + __slab_bytes(b))    return b -> n_slabs;
+                return lo - 1;
+            }
+
+            static void __insert_slab(__block* b, char* slab) {
+                if (b -> n_slabs == b -> slab_capacity) {
+                    size_t new_capacity = b -> slab_capacity ? 2 * b -> slab_capacity : 8;
+                    char** grown = (char**) realloc(b -> slabs, new_capacity * sizeof(char*));
+                    if (!grown) throw std::bad_alloc();
+                    b -> slabs = grown;
+                    b -> slab_capacity = new_capacity;
+                }
+                size_t pos = b -> n_slabs;
+                for (; pos > 0 && b -> slabs[pos - 1] > slab; --pos) {}
+                memmove(b -> slabs + pos + 1, b -> slabs + pos, (b -> n_slabs - pos) * sizeof(char*));
+                b -> slabs[pos] = slab;
+                ++b -> n_slabs;
+            }
+
+            //a new slab of N objects, all of them go on the free list
+            static void __add_slab(__block* b) {
+                char* slab = (char*) Alloc::allocate(__slab_bytes(b));
+                try {
+                    __insert_slab(b, slab);
+                }
+                catch (...) {
+                    Alloc::deallocate(slab, __slab_bytes(b));
+                    throw;
+                }
+                for (size_t i = N; i > 0; --i) {
+                    __free_obj* obj = (__free_obj*) (slab + (i - 1) * b -> obj_size);
+                    obj -> next = b -> free_head;
+                    b -> free_head = obj;
+                }
+                b -> free_tail = (__free_obj*) (slab + (N - 1) * b -> obj_size);
+            }
+
+        public:
+            //the control block is set up right away so copies made before the first
+            //allocation still share it
+            node_pool(): __pool(__new_block()) {}
+
+            //copies share the pool
+            node_pool(const node_pool& rhs) noexcept: __pool(rhs.__pool) {
+                if (__pool) ++__pool -> refs;
+            }
+
+            node_pool(node_pool&& rhs) noexcept: __pool(rhs.__pool) {
+                rhs.__pool = nullptr;
+            }
+
+            node_pool& operator=(node_pool rhs) noexcept {
+                swap(rhs);
+                return *this;
+            }
+
+            ~node_pool() {
+                __release(__pool);
+            }
+
+            void swap(node_pool& rhs) noexcept {
+                __block* temp = __pool;
+                __pool = rhs.__pool;
+                rhs.__pool = temp;
+            }
+
+            //the first allocation fixes the object size, other sizes go to Alloc directly
+            void* allocate(size_t n) {
+                if (!__root()) __pool = __new_block();
+                __block* b = __pool;
+                if (!b -> obj_size) {
+                    b -> obj_size = n < sizeof(__free_obj) ? sizeof(__free_obj) : n;
+                }
+                else if (n > b -> obj_size || n < b -> obj_size / 2) {
+                    return Alloc::allocate(n);
+                }
+                if (!b -> free_head)    __add_slab(b);
+                __free_obj* res = b -> free_head;
+                b -> free_head = res -> next;
+                if (!b -> free_head)    b -> free_tail = nullptr;
+                return res;
+            }
+
+            void deallocate(void* p, size_t n) noexcept {
+                __block* b = __root();
+                if (n > b -> obj_size || n < b -> obj_size / 2) {
+                    Alloc::deallocate(p, n);
+                    return;
+                }
+                __free_obj* obj = (__free_obj*) p;
+                obj -> next = b -> free_head;
+                b -> free_head = obj;
+                if (!b -> free_tail)    b -> free_tail = obj;
+            }
+
+            //merge the pool of rhs with ours, afterwards objects from either of them can be
+            //freed through either of them
+            void join(node_pool& rhs) {
+                __block* a = __root();
+                __block* b = rhs.__root();
+                if (a == b) return;
+                if (!a || !b) {
+                    //one of them has been moved from, just share the other one
+                    if (a) rhs = *this;
+                    else    *this = rhs;
+                    return;
+                }
+                if (a -> obj_size != b -> obj_size) throw std::bad_alloc();
+                //the smaller one goes into the larger one
+                if (a -> n_slabs < b -> n_slabs) {
+                    __block* temp = a;
+                    a = b;
+                    b = temp;
+                }
+                size_t total = a -> n_slabs + b -> n_slabs;
+                if (total > a -> slab_capacity) {
+                    char** grown = (char**) realloc(a -> slabs, total * sizeof(char*));
+                    if (!grown) throw std::bad_alloc();
+                    a -> slabs = grown;
+                    a -> slab_capacity = total;
+                }
+                //merge the two sorted slab arrays from the back
+                size_t i = a -> n_slabs, j = b -> n_slabs, k = total;
+                while (j > 0) {
+                    if (i > 0 && a -> slabs[i - 1] > b -> slabs[j - 1])    a -> slabs[--k] = a -> slabs[--i];
+                    else    a -> slabs[--k] = b -> slabs[--j];
+                }
+                a -> n_slabs = total;
+                free(b -> slabs);
+                b -> slabs = nullptr;
+                b -> n_slabs = b -> slab_capacity = 0;
+                //append the free list
+                if (b -> free_head) {
+                    if (a -> free_tail) a -> free_tail -> next = b -> free_head;
+                    else    a -> free_head = b -> free_head;
+                    a -> free_tail = b -> free_tail;
+                    b -> free_head = b -> free_tail = nullptr;
+                }
+                b -> forward = a;
+                ++a -> refs;
+                __root();
+                rhs.__root();
+            }
+
+            //give the slabs with no object in use back to Alloc, returns the number of slabs
+            //released
+            size_t shrink_to_fit() noexcept {
+                __block* b = __root();
+                if (!b || !b -> n_slabs)    return 0;
+                size_t* free_count = (size_t*) calloc(b -> n_slabs, sizeof(size_t));
+                if (!free_count)    return 0;
+                for (__free_obj* cur = b -> free_head; cur; cur = cur -> next) {
+                    size_t which = __find_slab(b, (char*) cur);
+                    if (which != b -> n_slabs)  ++free_count[which];
+                }
+                //unlink the objects of the free slabs
+                __free_obj** link = &b -> free_head;
+                b -> free_tail = nullptr;
+                while (*link) {
+                    size_t which = __find_slab(b, (char*) *link);
+                    if (which != b -> n_slabs && free_count[which] == N) {
+                        *link = (*link) -> next;
+                    }
+                    else {
+                        b -> free_tail = *link;
+                        link = &(*link) -> next;
+                    }
+                }
+                size_t kept = 0;
+                for (size_t i = 0; i < b -> n_slabs; ++i) {
+                    if (free_count[i] == N) Alloc::deallocate(b -> slabs[i], __slab_bytes(b));
+                    else    b -> slabs[kept++] = b -> slabs[i];
+                }
+                size_t released = b -> n_slabs - kept;
+                b -> n_slabs = kept;
+                free(free_count);
+                return released;
+            }
+
+            //number of objects the pool has room for
+            size_t capacity() const noexcept {
+                const __block* b = __pool;
+                while (b && b -> forward)   b = b -> forward;
+                return b ? b -> n_slabs * N : 0;
+            }
+
+            bool operator==(const node_pool& rhs) const noexcept {
+                const __block* a = __pool;
+                while (a && a -> forward)   a = a -> forward;
+                const __block* b = rhs.__pool;
+                while (b && b -> forward)   b = b -> forward;
+                return a == b;
+            }
+
+            bool operator!=(const node_pool& rhs) const noexcept {
+                return !operator==(rhs);
+            }
+    };
+
+    //a node_pool is a single pointer to the heap, moving it bitwise is fine
+    template <typename Alloc, size_t N>
+    struct is_trivially_relocatable<node_pool<Alloc, N>>: true_type {};
+
+    //hooks for the node based containers. Nodes moving from one container into another one
+    //get freed by the other one later: stateless allocators do not care, node pools have to
+    //be joined first
+    template <typename Alloc>
+    inline void __join_allocators(Alloc&, Alloc&) noexcept {}
+
+    template <typename Alloc, size_t N>
+    inline void __join_allocators(node_pool<Alloc, N>& __a, node_pool<Alloc, N>& __b) {
+        __a.join(__b);
+    }
+
+    //joining two pools may throw (a different object size, or no memory for the slab array),
+    //the splices taking a whole container are noexcept only with the allocators that never do
+    template <typename Alloc>
+    struct __is_nothrow_joinable: true_type {};
+
+    template <typename Alloc, size_t N>
+    struct __is_nothrow_joinable<node_pool<Alloc, N>>: false_type {};
+
+    //give the unused memory back, only the pools keep any
+    template <typename Alloc>
+    inline size_t __shrink_allocator(Alloc&) noexcept {return 0;}
+
+    template <typename Alloc, size_t N>
+    inline size_t __shrink_allocator(node_pool<Alloc, N>& __a) noexcept {
+        return __a.shrink_to_fit();
+    }
    
 }
 #endif
@@ -30,21 +30,6 @@ namespace my_stl {
         tp -> ~TYPE();
     }
 
-    //helper function to extract whether a type has a default dtor
-    template <typename TYPE>
-    inline typename __type_traits<TYPE>::has_trivial_dtor __has_trivial_dtor(const TYPE& type) noexcept{
-        return typename __type_traits<TYPE>::has_trivial_dtor();
-    }
-
-    //if we want to destroy the object in the range of [start, end), it is important that the
-    //dtor is not trivial, otherwise we are doing useless for-loop
-    template <typename ForwardIterator>
-    inline void destroy (ForwardIterator first, ForwardIterator last) noexcept{
-        //depend on whether we have
-        __destroy(first, last, __has_trivial_dtor(typename iterator_traits<ForwardIterator>::value_type()));
-    }
-
-
     //overloaded function for destroy, for trivial dtor type
     template <typename ForwardIterator>
     inline void __destroy (ForwardIterator first, ForwardIterator last, __true_type) noexcept{
@@ -58,6 +43,15 @@ namespace my_stl {
         }
     }
 
+    //if we want to destroy the object in the range of [start, end), it is important that the
+    //dtor is not trivial, otherwise we are doing useless for-loop
+    //dispatch on the type only, the value type may not be default constructible
+    template <typename ForwardIterator>
+    inline void destroy (ForwardIterator first, ForwardIterator last) noexcept{
+        typedef typename iterator_traits<ForwardIterator>::value_type _value_type;
+        __destroy(first, last, typename __type_traits<_value_type>::has_trivial_dtor());
+    }
+
 }
 
 #endif
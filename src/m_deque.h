@@ -0,0 +1,819 @@
+//A double ended queue as in SGI: the elements are kept in blocks of N, a map of pointers to
+//the blocks grows at both ends, so push and pop at either end never move an element
+#ifndef __MY_STL_DEQUE_H
+#define __MY_STL_DEQUE_H
+
+#include "m_memory.h"         //for the allocators, uninitialized_* and destroy
+#include "m_algobase.h"       //for move, move_backward
+#include "m_algorithm.h"      //for __reverse and __rotate
+#include "m_unique_ptr.h"     //for compressed_pair
+#include <cstddef>            //for size_t, ptrdiff_t
+#include <string.h>           //for memmove
+#include <utility>            //for std::move, std::forward
+#include <initializer_list>
+#include <stdexcept>          //for out_of_range
+#include <iostream>           //for the boundary error of the debug build
+
+
+namespace my_stl {
+
+    //elements in one block by default, 512 bytes worth of them as in SGI. A smaller block
+    //wastes less at the two ends, a bigger one walks the map less often
+    template <typename _Tp>
+    struct __deque_default_size:
+        integral_constant<size_t, (sizeof(_Tp) < 128 ? 512 / sizeof(_Tp) : 4)> {};
+
+    //the iterator is the element, the block it is in and the slot of that block in the map.
+    //_Ref and _Ptr make it the const iterator or the plain one
+    template <typename _Tp, typename _Ref, typename _Ptr, size_t N>
+    struct __deque_iterator {
+        using iterator = __deque_iterator<_Tp, _Tp&, _Tp*, N>;
+        using const_iterator = __deque_iterator<_Tp, const _Tp&, const _Tp*, N>;
+        using iterator_category = random_access_iterator_tag;
+        using value_type = _Tp;
+        using pointer = _Ptr;
+        using reference = _Ref;
+        using difference_type = std::ptrdiff_t;
+        using __map_pointer = _Tp**;
+
+        _Tp* cur;
+        _Tp* first;             //[first, last) is the whole block
+        _Tp* last;
+        __map_pointer node;
+
+        __deque_iterator(): cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {}
+        __deque_iterator(_Tp* __cur, __map_pointer __node):
+            cur(__cur), first(*__node), last(*__node + N), node(__node) {}
+        //copy, and the implicit conversion from plain iterator to const iterator
+        __deque_iterator(const iterator& other):
+            cur(other.cur), first(other.first), last(other.last), node(other.node) {}
+
+        void __set_node(__map_pointer new_node) noexcept {
+            node = new_node;
+            first = *new_node;
+            last = first + N;
+        }
+
+        reference operator*() const {return *cur;}
+        pointer operator->() const {return cur;}
+
+        __deque_iterator& operator++() {
+            if (++cur == last) {
+                __set_node(node + 1);
+                cur = first;
+            }
+            return *this;
+        }
+
+        __deque_iterator operator++(int) {
+            __deque_iterator _temp(*this);
+            ++*this;
+            return _temp;
+        }
+
+        __deque_iterator& operator--() {
+            if (cur == first) {
+                __set_node(node - 1);
+                cur = last;
+            }
+            --cur;
+            return *this;
+        }
+
+        __deque_iterator operator--(int) {
+            __deque_iterator _temp(*this);
+            --*this;
+            return _temp;
+        }
+
+        __deque_iterator& operator+=(difference_type n) {
+            const difference_type offset = n + (cur - first);
+            if (offset >= 0 && offset < difference_type(N)) {
+                cur += n;
+            }
+            else {
+                const difference_type node_offset = offset > 0 ? offset / difference_type(N) :
+                    -difference_type((-offset - 1) / N) - 1;
+                __set_node(node + node_offset);
+                cur = first + (offset - node_offset * difference_type(N));
+            }
+            return *this;
+        }
+
+        __deque_iterator& operator-=(difference_type n) {return *this += -n;}
+
+        __deque_iterator operator+(difference_type n) const {
+            __deque_iterator _temp(*this);
+            return _temp += n;
+        }
+
+        __deque_iterator operator-(difference_type n) const {
+            __deque_iterator _temp(*this);
+            return _temp -= n;
+        }
+
+        reference operator[](difference_type n) const {return *(*this + n);}
+
+        //written so that two null iterators (a moved from deque) are 0 apart
+        template <typename _R, typename _P>
+        difference_type operator-(const __deque_iterator<_Tp, _R, _P, N>& x) const {
+            return difference_type(N) * (node - x.node) + (cur - first) - (x.cur - x.first);
+        }
+
+        template <typename _R, typename _P>
+        bool operator==(const __deque_iterator<_Tp, _R, _P, N>& x) const {return cur == x.cur;}
+
+        template <typename _R, typename _P>
+        bool operator!=(const __deque_iterator<_Tp, _R, _P, N>& x) const {return cur != x.cur;}
+
+        template <typename _R, typename _P>
+        bool operator<(const __deque_iterator<_Tp, _R, _P, N>& x) const {
+            return node == x.node ? cur < x.cur : node < x.node;
+        }
+
+        template <typename _R, typename _P>
+        bool operator>(const __deque_iterator<_Tp, _R, _P, N>& x) const {return x < *this;}
+
+        template <typename _R, typename _P>
+        bool operator<=(const __deque_iterator<_Tp, _R, _P, N>& x) const {return !(x < *this);}
+
+        template <typename _R, typename _P>
+        bool operator>=(const __deque_iterator<_Tp, _R, _P, N>& x) const {return !(*this < x);}
+    };
+
+    template <typename _Tp, typename _Ref, typename _Ptr, size_t N>
+    inline __deque_iterator<_Tp, _Ref, _Ptr, N> operator+(std::ptrdiff_t n,
+            const __deque_iterator<_Tp, _Ref, _Ptr, N>& x) {
+        return x + n;
+    }
+
+
+    //the map holds the blocks in [first block, last block), the elements are [start, finish).
+    //The blocks in front of start and behind finish are spares: a block emptied at one end is
+    //kept (up to __max_spare_blocks of them) and handed to the end that needs one next, so a
+    //deque used as a FIFO queue stops allocating once it is warmed up.
+    // map: |     |##|##|==|==|==|==|##|     |
+    //              ^     ^           ^  ^
+    //     first block    start.node  |  last block
+    //                          finish.node
+    //the blocks go through Alloc, all of them have the same size so a node_pool recycles them
+    //between deques as well. The map itself comes from the library pool
+    template <typename _Tp, size_t N = __deque_default_size<_Tp>::value, typename Alloc = alloc>
+    class deque {
+        static_assert(N > 0, "a deque block has to hold at least one element");
+
+        public:
+            using iterator = __deque_iterator<_Tp, _Tp&, _Tp*, N>;
+            using const_iterator = __deque_iterator<_Tp, const _Tp&, const _Tp*, N>;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using value_type = _Tp;
+            using pointer = _Tp*;
+            using const_pointer = const _Tp*;
+            using reference = _Tp&;
+            using const_reference = const _Tp&;
+            using allocator_type = Alloc;
+
+            using reverse_iterator = my_stl::reverse_iterator<iterator>;
+            using const_reverse_iterator = my_stl::reverse_iterator<const_iterator>;
+
+        protected:
+            using __map_pointer = _Tp**;
+            using __block_allocator = my_simple_alloc<_Tp, Alloc>;
+            using __map_allocator = my_simple_alloc<_Tp*, alloc>;
+
+            enum {__min_map_size = 8, __max_spare_blocks = 2};
+
+            //the map is kept together with the allocator instance as in vector
+            compressed_pair<__map_pointer, Alloc> __map_and_alloc;
+            size_type __map_size;
+            __map_pointer __first_block;
+            __map_pointer __last_block;
+            iterator __start;
+            iterator __finish;
+
+            __map_pointer& __map() noexcept {return __map_and_alloc.first();}
+            __map_pointer __map() const noexcept {return __map_and_alloc.first();}
+            Alloc& __alloc() noexcept {return __map_and_alloc.second();}
+
+            _Tp* __allocate_block() {
+                return __block_allocator::allocate(__alloc(), N);
+            }
+
+            void __deallocate_block(_Tp* p) noexcept {
+                __block_allocator::deallocate(__alloc(), p, N);
+            }
+
+            //a map with blocks for n elements, start is at the beginning of the first block
+            void __initialize_map(size_type n);
+
+            //free all the blocks and the map, the elements are already gone
+            void __deallocate_map() noexcept {
+                for (__map_pointer n = __first_block; n != __last_block; ++n) {
+                    __deallocate_block(*n);
+                }
+                __map_allocator::deallocate(__map(), __map_size);
+            }
+
+            //more room in the map for nodes_to_add blocks at one end, the blocks are recentered
+            //if the map is mostly empty, otherwise the map grows
+            void __reallocate_map(size_type nodes_to_add, bool add_at_front);
+
+            void __reserve_map_at_back(size_type nodes_to_add = 1) {
+                if (nodes_to_add > size_type(__map() + __map_size - __last_block)) {
+                    __reallocate_map(nodes_to_add, false);
+                }
+            }
+
+            void __reserve_map_at_front(size_type nodes_to_add = 1) {
+                if (nodes_to_add > size_type(__first_block - __map())) {
+                    __reallocate_map(nodes_to_add, true);
+                }
+            }
+
+            //make sure there is a block right after finish, a spare from the front if we have one
+            void __ensure_block_at_back() {
+                if (__finish.node + 1 != __last_block)  return;
+                __reserve_map_at_back();
+                if (__first_block != __start.node) {
+                    *__last_block = *__first_block;
+                    ++__first_block;
+                }
+                else {
+                    *__last_block = __allocate_block();
+                }
+                ++__last_block;
+            }
+
+            void __ensure_block_at_front() {
+                if (__start.node != __first_block)  return;
+                __reserve_map_at_front();
+                if (__finish.node + 1 != __last_block) {
+                    *(__first_block - 1) = *(__last_block - 1);
+                    --__last_block;
+                }
+                else {
+                    *(__first_block - 1) = __allocate_block();
+                }
+                --__first_block;
+            }
+
+            //free the spare blocks past __max_spare_blocks, the ones farthest from the
+            //elements go first
+            void __trim_spares(size_type keep = __max_spare_blocks) noexcept {
+                if (!__map())   return;
+                size_type spares = (__start.node - __first_block) + (__last_block - __finish.node - 1);
+                for (; spares > keep && __first_block != __start.node; --spares) {
+                    __deallocate_block(*__first_block++);
+                }
+                for (; spares > keep; --spares) {
+                    __deallocate_block(*--__last_block);
+                }
+            }
+
+            template <typename... Args>
+            void __emplace_back_aux(Args&&... args) {
+                if (!__map()) {
+                    //moved from, the map comes back with the first element
+                    __initialize_map(0);
+                    emplace_back(std::forward<Args>(args)...);
+                    return;
+                }
+                __ensure_block_at_back();
+                construct(__finish.cur, std::forward<Args>(args)...);
+                __finish.__set_node(__finish.node + 1);
+                __finish.cur = __finish.first;
+            }
+
+            template <typename... Args>
+            void __emplace_front_aux(Args&&... args) {
+                if (!__map()) {
+                    __initialize_map(0);
+                    emplace_front(std::forward<Args>(args)...);
+                    return;
+                }
+                __ensure_block_at_front();
+                _Tp* p = *(__start.node - 1) + (N - 1);
+                construct(p, std::forward<Args>(args)...);
+                __start.__set_node(__start.node - 1);
+                __start.cur = p;
+            }
+
+            //the elements added at the front or back by an insert that failed half way
+            void __pop_front_n(size_type n) noexcept {
+                for (; n > 0; --n) pop_front();
+            }
+
+            void __pop_back_n(size_type n) noexcept {
+                for (; n > 0; --n) pop_back();
+            }
+
+            template <typename _Integer>
+            iterator __insert_dispatch(const_iterator __position, _Integer n, _Integer value,
+                    __true_type) {
+                return insert(__position, size_type(n), _Tp(value));
+            }
+
+            template <typename InputIterator>
+            iterator __insert_dispatch(const_iterator __position, InputIterator first,
+                    InputIterator last, __false_type);
+
+            __attribute__((noinline, noreturn)) static void __throw_out_of_range() {
+                throw std::out_of_range("deque::at");
+            }
+
+        #ifdef __MY_STL_DEBUG
+            void __check_boundary(size_type n) const {
+                if (n >= size()) {
+                    std::cerr << "out of deque boundary" << std::endl;
+                    exit(1);
+                }
+            }
+        #endif
+
+        public:
+            //------------------------Constructors------------------------------
+            deque(): deque(Alloc()) {}
+
+            explicit deque(const Alloc& __a): __map_and_alloc(nullptr, __a) {
+                __initialize_map(0);
+            }
+
+            explicit deque(size_type n): deque(n, _Tp()) {}
+
+            deque(size_type n, const value_type& value, const Alloc& __a = Alloc()):
+                    __map_and_alloc(nullptr, __a) {
+                __initialize_map(n);
+                try {
+                    my_stl::uninitialized_fill(__start, __finish, value);
+                }
+                catch (...) {
+                    __deallocate_map();
+                    throw;
+                }
+            }
+
+            deque(const deque& x): __map_and_alloc(nullptr, x.__map_and_alloc.second()) {
+                __initialize_map(x.size());
+                try {
+                    my_stl::uninitialized_copy(x.begin(), x.end(), __start);
+                }
+                catch (...) {
+                    __deallocate_map();
+                    throw;
+                }
+            }
+
+            //the moved from deque has no map and no blocks, it is empty and the first push
+            //allocates them again
+            deque(deque&& x) noexcept: __map_and_alloc(x.__map(), x.__alloc()),
+                    __map_size(x.__map_size), __first_block(x.__first_block),
+                    __last_block(x.__last_block), __start(x.__start), __finish(x.__finish) {
+                x.__map() = x.__first_block = x.__last_block = nullptr;
+                x.__map_size = 0;
+                x.__start = x.__finish = iterator();
+            }
+
+            deque(std::initializer_list<value_type> il): deque() {
+                insert(cend(), il.begin(), il.end());
+            }
+
+            template <typename InputIterator>
+            deque(InputIterator first, InputIterator last): deque() {
+                insert(cend(), first, last);
+            }
+
+            deque& operator=(const deque& x) {
+                if (this != &x) {
+                    deque temp(x);
+                    swap(temp);
+                }
+                return *this;
+            }
+
+            deque& operator=(deque&& x) noexcept {
+                if (this != &x) {
+                    deque temp(std::move(x));
+                    swap(temp);
+                }
+                return *this;
+            }
+
+            deque& operator=(std::initializer_list<value_type> il) {
+                deque temp(il);
+                swap(temp);
+                return *this;
+            }
+
+            ~deque() {
+                if (!__map())   return;
+                my_stl::destroy(__start, __finish);
+                __deallocate_map();
+            }
+
+            //--------------------------------iterators----------------------------------//
+            iterator begin() noexcept {return __start;}
+            const_iterator begin() const noexcept {return __start;}
+            iterator end() noexcept {return __finish;}
+            const_iterator end() const noexcept {return __finish;}
+            const_iterator cbegin() const noexcept {return __start;}
+            const_iterator cend() const noexcept {return __finish;}
+
+            reverse_iterator rbegin() noexcept {return reverse_iterator(end());}
+            const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+            reverse_iterator rend() noexcept {return reverse_iterator(begin());}
+            const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+            const_reverse_iterator crbegin() const noexcept {return rbegin();}
+            const_reverse_iterator crend() const noexcept {return rend();}
+
+            //------------------------------element access------------------------------------
+            //unchecked as in vector, __MY_STL_DEBUG checks it
+            reference operator[](size_type n) {
+            #ifdef __MY_STL_DEBUG
+                __check_boundary(n);
+            #endif
+                const size_type offset = n + (__start.cur - __start.first);
+                return __start.node[offset / N][offset % N];
+            }
+
+            const_reference operator[](size_type n) const {
+            #ifdef __MY_STL_DEBUG
+                __check_boundary(n);
+            #endif
+                const size_type offset = n + (__start.cur - __start.first);
+                return __start.node[offset / N][offset % N];
+            }
+
+            reference at(size_type n) {
+                if (n >= size())    __throw_out_of_range();
+                return (*this)[n];
+            }
+
+            const_reference at(size_type n) const {
+                if (n >= size())    __throw_out_of_range();
+                return (*this)[n];
+            }
+
+            reference front() {return *__start.cur;}
+            const_reference front() const {return *__start.cur;}
+
+            reference back() {
+                iterator _temp(__finish);
+                return *--_temp;
+            }
+
+            const_reference back() const {
+                const_iterator _temp(__finish);
+                return *--_temp;
+            }
+
+            //------------------------------capacity------------------------------------
+            size_type size() const noexcept {return __finish - __start;}
+            bool empty() const noexcept {return __finish == __start;}
+            size_type max_size() const noexcept {return size_type(-1);}
+
+            Alloc get_allocator() const {return __map_and_alloc.second();}
+
+            //give back all the spare blocks, and the memory the allocator keeps for them
+            void shrink_to_fit() noexcept {
+                if (!__map())   return;
+                __trim_spares(0);
+                __shrink_allocator(__alloc());
+            }
+
+            //------------------------------modifiers------------------------------------
+            void swap(deque& x) noexcept {
+                using std::swap;
+                __map_and_alloc.swap(x.__map_and_alloc);
+                swap(__map_size, x.__map_size);
+                swap(__first_block, x.__first_block);
+                swap(__last_block, x.__last_block);
+                swap(__start, x.__start);
+                swap(__finish, x.__finish);
+            }
+
+            //the block of start is kept, the others are freed down to the spares
+            void clear() noexcept {
+                my_stl::destroy(__start, __finish);
+                __finish = __start;
+                __trim_spares();
+            }
+
+            template <typename... Args>
+            void emplace_back(Args&&... args) {
+                //no map, all null, takes the slow path
+                if (__finish.last - __finish.cur > 1) {
+                    construct(__finish.cur, std::forward<Args>(args)...);
+                    ++__finish.cur;
+                }
+                else {
+                    __emplace_back_aux(std::forward<Args>(args)...);
+                }
+            }
+
+            template <typename... Args>
+            void emplace_front(Args&&... args) {
+                if (__start.cur != __start.first) {
+                    construct(__start.cur - 1, std::forward<Args>(args)...);
+                    --__start.cur;
+                }
+                else {
+                    __emplace_front_aux(std::forward<Args>(args)...);
+                }
+            }
+
+            void push_back(const value_type& value) {emplace_back(value);}
+            void push_back(value_type&& value) {emplace_back(std::move(value));}
+            void push_front(const value_type& value) {emplace_front(value);}
+            void push_front(value_type&& value) {emplace_front(std::move(value));}
+
+            //an emptied block becomes a spare
+            void pop_back() noexcept {
+                if (__finish.cur != __finish.first) {
+                    --__finish.cur;
+                    destroy(__finish.cur);
+                }
+                else {
+                    __finish.__set_node(__finish.node - 1);
+                    __finish.cur = __finish.last - 1;
+                    destroy(__finish.cur);
+                    __trim_spares();
+                }
+            }
+
+            void pop_front() noexcept {
+                destroy(__start.cur);
+                if (__start.cur != __start.last - 1) {
+                    ++__start.cur;
+                }
+                else {
+                    __start.__set_node(__start.node + 1);
+                    __start.cur = __start.first;
+                    __trim_spares();
+                }
+            }
+
+            //the elements on the shorter side of pos are moved
+            template <typename... Args>
+            iterator emplace(const_iterator __position, Args&&... args);
+
+            iterator insert(const_iterator __position, const value_type& value) {
+                return emplace(__position, value);
+            }
+
+            iterator insert(const_iterator __position, value_type&& value) {
+                return emplace(__position, std::move(value));
+            }
+
+            iterator insert(const_iterator __position, size_type n, const value_type& value);
+
+            template <typename InputIterator>
+            iterator insert(const_iterator __position, InputIterator first, InputIterator last) {
+                return __insert_dispatch(__position, first, last,
+                        typename is_integer<InputIterator>::type());
+            }
+
+            iterator insert(const_iterator __position, std::initializer_list<value_type> il) {
+                return insert(__position, il.begin(), il.end());
+            }
+
+            iterator erase(const_iterator __position) {
+                return erase(__position, __position + 1);
+            }
+
+            iterator erase(const_iterator __first, const_iterator __last);
+
+            void resize(size_type n, const value_type& value) {
+                const size_type len = size();
+                if (n < len)    erase(cbegin() + n, cend());
+                else    insert(cend(), n - len, value);
+            }
+
+            void resize(size_type n) {
+                resize(n, _Tp());
+            }
+
+            template <typename InputIterator>
+            void assign(InputIterator first, InputIterator last) {
+                clear();
+                insert(cend(), first, last);
+            }
+
+            void assign(size_type n, const value_type& value) {
+                clear();
+                insert(cend(), n, value);
+            }
+
+            void assign(std::initializer_list<value_type> il) {
+                assign(il.begin(), il.end());
+            }
+    };
+
+    //the map and the blocks all live on the heap
+    template <typename _Tp, size_t N, typename Alloc>
+    struct is_trivially_relocatable<deque<_Tp, N, Alloc>>: __is_relocatable_alloc<Alloc> {};
+
+    template <typename _Tp, size_t N, typename Alloc>
+    void swap(deque<_Tp, N, Alloc>& lhs, deque<_Tp, N, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    inline bool operator==(const deque<_Tp, N, Alloc>& lhs, const deque<_Tp, N, Alloc>& rhs) {
+        if (lhs.size() != rhs.size())   return false;
+        auto _it1 = lhs.cbegin();
+        auto _it2 = rhs.cbegin();
+        for (; _it1 != lhs.cend(); ++_it1, ++_it2) {
+            if (!(*_it1 == *_it2))  return false;
+        }
+        return true;
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    inline bool operator!=(const deque<_Tp, N, Alloc>& lhs, const deque<_Tp, N, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    //------------------------------------------------------------------------
+    //-----------------------------The map------------------------------------
+    //------------------------------------------------------------------------
+    template <typename _Tp, size_t N, typename Alloc>
+    void deque<_Tp, N, Alloc>::__initialize_map(size_type n) {
+        const size_type num_nodes = n / N + 1;
+        __map_size = num_nodes + 2 > size_type(__min_map_size) ? num_nodes + 2 : size_type(__min_map_size);
+        __map() = __map_allocator::allocate(__map_size);
+        //the blocks sit in the middle of the map, room to grow at both ends
+        __map_pointer nstart = __map() + (__map_size - num_nodes) / 2;
+        __map_pointer cur = nstart;
+        try {
+            for (; cur != nstart + num_nodes; ++cur) {
+                *cur = __allocate_block();
+            }
+        }
+        catch (...) {
+            for (__map_pointer p = nstart; p != cur; ++p) {
+                __deallocate_block(*p);
+            }
+            __map_allocator::deallocate(__map(), __map_size);
+            __map() = nullptr;
+            throw;
+        }
+        __first_block = nstart;
+        __last_block = nstart + num_nodes;
+        __start.__set_node(nstart);
+        __start.cur = __start.first;
+        __finish.__set_node(__last_block - 1);
+        __finish.cur = __finish.first + n % N;
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    void deque<_Tp, N, Alloc>::__reallocate_map(size_type nodes_to_add, bool add_at_front) {
+        const size_type old_num_nodes = __last_block - __first_block;
+        const size_type new_num_nodes = old_num_nodes + nodes_to_add;
+        __map_pointer new_first;
+        if (__map_size > 2 * new_num_nodes) {
+            //more than half of the map is free, center the blocks again
+            new_first = __map() + (__map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
+            memmove(new_first, __first_block, old_num_nodes * sizeof(_Tp*));
+        }
+        else {
+            const size_type new_map_size = __map_size + (__map_size > nodes_to_add ? __map_size : nodes_to_add) + 2;
+            __map_pointer new_map = __map_allocator::allocate(new_map_size);
+            new_first = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
+            memcpy(new_first, __first_block, old_num_nodes * sizeof(_Tp*));
+            __map_allocator::deallocate(__map(), __map_size);
+            __map() = new_map;
+            __map_size = new_map_size;
+        }
+        //the blocks stay where they are, only their slots move
+        __start.node = new_first + (__start.node - __first_block);
+        __finish.node = new_first + (__finish.node - __first_block);
+        __first_block = new_first;
+        __last_block = new_first + old_num_nodes;
+    }
+
+    //--------------------------------------------------------------------------------
+    //-------------------------Insert and erase --------------------------------------
+    //--------------------------------------------------------------------------------
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename... Args>
+    typename deque<_Tp, N, Alloc>::iterator
+    deque<_Tp, N, Alloc>::emplace(const_iterator __position, Args&&... args) {
+        const difference_type index = __position - __start;
+        if (__position.cur == __start.cur) {
+            emplace_front(std::forward<Args>(args)...);
+            return __start;
+        }
+        if (__position.cur == __finish.cur) {
+            emplace_back(std::forward<Args>(args)...);
+            return __finish - 1;
+        }
+        //the value is built first, args may refer to an element we are about to move
+        _Tp __tmp(std::forward<Args>(args)...);
+        if (size_type(index) < size() / 2) {
+            //the front moves one to the front
+            emplace_front(std::move(front()));
+            iterator pos = __start + (index + 1);
+            my_stl::move(__start + 2, pos, __start + 1);
+            *--pos = std::move(__tmp);
+            return pos;
+        }
+        emplace_back(std::move(back()));
+        iterator pos = __start + index;
+        my_stl::move_backward(pos, __finish - 2, __finish - 1);
+        *pos = std::move(__tmp);
+        return pos;
+    }
+
+    //the copies are pushed at the end closer to pos and rotated into place
+    template <typename _Tp, size_t N, typename Alloc>
+    typename deque<_Tp, N, Alloc>::iterator
+    deque<_Tp, N, Alloc>::insert(const_iterator __position, size_type n, const value_type& value) {
+        const difference_type index = __position - __start;
+        if (n == 0) return __start + index;
+        const _Tp value_copy(value);
+        size_type added = 0;
+        if (size_type(index) < size() / 2) {
+            try {
+                for (; added < n; ++added) push_front(value_copy);
+            }
+            catch (...) {
+                __pop_front_n(added);
+                throw;
+            }
+            my_stl::__rotate(__start, __start + n, __start + (n + index));
+        }
+        else {
+            const size_type old_size = size();
+            try {
+                for (; added < n; ++added) push_back(value_copy);
+            }
+            catch (...) {
+                __pop_back_n(added);
+                throw;
+            }
+            my_stl::__rotate(__start + index, __start + old_size, __finish);
+        }
+        return __start + index;
+    }
+
+    //the same with a range, pushed at the front it comes out reversed
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename InputIterator>
+    typename deque<_Tp, N, Alloc>::iterator
+    deque<_Tp, N, Alloc>::__insert_dispatch(const_iterator __position, InputIterator first,
+            InputIterator last, __false_type) {
+        const difference_type index = __position - __start;
+        size_type added = 0;
+        if (size_type(index) < size() / 2) {
+            try {
+                for (; first != last; ++first, ++added) push_front(*first);
+            }
+            catch (...) {
+                __pop_front_n(added);
+                throw;
+            }
+            my_stl::__reverse(__start, __start + added);
+            my_stl::__rotate(__start, __start + added, __start + (added + index));
+        }
+        else {
+            const size_type old_size = size();
+            try {
+                for (; first != last; ++first, ++added) push_back(*first);
+            }
+            catch (...) {
+                __pop_back_n(added);
+                throw;
+            }
+            my_stl::__rotate(__start + index, __start + old_size, __finish);
+        }
+        return __start + index;
+    }
+
+    //the elements on the shorter side of the hole close it
+    template <typename _Tp, size_t N, typename Alloc>
+    typename deque<_Tp, N, Alloc>::iterator
+    deque<_Tp, N, Alloc>::erase(const_iterator __first, const_iterator __last) {
+        const difference_type index = __first - __start;
+        const difference_type n = __last - __first;
+        if (n == 0) return __start + index;
+        iterator first = __start + index;
+        iterator last = first + n;
+        if (size_type(index) < (size() - n) / 2) {
+            my_stl::move_backward(__start, first, last);
+            iterator new_start = __start + n;
+            my_stl::destroy(__start, new_start);
+            __start = new_start;
+        }
+        else {
+            my_stl::move(last, __finish, first);
+            iterator new_finish = __finish - n;
+            my_stl::destroy(new_finish, __finish);
+            __finish = new_finish;
+        }
+        __trim_spares();
+        return __start + index;
+    }
+}
+
+#endif
@@ -0,0 +1,472 @@
+#ifndef __MY_STL_EXECUTION_H
+#define __MY_STL_EXECUTION_H
+
+#include "m_algorithm.h"
+#include "m_numeric.h"
+#include "m_uninitialized.h"
+#include "m_type_traits.h"
+#include "m_iterator.h"
+#include "m_thread_pool.h"
+#include <cstddef>              //for size_t
+#include <utility>              //for std::move
+
+namespace my_stl {
+    //-----------------------------------------------------------------------
+    //-----------------------------policies----------------------------------
+    //-----------------------------------------------------------------------
+    //the execution policies of c++17. seq runs the plain algorithm, par and par_unseq split
+    //random access ranges over the shared thread_pool (par_unseq is run as par, the chunks
+    //are vectorized by the compiler the same way either way). Other iterators and ranges
+    //shorter than __parallel_threshold stay serial
+    namespace execution {
+        struct sequenced_policy {};
+        struct parallel_policy {};
+        struct parallel_unsequenced_policy {};
+
+        constexpr sequenced_policy seq{};
+        constexpr parallel_policy par{};
+        constexpr parallel_unsequenced_policy par_unseq{};
+    }
+
+    template <typename _Tp>
+    struct is_execution_policy: false_type {};
+
+    template <>
+    struct is_execution_policy<execution::sequenced_policy>: true_type {};
+
+    template <>
+    struct is_execution_policy<execution::parallel_policy>: true_type {};
+
+    template <>
+    struct is_execution_policy<execution::parallel_unsequenced_policy>: true_type {};
+
+    template <typename _Policy>
+    struct __policy_type {
+        typedef typename remove_cv<typename remove_reference<_Policy>::type>::type type;
+    };
+
+    //keeps the policy overloads away from the calls without a policy, sort(first, last, comp)
+    //and sort(par, first, last) have the same number of arguments
+    template <typename _Policy, typename _Ret,
+             bool = is_execution_policy<typename __policy_type<_Policy>::type>::value>
+    struct __enable_if_execution_policy {};
+
+    template <typename _Policy, typename _Ret>
+    struct __enable_if_execution_policy<_Policy, _Ret, true> {
+        typedef _Ret type;
+    };
+
+    template <typename _Iter>
+    struct __is_random_access_iter: is_same<typename iterator_traits<_Iter>::iterator_category,
+                                            random_access_iterator_tag> {};
+
+    //whether the call is split over the threads
+    template <typename _Policy, typename _Iter1, typename _Iter2 = _Iter1, typename _Iter3 = _Iter1>
+    struct __use_parallel: integral_constant<bool,
+            !is_same<typename __policy_type<_Policy>::type, execution::sequenced_policy>::value
+            && __is_random_access_iter<_Iter1>::value && __is_random_access_iter<_Iter2>::value
+            && __is_random_access_iter<_Iter3>::value> {};
+
+    //a range is cut into a few chunks per thread so a slow thread does not hold up the rest,
+    //each chunk __parallel_grain elements at least
+    enum {__parallel_threshold = 1 << 15, __parallel_grain = 1 << 13, __parallel_max_chunks = 256};
+
+    inline size_t __parallel_chunks(const thread_pool& pool, size_t n, size_t per_thread = 4) {
+        if (n < __parallel_threshold || pool.concurrency() == 1)    return 1;
+        size_t chunks = pool.concurrency() * per_thread;
+        if (chunks > n / __parallel_grain)  chunks = n / __parallel_grain;
+        if (chunks > __parallel_max_chunks) chunks = __parallel_max_chunks;
+        return chunks;
+    }
+
+    //where chunk i of n elements starts, the first n % chunks chunks get one more
+    inline size_t __chunk_begin(size_t n, size_t chunks, size_t i) {
+        return i * (n / chunks) + (i < n % chunks ? i : n % chunks);
+    }
+
+    //fn(i, begin, end) for the chunks of [0, n)
+    template <typename _Fn>
+    inline void __parallel_for_chunks(thread_pool& pool, size_t n, size_t chunks, _Fn fn) {
+        my_stl::parallel_for(pool, size_t(0), chunks, 1, [n, chunks, &fn](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                fn(i, my_stl::__chunk_begin(n, chunks, i), my_stl::__chunk_begin(n, chunks, i + 1));
+            }
+        });
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------parallel algorithms-----------------------
+    //-----------------------------------------------------------------------
+    //the versions on a given pool, the policy overloads below use the shared one
+    template <typename _RandomIter, typename _Tp>
+    void __parallel_fill(thread_pool& pool, _RandomIter first, _RandomIter last, const _Tp& value) {
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1) {
+            my_stl::fill(first, last, value);
+            return;
+        }
+        my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t, size_t b, size_t e) {
+            my_stl::fill(first + b, first + e, value);
+        });
+    }
+
+    template <typename _RandomIter1, typename _RandomIter2>
+    _RandomIter2 __parallel_copy(thread_pool& pool, _RandomIter1 first, _RandomIter1 last,
+            _RandomIter2 result) {
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1)    return my_stl::copy(first, last, result);
+        my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t, size_t b, size_t e) {
+            my_stl::copy(first + b, first + e, result + b);
+        });
+        return result + n;
+    }
+
+    template <typename _RandomIter, typename _Function>
+    void __parallel_for_each(thread_pool& pool, _RandomIter first, _RandomIter last, _Function& fn) {
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1) {
+            for (; first != last; ++first) {
+                fn(*first);
+            }
+            return;
+        }
+        my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t, size_t b, size_t e) {
+            for (_RandomIter i = first + b; i != first + e; ++i) {
+                fn(*i);
+            }
+        });
+    }
+
+    template <typename _RandomIter1, typename _RandomIter2, typename _UnaryOp>
+    _RandomIter2 __parallel_transform(thread_pool& pool, _RandomIter1 first, _RandomIter1 last,
+            _RandomIter2 result, _UnaryOp& op) {
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1)    return my_stl::transform(first, last, result, op);
+        my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t, size_t b, size_t e) {
+            my_stl::transform(first + b, first + e, result + b, op);
+        });
+        return result + n;
+    }
+
+    template <typename _RandomIter1, typename _RandomIter2, typename _RandomIter3, typename _BinaryOp>
+    _RandomIter3 __parallel_transform(thread_pool& pool, _RandomIter1 first1, _RandomIter1 last1,
+            _RandomIter2 first2, _RandomIter3 result, _BinaryOp& op) {
+        const size_t n = last1 - first1;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1)    return my_stl::transform(first1, last1, first2, result, op);
+        my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t, size_t b, size_t e) {
+            my_stl::transform(first1 + b, first1 + e, first2 + b, result + b, op);
+        });
+        return result + n;
+    }
+
+    //every chunk is folded on its own, starting from its first two elements, and the
+    //partial results are folded into init in order
+    template <typename _RandomIter, typename _Tp, typename _BinaryOp>
+    _Tp __parallel_reduce(thread_pool& pool, _RandomIter first, _RandomIter last, _Tp init,
+            _BinaryOp& op) {
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1)    return my_stl::reduce(first, last, std::move(init), op);
+        _Tp seed(init);
+        __temporary_buffer<_Tp> partials(&seed, chunks);
+        _Tp* res = partials.begin();
+        if (!res)   return my_stl::reduce(first, last, std::move(init), op);
+        my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t i, size_t b, size_t e) {
+            _Tp acc = op(*(first + b), *(first + (b + 1)));
+            res[i] = my_stl::reduce(first + (b + 2), first + e, std::move(acc), op);
+        });
+        return my_stl::reduce(res, res + chunks, std::move(init), op);
+    }
+
+    //one chunk per thread is sorted by sort, then neighbouring runs are merged in rounds,
+    //the merges of a round in parallel (the last one is a single merge of the whole range).
+    //Every merge has its own part of a buffer of n elements, without the memory for it the
+    //merges are done in place by rotations
+    template <typename _RandomIter, typename _Comp>
+    void __parallel_sort(thread_pool& pool, _RandomIter first, _RandomIter last, _Comp& comp) {
+        typedef typename iterator_traits<_RandomIter>::value_type _Tp;
+        typedef typename iterator_traits<_RandomIter>::difference_type _Distance;
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n, 1);
+        if (chunks == 1) {
+            my_stl::sort(first, last, comp);
+            return;
+        }
+        my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t, size_t b, size_t e) {
+            _Comp c(comp);
+            my_stl::sort(first + b, first + e, c);
+        });
+        __temporary_buffer<_Tp> buf(first, n);
+        for (size_t width = 1; width < chunks; width *= 2) {
+            auto merge = [&](size_t pair) {
+                const size_t lo = pair * 2 * width;
+                const size_t hi = lo + 2 * width < chunks ? lo + 2 * width : chunks;
+                const size_t b = my_stl::__chunk_begin(n, chunks, lo);
+                const size_t m = my_stl::__chunk_begin(n, chunks, lo + width);
+                const size_t e = my_stl::__chunk_begin(n, chunks, hi);
+                _Comp c(comp);
+                if (!c(*(first + m), *(first + (m - 1))))   return;
+                if (buf.begin()) {
+                    my_stl::__merge_with_buffer(first + b, first + m, first + e, buf.begin() + b, c);
+                }
+                else {
+                    my_stl::__merge_without_buffer(first + b, first + m, first + e,
+                            _Distance(m - b), _Distance(e - m), c);
+                }
+            };
+            //the runs past the last pair are left as they are
+            const size_t pairs = (chunks - width + 2 * width - 1) / (2 * width);
+            my_stl::parallel_for(pool, size_t(0), pairs, 1, [&merge](size_t lo, size_t hi) {
+                for (size_t pair = lo; pair < hi; ++pair) {
+                    merge(pair);
+                }
+            });
+        }
+    }
+
+    //a chunk which throws destroys what it built, the chunks which finished are destroyed here
+    template <typename _RandomIter1, typename _RandomIter2>
+    _RandomIter2 __parallel_uninitialized_copy(thread_pool& pool, _RandomIter1 first,
+            _RandomIter1 last, _RandomIter2 result) {
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1)    return my_stl::uninitialized_copy(first, last, result);
+        char done[__parallel_max_chunks] = {};
+        try {
+            my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t i, size_t b, size_t e) {
+                my_stl::uninitialized_copy(first + b, first + e, result + b);
+                done[i] = 1;
+            });
+        }
+        catch (...) {
+            for (size_t i = 0; i < chunks; ++i) {
+                if (done[i]) {
+                    destroy(result + my_stl::__chunk_begin(n, chunks, i),
+                            result + my_stl::__chunk_begin(n, chunks, i + 1));
+                }
+            }
+            throw;
+        }
+        return result + n;
+    }
+
+    template <typename _RandomIter, typename _Tp>
+    void __parallel_uninitialized_fill(thread_pool& pool, _RandomIter first, _RandomIter last,
+            const _Tp& value) {
+        const size_t n = last - first;
+        const size_t chunks = my_stl::__parallel_chunks(pool, n);
+        if (chunks == 1) {
+            my_stl::uninitialized_fill(first, last, value);
+            return;
+        }
+        char done[__parallel_max_chunks] = {};
+        try {
+            my_stl::__parallel_for_chunks(pool, n, chunks, [&](size_t i, size_t b, size_t e) {
+                my_stl::uninitialized_fill(first + b, first + e, value);
+                done[i] = 1;
+            });
+        }
+        catch (...) {
+            for (size_t i = 0; i < chunks; ++i) {
+                if (done[i]) {
+                    destroy(first + my_stl::__chunk_begin(n, chunks, i),
+                            first + my_stl::__chunk_begin(n, chunks, i + 1));
+                }
+            }
+            throw;
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------policy overloads--------------------------
+    //-----------------------------------------------------------------------
+    //__true_type: split over the shared pool, __false_type: the serial algorithm
+    template <typename _ForwardIter, typename _Tp>
+    inline void __policy_fill(_ForwardIter first, _ForwardIter last, const _Tp& value, __true_type) {
+        my_stl::__parallel_fill(thread_pool::instance(), first, last, value);
+    }
+
+    template <typename _ForwardIter, typename _Tp>
+    inline void __policy_fill(_ForwardIter first, _ForwardIter last, const _Tp& value, __false_type) {
+        my_stl::fill(first, last, value);
+    }
+
+    template <typename _Policy, typename _ForwardIter, typename _Tp>
+    inline typename __enable_if_execution_policy<_Policy, void>::type
+    fill(_Policy&&, _ForwardIter first, _ForwardIter last, const _Tp& value) {
+        my_stl::__policy_fill(first, last, value, typename __use_parallel<_Policy, _ForwardIter>::type());
+    }
+
+    template <typename _InputIter, typename _OutputIter>
+    inline _OutputIter __policy_copy(_InputIter first, _InputIter last, _OutputIter result, __true_type) {
+        return my_stl::__parallel_copy(thread_pool::instance(), first, last, result);
+    }
+
+    template <typename _InputIter, typename _OutputIter>
+    inline _OutputIter __policy_copy(_InputIter first, _InputIter last, _OutputIter result, __false_type) {
+        return my_stl::copy(first, last, result);
+    }
+
+    template <typename _Policy, typename _InputIter, typename _OutputIter>
+    inline typename __enable_if_execution_policy<_Policy, _OutputIter>::type
+    copy(_Policy&&, _InputIter first, _InputIter last, _OutputIter result) {
+        return my_stl::__policy_copy(first, last, result,
+                typename __use_parallel<_Policy, _InputIter, _OutputIter>::type());
+    }
+
+    template <typename _InputIter, typename _Function>
+    inline void __policy_for_each(_InputIter first, _InputIter last, _Function& fn, __true_type) {
+        my_stl::__parallel_for_each(thread_pool::instance(), first, last, fn);
+    }
+
+    template <typename _InputIter, typename _Function>
+    inline void __policy_for_each(_InputIter first, _InputIter last, _Function& fn, __false_type) {
+        for (; first != last; ++first) {
+            fn(*first);
+        }
+    }
+
+    //fn may be called from several threads at once
+    template <typename _Policy, typename _InputIter, typename _Function>
+    inline typename __enable_if_execution_policy<_Policy, void>::type
+    for_each(_Policy&&, _InputIter first, _InputIter last, _Function fn) {
+        my_stl::__policy_for_each(first, last, fn, typename __use_parallel<_Policy, _InputIter>::type());
+    }
+
+    template <typename _InputIter, typename _OutputIter, typename _UnaryOp>
+    inline _OutputIter __policy_transform(_InputIter first, _InputIter last, _OutputIter result,
+            _UnaryOp& op, __true_type) {
+        return my_stl::__parallel_transform(thread_pool::instance(), first, last, result, op);
+    }
+
+    template <typename _InputIter, typename _OutputIter, typename _UnaryOp>
+    inline _OutputIter __policy_transform(_InputIter first, _InputIter last, _OutputIter result,
+            _UnaryOp& op, __false_type) {
+        return my_stl::transform(first, last, result, op);
+    }
+
+    template <typename _Policy, typename _InputIter, typename _OutputIter, typename _UnaryOp>
+    inline typename __enable_if_execution_policy<_Policy, _OutputIter>::type
+    transform(_Policy&&, _InputIter first, _InputIter last, _OutputIter result, _UnaryOp op) {
+        return my_stl::__policy_transform(first, last, result, op,
+                typename __use_parallel<_Policy, _InputIter, _OutputIter>::type());
+    }
+
+    template <typename _InputIter1, typename _InputIter2, typename _OutputIter, typename _BinaryOp>
+    inline _OutputIter __policy_transform(_InputIter1 first1, _InputIter1 last1, _InputIter2 first2,
+            _OutputIter result, _BinaryOp& op, __true_type) {
+        return my_stl::__parallel_transform(thread_pool::instance(), first1, last1, first2, result, op);
+    }
+
+    template <typename _InputIter1, typename _InputIter2, typename _OutputIter, typename _BinaryOp>
+    inline _OutputIter __policy_transform(_InputIter1 first1, _InputIter1 last1, _InputIter2 first2,
+            _OutputIter result, _BinaryOp& op, __false_type) {
+        return my_stl::transform(first1, last1, first2, result, op);
+    }
+
+    template <typename _Policy, typename _InputIter1, typename _InputIter2, typename _OutputIter,
+             typename _BinaryOp>
+    inline typename __enable_if_execution_policy<_Policy, _OutputIter>::type
+    transform(_Policy&&, _InputIter1 first1, _InputIter1 last1, _InputIter2 first2, _OutputIter result,
+            _BinaryOp op) {
+        return my_stl::__policy_transform(first1, last1, first2, result, op,
+                typename __use_parallel<_Policy, _InputIter1, _InputIter2, _OutputIter>::type());
+    }
+
+    template <typename _InputIter, typename _Tp, typename _BinaryOp>
+    inline _Tp __policy_reduce(_InputIter first, _InputIter last, _Tp& init, _BinaryOp& op, __true_type) {
+        return my_stl::__parallel_reduce(thread_pool::instance(), first, last, std::move(init), op);
+    }
+
+    template <typename _InputIter, typename _Tp, typename _BinaryOp>
+    inline _Tp __policy_reduce(_InputIter first, _InputIter last, _Tp& init, _BinaryOp& op, __false_type) {
+        return my_stl::reduce(first, last, std::move(init), op);
+    }
+
+    //op has to be associative and commutative, the grouping depends on the number of threads
+    template <typename _Policy, typename _InputIter, typename _Tp, typename _BinaryOp>
+    inline typename __enable_if_execution_policy<_Policy, _Tp>::type
+    reduce(_Policy&&, _InputIter first, _InputIter last, _Tp init, _BinaryOp op) {
+        return my_stl::__policy_reduce(first, last, init, op, typename __use_parallel<_Policy, _InputIter>::type());
+    }
+
+    template <typename _Policy, typename _InputIter, typename _Tp>
+    inline typename __enable_if_execution_policy<_Policy, _Tp>::type
+    reduce(_Policy&& policy, _InputIter first, _InputIter last, _Tp init) {
+        return my_stl::reduce(policy, first, last, std::move(init), plus<_Tp>());
+    }
+
+    template <typename _Policy, typename _InputIter>
+    inline typename __enable_if_execution_policy<_Policy, typename iterator_traits<_InputIter>::value_type>::type
+    reduce(_Policy&& policy, _InputIter first, _InputIter last) {
+        typedef typename iterator_traits<_InputIter>::value_type _Tp;
+        return my_stl::reduce(policy, first, last, _Tp(), plus<_Tp>());
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline void __policy_sort(_RandomIter first, _RandomIter last, _Comp& comp, __true_type) {
+        my_stl::__parallel_sort(thread_pool::instance(), first, last, comp);
+    }
+
+    template <typename _RandomIter, typename _Comp>
+    inline void __policy_sort(_RandomIter first, _RandomIter last, _Comp& comp, __false_type) {
+        my_stl::sort(first, last, comp);
+    }
+
+    template <typename _Policy, typename _RandomIter, typename _Comp>
+    inline typename __enable_if_execution_policy<_Policy, void>::type
+    sort(_Policy&&, _RandomIter first, _RandomIter last, _Comp comp) {
+        my_stl::__policy_sort(first, last, comp, typename __use_parallel<_Policy, _RandomIter>::type());
+    }
+
+    template <typename _Policy, typename _RandomIter>
+    inline typename __enable_if_execution_policy<_Policy, void>::type
+    sort(_Policy&& policy, _RandomIter first, _RandomIter last) {
+        my_stl::sort(policy, first, last, less<typename iterator_traits<_RandomIter>::value_type>());
+    }
+
+    template <typename _InputIter, typename _ForwardIter>
+    inline _ForwardIter __policy_uninitialized_copy(_InputIter first, _InputIter last, _ForwardIter result,
+            __true_type) {
+        return my_stl::__parallel_uninitialized_copy(thread_pool::instance(), first, last, result);
+    }
+
+    template <typename _InputIter, typename _ForwardIter>
+    inline _ForwardIter __policy_uninitialized_copy(_InputIter first, _InputIter last, _ForwardIter result,
+            __false_type) {
+        return my_stl::uninitialized_copy(first, last, result);
+    }
+
+    template <typename _Policy, typename _InputIter, typename _ForwardIter>
+    inline typename __enable_if_execution_policy<_Policy, _ForwardIter>::type
+    uninitialized_copy(_Policy&&, _InputIter first, _InputIter last, _ForwardIter result) {
+        return my_stl::__policy_uninitialized_copy(first, last, result,
+                typename __use_parallel<_Policy, _InputIter, _ForwardIter>::type());
+    }
+
+    template <typename _ForwardIter, typename _Tp>
+    inline void __policy_uninitialized_fill(_ForwardIter first, _ForwardIter last, const _Tp& value,
+            __true_type) {
+        my_stl::__parallel_uninitialized_fill(thread_pool::instance(), first, last, value);
+    }
+
+    template <typename _ForwardIter, typename _Tp>
+    inline void __policy_uninitialized_fill(_ForwardIter first, _ForwardIter last, const _Tp& value,
+            __false_type) {
+        my_stl::uninitialized_fill(first, last, value);
+    }
+
+    template <typename _Policy, typename _ForwardIter, typename _Tp>
+    inline typename __enable_if_execution_policy<_Policy, void>::type
+    uninitialized_fill(_Policy&&, _ForwardIter first, _ForwardIter last, const _Tp& value) {
+        my_stl::__policy_uninitialized_fill(first, last, value,
+                typename __use_parallel<_Policy, _ForwardIter>::type());
+    }
+}
+
+#endif
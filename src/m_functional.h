@@ -17,5 +17,13 @@ namespace my_stl {
             return _x1 > _x2;
         }
     };
+
+
+    template<typename _Tp>
+    struct plus {
+        _Tp operator()(const _Tp& _x1, const _Tp& _x2) const {
+            return _x1 + _x2;
+        }
+    };
 }
 #endif
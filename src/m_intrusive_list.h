@@ -0,0 +1,479 @@
+//An intrusive doubly linked list, the links live in the objects themselves
+#ifndef __MY_STL_INTRUSIVE_LIST_H
+#define __MY_STL_INTRUSIVE_LIST_H
+
+#include "m_list.h"           //for the node linking helpers, merge and sort
+#include <cstddef>            //for std::ptrdiff_t
+
+
+namespace my_stl {
+
+    //the links an object needs to be put in an intrusive_list, as a member:
+    //  struct timer {
+    //      int deadline;
+    //      intrusive_list_hook hook;
+    //  };
+    //  intrusive_list<timer, &timer::hook> timers;
+    //an object can be in as many lists at a time as it has hooks
+    struct intrusive_list_hook {
+        intrusive_list_hook *prev;
+        intrusive_list_hook *next;
+
+        intrusive_list_hook() noexcept: prev(nullptr), next(nullptr) {}
+        //a copy of an object is not in the lists the object is in
+        intrusive_list_hook(const intrusive_list_hook&) noexcept: prev(nullptr), next(nullptr) {}
+        intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept {return *this;}
+
+        bool is_linked() const noexcept {
+            return next != nullptr;
+        }
+    };
+
+    //from the hook to the object holding it and back
+    template <typename _Tp, intrusive_list_hook _Tp::* Hook>
+    struct __intrusive_hook_traits {
+        //the offset of the hook in _Tp, as offsetof does, on a block of storage no _Tp
+        //is ever built in
+        alignas(_Tp) static unsigned char __storage[sizeof(_Tp)];
+
+        static std::ptrdiff_t offset() noexcept {
+            const _Tp* obj = reinterpret_cast<const _Tp*>(__storage);
+            return reinterpret_cast<const unsigned char*>(&(obj ->* Hook)) - __storage;
+        }
+
+        static _Tp* object(intrusive_list_hook* __h) noexcept {
+            return reinterpret_cast<_Tp*>(reinterpret_cast<unsigned char*>(__h) - offset());
+        }
+
+        static intrusive_list_hook* hook(_Tp& obj) noexcept {
+            return &(obj.*Hook);
+        }
+    };
+
+    template <typename _Tp, intrusive_list_hook _Tp::* Hook>
+    alignas(_Tp) unsigned char __intrusive_hook_traits<_Tp, Hook>::__storage[sizeof(_Tp)];
+
+
+    //as for list, both const iterator and iterator derive from the base
+    template <typename _Tp, intrusive_list_hook _Tp::* Hook>
+    struct __intrusive_list_iterator_base {
+        using value_type = _Tp;
+        using iterator_category = bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using __traits = __intrusive_hook_traits<_Tp, Hook>;
+
+        intrusive_list_hook* node_ptr;
+        explicit __intrusive_list_iterator_base(intrusive_list_hook* __node_ptr): node_ptr(__node_ptr) {}
+        __intrusive_list_iterator_base(): node_ptr(nullptr) {}
+
+        bool operator==(const __intrusive_list_iterator_base& __other) const {
+            return node_ptr == __other.node_ptr;
+        }
+
+        bool operator!=(const __intrusive_list_iterator_base& __other) const {
+            return node_ptr != __other.node_ptr;
+        }
+    };
+
+    template <typename _Tp, intrusive_list_hook _Tp::* Hook>
+    struct __intrusive_list_iterator: public __intrusive_list_iterator_base<_Tp, Hook> {
+        using pointer = _Tp*;
+        using reference = _Tp&;
+        using __iterator_base = __intrusive_list_iterator_base<_Tp, Hook>;
+
+        explicit __intrusive_list_iterator(intrusive_list_hook* __node_ptr): __iterator_base(__node_ptr) {}
+        __intrusive_list_iterator(): __iterator_base() {}
+
+        reference operator*() const {
+            return *__iterator_base::__traits::object(this -> node_ptr);
+        }
+
+        pointer operator->() const {
+            return __iterator_base::__traits::object(this -> node_ptr);
+        }
+
+        __intrusive_list_iterator& operator++() {
+            this -> node_ptr = this -> node_ptr -> next;
+            return *this;
+        }
+
+        __intrusive_list_iterator operator++(int) {
+            __intrusive_list_iterator _temp(*this);
+            this -> node_ptr = this -> node_ptr -> next;
+            return _temp;
+        }
+
+        __intrusive_list_iterator& operator--() {
+            this -> node_ptr = this -> node_ptr -> prev;
+            return *this;
+        }
+
+        __intrusive_list_iterator operator--(int) {
+            __intrusive_list_iterator _temp(*this);
+            this -> node_ptr = this -> node_ptr -> prev;
+            return _temp;
+        }
+    };
+
+    template <typename _Tp, intrusive_list_hook _Tp::* Hook>
+    struct __intrusive_list_const_iterator: public __intrusive_list_iterator_base<_Tp, Hook> {
+        using pointer = const _Tp*;
+        using reference = const _Tp&;
+        using __iterator_base = __intrusive_list_iterator_base<_Tp, Hook>;
+
+        explicit __intrusive_list_const_iterator(intrusive_list_hook* __node_ptr): __iterator_base(__node_ptr) {}
+        __intrusive_list_const_iterator(): __iterator_base() {}
+
+        //implicit conversion from plain iterator
+        __intrusive_list_const_iterator(const __intrusive_list_iterator<_Tp, Hook>& other):
+            __iterator_base(other.node_ptr) {}
+
+        reference operator*() const {
+            return *__iterator_base::__traits::object(this -> node_ptr);
+        }
+
+        pointer operator->() const {
+            return __iterator_base::__traits::object(this -> node_ptr);
+        }
+
+        __intrusive_list_const_iterator& operator++() {
+            this -> node_ptr = this -> node_ptr -> next;
+            return *this;
+        }
+
+        __intrusive_list_const_iterator operator++(int) {
+            __intrusive_list_const_iterator _temp(*this);
+            this -> node_ptr = this -> node_ptr -> next;
+            return _temp;
+        }
+
+        __intrusive_list_const_iterator& operator--() {
+            this -> node_ptr = this -> node_ptr -> prev;
+            return *this;
+        }
+
+        __intrusive_list_const_iterator operator--(int) {
+            __intrusive_list_const_iterator _temp(*this);
+            this -> node_ptr = this -> node_ptr -> prev;
+            return _temp;
+        }
+    };
+
+    //a list of objects the list does not own, linked through their hook member, nothing is
+    //ever allocated: insert, erase and splice only set pointers. An object has to stay
+    //alive (and in place) while it is in a list. Taking an object out (erase, pop, clear,
+    //or the list going away) unlinks its hook, so is_linked tells whether it is in a list.
+    //the end node is a hook inside the list object, so moving a list has to fix up the
+    //first and the last element
+    template <typename _Tp, intrusive_list_hook _Tp::* Hook>
+    class intrusive_list {
+        public:
+            using iterator = __intrusive_list_iterator<_Tp, Hook>;
+            using const_iterator = __intrusive_list_const_iterator<_Tp, Hook>;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using value_type = _Tp;
+            using pointer = _Tp*;
+            using const_pointer = const _Tp*;
+            using reference = _Tp&;
+            using const_reference = const _Tp&;
+
+            using reverse_iterator = my_stl::reverse_iterator<iterator>;
+            using const_reverse_iterator = my_stl::reverse_iterator<const_iterator>;
+
+        protected:
+            using __node_ptr = intrusive_list_hook*;
+            using __traits = __intrusive_hook_traits<_Tp, Hook>;
+
+            intrusive_list_hook __end;
+            size_type __size;
+
+            void __reset() noexcept {
+                __end.prev = __end.next = &__end;
+                __size = 0;
+            }
+
+            //take all the elements of x, we have to be empty
+            void __steal(intrusive_list& x) noexcept {
+                if (x.empty())  return;
+                __node_ptr first = x.__end.next;
+                __node_ptr last = x.__end.prev;
+                size_type n = x.__size;
+                x.__reset();
+                __link_nodes(&__end, first, last);
+                __size = n;
+            }
+
+            static void __unhook(__node_ptr p) noexcept {
+                p -> prev = p -> next = nullptr;
+            }
+
+        public:
+            //------------------------Constructors------------------------------
+            intrusive_list() noexcept {
+                __reset();
+            }
+
+            intrusive_list(const intrusive_list&) = delete;
+            intrusive_list& operator=(const intrusive_list&) = delete;
+
+            intrusive_list(intrusive_list&& x) noexcept {
+                __reset();
+                splice(cend(), x);
+            }
+
+            intrusive_list& operator=(intrusive_list&& x) noexcept {
+                if (this != &x) {
+                    clear();
+                    splice(cend(), x);
+                }
+                return *this;
+            }
+
+            ~intrusive_list() {
+                clear();
+            }
+
+            //--------------------------------iterators----------------------------------//
+            iterator begin() noexcept {
+                return iterator(__end.next);
+            }
+
+            const_iterator begin() const noexcept {
+                return const_iterator(__end.next);
+            }
+
+            iterator end() noexcept {
+                return iterator(&__end);
+            }
+
+            const_iterator end() const noexcept {
+                return const_iterator(const_cast<__node_ptr>(&__end));
+            }
+
+            const_iterator cbegin() const noexcept {
+                return begin();
+            }
+
+            const_iterator cend() const noexcept {
+                return end();
+            }
+
+            reverse_iterator rbegin() noexcept {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const noexcept {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() noexcept {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const noexcept {
+                return const_reverse_iterator(begin());
+            }
+
+            const_reverse_iterator crbegin() const noexcept {
+                return rbegin();
+            }
+
+            const_reverse_iterator crend() const noexcept {
+                return rend();
+            }
+
+            //the iterator to an object in the list, O(1)
+            iterator iterator_to(reference obj) noexcept {
+                return iterator(__traits::hook(obj));
+            }
+
+            const_iterator iterator_to(const_reference obj) const noexcept {
+                return const_iterator(__traits::hook(const_cast<reference>(obj)));
+            }
+
+            //------------------------------element access------------------------------------
+            reference front() {
+                return *begin();
+            }
+
+            const_reference front() const {
+                return *cbegin();
+            }
+
+            reference back() {
+                return *__traits::object(__end.prev);
+            }
+
+            const_reference back() const {
+                return *__traits::object(__end.prev);
+            }
+
+            bool empty() const noexcept {
+                return __end.next == &__end;
+            }
+
+            size_type size() const noexcept {
+                return __size;
+            }
+
+            size_type max_size() const noexcept {
+                return size_type(-1);
+            }
+
+            void swap(intrusive_list& other) noexcept {
+                intrusive_list temp;
+                temp.__steal(other);
+                other.__steal(*this);
+                __steal(temp);
+            }
+
+            //unlink all the elements, O(n) since every hook is reset
+            void clear() noexcept {
+                __node_ptr p = __end.next;
+                while (p != &__end) {
+                    __node_ptr next = p -> next;
+                    __unhook(p);
+                    p = next;
+                }
+                __reset();
+            }
+
+            //-------------------------Insert and erase --------------------------------------
+            //put obj in front of __position, obj must not be in a list through this hook
+            iterator insert(const_iterator __position, reference obj) noexcept {
+                __node_ptr p = __traits::hook(obj);
+                __link_nodes(__position.node_ptr, p, p);
+                ++__size;
+                return iterator(p);
+            }
+
+            template <typename InputIterator>
+            void insert(const_iterator __position, InputIterator first, InputIterator last) {
+                for (; first != last; ++first) {
+                    insert(__position, *first);
+                }
+            }
+
+            iterator erase(const_iterator __position) noexcept {
+                __node_ptr p = __position.node_ptr;
+                __node_ptr next = p -> next;
+                __unlink_nodes(p, p);
+                __unhook(p);
+                --__size;
+                return iterator(next);
+            }
+
+            iterator erase(const_iterator __first, const_iterator __last) noexcept {
+                while (__first != __last) {
+                    __first = erase(__first);
+                }
+                return iterator(__last.node_ptr);
+            }
+
+            void push_back(reference obj) noexcept {
+                insert(cend(), obj);
+            }
+
+            void push_front(reference obj) noexcept {
+                insert(cbegin(), obj);
+            }
+
+            void pop_back() noexcept {
+                erase(--cend());
+            }
+
+            void pop_front() noexcept {
+                erase(cbegin());
+            }
+
+            //-----------------------------Splice operation--------------------------
+            void splice(const_iterator __position, intrusive_list& __x) noexcept {
+                if (__x.empty())    return;
+                __node_ptr first = __x.__end.next;
+                __node_ptr last = __x.__end.prev;
+                __unlink_nodes(first, last);
+                __link_nodes(__position.node_ptr, first, last);
+                __size += __x.__size;
+                __x.__size = 0;
+            }
+
+            void splice(const_iterator __position, intrusive_list&& __x) noexcept {
+                splice(__position, __x);
+            }
+
+            void splice(const_iterator __position, intrusive_list& __x, const_iterator __i) noexcept {
+                //note the edge case, if __pos == __i, the unlinked nodes will never be linked back
+                __node_ptr p = __i.node_ptr;
+                if (__position.node_ptr != p && __position.node_ptr != p -> next) {
+                    __unlink_nodes(p, p);
+                    __link_nodes(__position.node_ptr, p, p);
+                    --__x.__size;
+                    ++__size;
+                }
+            }
+
+            void splice(const_iterator __position, intrusive_list&& __x, const_iterator __i) noexcept {
+                splice(__position, __x, __i);
+            }
+
+            //O(n) when the elements come from another list, they have to be counted
+            void splice(const_iterator __position, intrusive_list& __x,
+                    const_iterator __first, const_iterator __last) noexcept {
+                if (__first == __last)  return;
+                if (this != &__x) {
+                    size_type n = my_stl::distance(__first, __last);
+                    __x.__size -= n;
+                    __size += n;
+                }
+                if (__position != __last) {
+                    __transfer(__position.node_ptr, __first.node_ptr, __last.node_ptr);
+                }
+            }
+
+            void splice(const_iterator __position, intrusive_list&& __x,
+                    const_iterator __first, const_iterator __last) noexcept {
+                splice(__position, __x, __first, __last);
+            }
+
+            //-------------------------Merge and sort ------------------------------------
+            void merge(intrusive_list& x) {
+                merge(x, less<_Tp>());
+            }
+
+            template<typename _Comp>
+            void merge(intrusive_list& _x, _Comp comp) {
+                if (this == &_x)    return;
+                size_type _n = 0;
+                try {
+                    __merge_node_chains(&__end, &_x.__end, comp,
+                            [](__node_ptr __p) -> _Tp& {return *__traits::object(__p);}, _n);
+                }
+                catch (...) {
+                    __size += _n;
+                    _x.__size -= _n;
+                    throw;
+                }
+                __size += _x.__size;
+                _x.__size = 0;
+            }
+
+            void sort() {
+                sort(less<_Tp>());
+            }
+
+            //the natural merge sort of list, stable
+            template<typename _Comp>
+            void sort(_Comp comp) {
+                __sort_node_chain(&__end, __size, comp,
+                        [](__node_ptr __p) -> _Tp& {return *__traits::object(__p);});
+            }
+    };
+
+    template <typename _Tp, intrusive_list_hook _Tp::* Hook>
+    void swap(intrusive_list<_Tp, Hook>& lhs, intrusive_list<_Tp, Hook>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
@@ -4,6 +4,7 @@
 #define __MY_STL_LIST_H
 
 #include "m_memory.h"         //for allocator
+#include "m_unique_ptr.h"     //for compressed_pair
 #include "m_algorithm.h"        //for functors
 #include "m_iterator.h"       //for iterator type traits
 #include <cstddef>            //for std::ptrdiff_t
@@ -145,6 +146,361 @@ namespace my_stl {
         }
     };
 
+    //node level helpers, shared by the containers made of a circular doubly linked chain
+    //of nodes, _NodePtr only needs prev and next
+    //clang implementations
+    //link the node [first, last] in front of position
+    template <typename _NodePtr>
+    inline void __link_nodes(_NodePtr __position, _NodePtr first, _NodePtr last) noexcept {
+        __position -> prev -> next = first;
+        first -> prev = __position -> prev;
+        __position -> prev = last;
+        last -> next = __position;
+    }
+
+    template <typename _NodePtr>
+    inline void __unlink_nodes(_NodePtr first, _NodePtr last) noexcept {
+        //note we will unlink the nodes between [first, last]
+        first -> prev -> next = last -> next;
+        last -> next -> prev = first -> prev;
+    }
+
+    //helper function in sgi stl (clang use __link_node, __link_node_at_front)
+    //move [first, last) in front of position, position must not be in [first, last]
+    template <typename _NodePtr>
+    inline void __transfer(_NodePtr position, _NodePtr first, _NodePtr last) noexcept {
+        last -> prev -> next = position;
+        first -> prev -> next = last;
+        position -> prev -> next = first;
+        _NodePtr tmp = position -> prev;
+        position -> prev = last -> prev;
+        last -> prev = first -> prev;
+        first -> prev = tmp;
+    }
+
+    //merge the sorted chain of __end2 into the sorted chain of __end1 (both circular, with
+    //the end node as sentinel), __value_of gives the element of a node. __moved counts the
+    //nodes taken from the second chain before the comparison throws, all of them are
+    //taken if it does not
+    //llvm implementation is referred
+    template <typename _NodePtr, typename _Comp, typename _ValueOf>
+    void __merge_node_chains(_NodePtr __end1, _NodePtr __end2, _Comp comp,
+            _ValueOf __value_of, size_t& __moved) {
+        _NodePtr _f1 = __end1 -> next;
+        _NodePtr _f2 = __end2 -> next;
+        for (;_f1 != __end1 && _f2 != __end2;) {
+            if (comp(__value_of(_f2), __value_of(_f1))) {
+                //note that f2 is less than f1, we have to insert f2 into before f1
+                //if we unlink f2 and insert into f1, we might need to repeatedly set
+                //a lot of pointers, think about the case when all the subsequent nodes in
+                //f2 is less than f1
+                //What we want to do is unlink as many nodes as possible at once and link it
+                _NodePtr _temp = _f2 -> next;
+                size_t _n = 1;
+                for (; _temp != __end2 && comp(__value_of(_temp), __value_of(_f1)); _temp = _temp -> next) {
+                    ++_n;
+                }
+                _NodePtr _e2 = _temp -> prev;
+                __unlink_nodes(_f2, _e2);
+                __link_nodes(_f1, _f2, _e2);
+                __moved += _n;
+                _f2 = _temp;
+            }
+            _f1 = _f1 -> next;
+        }
+        //the rest of the second chain goes to the back
+        if (_f2 != __end2) {
+            _NodePtr _l2 = __end2 -> prev;
+            __unlink_nodes(_f2, _l2);
+            __link_nodes(__end1, _f2, _l2);
+        }
+    }
+
+    //-----------------------------sort of a node chain---------------------------------
+    //the sort of the list like containers, a natural merge sort working on the node
+    //pointers only, so nothing is allocated. As in timsort: the chain is cut into the runs
+    //already in order (a strictly descending run is reversed), a short run is extended to
+    //__min_run nodes by insertion, and the runs are merged on a stack keeping their lengths
+    //balanced. Two runs already in order are just linked, so a sorted (or reverse sorted)
+    //chain takes n comparisons. A merge links whole blocks of nodes, and once one side has
+    //won __min_gallop times in a row it gallops: the end of its block is found by
+    //exponential then binary search. That saves comparisons, the nodes are still walked.
+    //while sorting only next is kept up to date and every run ends with null, prev is set
+    //again at the end. The sort is stable. If the comparison throws, all the nodes are
+    //linked back in some order
+    //the parallel sort, in m_list_parallel.h, splits the chain and runs the sorters on it
+    template <typename _NodePtr, typename _Comp, typename _ValueOf>
+    struct __parallel_chain_sorter;
+
+    template <typename _NodePtr, typename _Comp, typename _ValueOf>
+    class __chain_sorter {
+        friend struct __parallel_chain_sorter<_NodePtr, _Comp, _ValueOf>;
+
+        private:
+            enum {__min_run = 16, __min_gallop = 7, __max_runs = 128};
+
+            struct __run {
+                _NodePtr head;
+                _NodePtr tail;
+                size_t len;
+            };
+
+            _Comp& comp;
+            _ValueOf& __value_of;
+            //the invariants of __merge_collapse keep the stack O(log n) deep
+            __run __runs[__max_runs];
+            size_t __n_runs;
+            _NodePtr __rest;        //the nodes not in a run yet
+
+            __chain_sorter(_Comp& __c, _ValueOf& __v):
+                comp(__c), __value_of(__v), __n_runs(0), __rest(nullptr) {}
+
+            bool __less(_NodePtr a, _NodePtr b) {
+                return comp(__value_of(a), __value_of(b));
+            }
+
+            //the last node of the block from first on which pred holds (pred holds on a
+            //prefix of the run), null if it does not hold on first
+            template <typename _Pred>
+            static _NodePtr __gallop(_NodePtr first, _Pred pred) {
+                if (!pred(first))   return nullptr;
+                _NodePtr lo = first;
+                for (size_t step = 1; ; step *= 2) {
+                    _NodePtr hi = lo;
+                    size_t k = 0;
+                    for (; k < step && hi -> next; ++k) hi = hi -> next;
+                    if (k == 0) return lo;
+                    if (pred(hi)) {
+                        lo = hi;
+                        continue;
+                    }
+                    //pred holds on lo but not on hi, search the k - 1 nodes in between
+                    for (size_t n = k - 1; n > 0; ) {
+                        size_t half = (n + 1) / 2;
+                        _NodePtr mid = lo;
+                        for (size_t i = 0; i < half; ++i) mid = mid -> next;
+                        if (pred(mid)) {
+                            lo = mid;
+                            n -= half;
+                        }
+                        else {
+                            n = half - 1;
+                        }
+                    }
+                    return lo;
+                }
+            }
+
+            //take the next run off __rest, the run is on the stack while it grows
+            void __push_run() {
+                __run& r = __runs[__n_runs++];
+                r.head = r.tail = __rest;
+                r.len = 1;
+                __rest = __rest -> next;
+                r.tail -> next = nullptr;
+                if (__rest && __less(__rest, r.head)) {
+                    //strictly descending, reversed while it is taken
+                    do {
+                        _NodePtr p = __rest;
+                        __rest = p -> next;
+                        p -> next = r.head;
+                        r.head = p;
+                        ++r.len;
+                    } while (__rest && __less(__rest, r.head));
+                }
+                else if (__rest) {
+                    do {
+                        r.tail -> next = __rest;
+                        r.tail = __rest;
+                        __rest = __rest -> next;
+                        r.tail -> next = nullptr;
+                        ++r.len;
+                    } while (__rest && !__less(__rest, r.tail));
+                }
+                //too short, insert the following nodes
+                while (r.len < __min_run && __rest) {
+                    _NodePtr x = __rest;
+                    _NodePtr* link = &r.head;
+                    if (!__less(x, r.tail)) {
+                        link = &r.tail -> next;
+                        r.tail = x;
+                    }
+                    else {
+                        //after the nodes equal to x, to be stable
+                        while (!__less(x, *link))   link = &(*link) -> next;
+                    }
+                    __rest = x -> next;
+                    x -> next = *link;
+                    *link = x;
+                    ++r.len;
+                }
+            }
+
+            //remove run i + 1 from the stack
+            void __drop_next(size_t i) {
+                for (size_t j = i + 1; j + 1 < __n_runs; ++j) {
+                    __runs[j] = __runs[j + 1];
+                }
+                --__n_runs;
+            }
+
+            //merge the run B which follows A into A, if comp throws A still holds the
+            //nodes of both
+            void __merge_runs(__run& A, const __run& B) {
+                _NodePtr head = nullptr, tail = nullptr;
+                _NodePtr a = A.head, b = B.head;
+                size_t wins_a = 0, wins_b = 0;
+                //link [first, last] to the output
+                auto __append = [&](_NodePtr first, _NodePtr last) {
+                    if (tail)   tail -> next = first;
+                    else    head = first;
+                    tail = last;
+                };
+                try {
+                    if (!__less(B.head, A.tail)) {
+                        //already in order, the common case of a mostly sorted chain
+                        __append(a, A.tail);
+                        a = nullptr;
+                    }
+                    else if (__less(B.tail, A.head)) {
+                        //all of B goes first
+                        __append(b, B.tail);
+                        b = nullptr;
+                    }
+                    while (a && b) {
+                        if (__less(b, a)) {
+                            //the nodes of b go first only if they are less, to be stable
+                            _NodePtr last = b;
+                            if (++wins_b >= __min_gallop && b -> next) {
+                                last = __gallop(b, [&](_NodePtr x) {return __less(x, a);});
+                                wins_b = 0;
+                            }
+                            __append(b, last);
+                            b = last -> next;
+                            wins_a = 0;
+                        }
+                        else {
+                            _NodePtr last = a;
+                            if (++wins_a >= __min_gallop && a -> next) {
+                                last = __gallop(a, [&](_NodePtr x) {return !__less(b, x);});
+                                wins_a = 0;
+                            }
+                            __append(a, last);
+                            a = last -> next;
+                            wins_b = 0;
+                        }
+                    }
+                }
+                catch (...) {
+                    //keep every node in the run: the merged ones, then the rest of both
+                    if (a)  __append(a, A.tail);
+                    if (b)  __append(b, B.tail);
+                    tail -> next = nullptr;
+                    A = __run{head, tail, A.len + B.len};
+                    throw;
+                }
+                if (a)  __append(a, A.tail);
+                if (b)  __append(b, B.tail);
+                A = __run{head, tail, A.len + B.len};
+            }
+
+            //merge the runs i and i + 1
+            void __merge_at(size_t i) {
+                try {
+                    __merge_runs(__runs[i], __runs[i + 1]);
+                }
+                catch (...) {
+                    __drop_next(i);
+                    throw;
+                }
+                __drop_next(i);
+            }
+
+            //merge until the lengths on the stack shrink faster than fibonacci, this
+            //checks four runs as in the fixed timsort
+            void __merge_collapse() {
+                while (__n_runs > 1) {
+                    size_t k = __n_runs - 2;
+                    if ((k > 0 && __runs[k - 1].len <= __runs[k].len + __runs[k + 1].len) ||
+                        (k > 1 && __runs[k - 2].len <= __runs[k - 1].len + __runs[k].len)) {
+                        if (__runs[k - 1].len < __runs[k + 1].len)  --k;
+                    }
+                    else if (__runs[k].len > __runs[k + 1].len) {
+                        break;
+                    }
+                    __merge_at(k);
+                }
+            }
+
+            //link all the runs and the rest into one chain again
+            _NodePtr __collect() {
+                _NodePtr head = __rest;
+                for (size_t i = __n_runs; i-- > 0; ) {
+                    __runs[i].tail -> next = head;
+                    head = __runs[i].head;
+                }
+                return head;
+            }
+
+            //sort the null terminated chain of r, if comp throws r still holds all its nodes
+            void __sort_run(__run& r) {
+                __rest = r.head;
+                __n_runs = 0;
+                try {
+                    while (__rest) {
+                        __push_run();
+                        __merge_collapse();
+                    }
+                    while (__n_runs > 1) {
+                        size_t k = __n_runs - 2;
+                        if (k > 0 && __runs[k - 1].len < __runs[k + 1].len)  --k;
+                        __merge_at(k);
+                    }
+                }
+                catch (...) {
+                    r.head = __collect();
+                    for (r.tail = r.head; r.tail -> next; r.tail = r.tail -> next);
+                    throw;
+                }
+                r.head = __runs[0].head;
+                r.tail = __runs[0].tail;
+            }
+
+            //hang the null terminated chain from end again, setting prev
+            static void __relink(_NodePtr __end, _NodePtr head) {
+                _NodePtr prev = __end;
+                for (_NodePtr p = head; p; p = p -> next) {
+                    p -> prev = prev;
+                    prev = p;
+                }
+                __end -> next = head;
+                prev -> next = __end;
+                __end -> prev = prev;
+            }
+
+        public:
+            //sort the n nodes between the sentinel end and itself
+            static void sort(_NodePtr __end, size_t __n, _Comp comp, _ValueOf __value_of) {
+                if (__n < 2)    return;
+                __run r{__end -> next, __end -> prev, __n};
+                r.tail -> next = nullptr;
+                __chain_sorter __s(comp, __value_of);
+                try {
+                    __s.__sort_run(r);
+                }
+                catch (...) {
+                    __relink(__end, r.head);
+                    throw;
+                }
+                __relink(__end, r.head);
+            }
+    };
+
+    template <typename _NodePtr, typename _Comp, typename _ValueOf>
+    inline void __sort_node_chain(_NodePtr __end, size_t __n, _Comp comp, _ValueOf __value_of) {
+        __chain_sorter<_NodePtr, _Comp, _ValueOf>::sort(__end, __n, comp, __value_of);
+    }
+
     template <typename _Tp, typename Alloc = __malloc_alloc<0>>
     class list {
         public:
@@ -169,49 +525,31 @@ namespace my_stl {
             
 
             //the list is a doubly linked list, we only need to keep a node as end
-            __node_ptr __end;
+            //the allocator instance is stored with it, it takes no room when it is empty
+            compressed_pair<__node_ptr, Alloc> __end_and_alloc;
+            //number of elements, kept up to date by every operation linking or unlinking
+            //nodes so size() is O(1) as c++11 requires
+            size_type __size;
             using data_allocator = my_simple_alloc<__node, Alloc>;
 
-            __node* __get_node() const {
-                return data_allocator::allocate(1);
+            __node_ptr& __end() noexcept {return __end_and_alloc.first();}
+            __node_ptr __end() const noexcept {return __end_and_alloc.first();}
+            Alloc& __alloc() noexcept {return __end_and_alloc.second();}
+
+            __node* __get_node() {
+                return data_allocator::allocate(__alloc(), 1);
             }
 
 			void __destroy_node(__node *p) noexcept {
-				data_allocator::deallocate(p, 1);
+				data_allocator::deallocate(__alloc(), p, 1);
 			}
 
-			__node* __create_node(const value_type& val) const{
+			__node* __create_node(const value_type& val) {
 				__node* __a_node = __get_node();
 				construct(&__a_node->val, val);
 				return __a_node;
 			}
 
-            //clang implementations
-            //link the node [first, last] in front of position
-            void __link_nodes(__node_ptr __position, __node_ptr first, __node_ptr last) {
-                __position -> prev -> next = first;
-                first -> prev = __position -> prev;
-                __position -> prev = last;
-                last -> next = __position;
-            }
-
-            void __unlink_nodes(__node_ptr first, __node_ptr last) {
-                //note we will unlink the nodes between [first, last]
-                first -> prev -> next = last -> next;
-                last -> next -> prev = first -> prev;
-            }
-
-            //helper function in sgi stl (clang use __link_node, __link_node_at_front)
-            void __transfer(iterator position, iterator first, iterator last) {
-                last.node_ptr -> prev -> next = position.node_ptr;
-                first.node_ptr -> prev -> next = last.node_ptr;
-                position.node_ptr -> prev -> next = first.node_ptr;
-                auto tmp = position.node_ptr -> prev;
-                position.node_ptr -> prev = last.node_ptr -> prev;
-                last.node_ptr -> prev = first.node_ptr -> prev;
-                first.node_ptr -> prev = tmp;
-            }
-
             //insert dispatch declaration
             template <typename _Integer>
             iterator __insert_dispatch(const_iterator __position, _Integer i1, 
@@ -232,6 +570,9 @@ namespace my_stl {
             
             //------------------------Constructors------------------------------
             list();
+
+            //e.g. list<int, node_pool<>>(pool) puts the nodes into the given pool
+            explicit list(const Alloc& __a);
             
             explicit list(size_type n);
 
@@ -255,15 +596,15 @@ namespace my_stl {
 
             list& operator=(const list& x);
 
-            list& operator=(list&& x) noexcept;
+            list& operator=(list&& x) noexcept(__is_nothrow_joinable<Alloc>::value);
             
             //------------------------Destructors-------------------------------
 			~list() {
-                if (__end) {
+                if (__end()) {
                     clear();
                 //note we never initialize the value of __end -> val, so we never need to 
                 //call the destructor of __end -> val
-                    __destroy_node(__end);
+                    __destroy_node(__end());
                 }
 			}
 
@@ -271,19 +612,19 @@ namespace my_stl {
             
             //begin, end, front, back, size, maxsize
             iterator begin() noexcept{
-                return iterator(__end -> next);
+                return iterator(__end() -> next);
             }
 
             const_iterator begin() const noexcept{
-                return const_iterator(__end -> next);
+                return const_iterator(__end() -> next);
             }
 
             iterator end() noexcept {
-                return iterator(__end);
+                return iterator(__end());
             }
             
             const_iterator end() const noexcept{
-                return const_iterator(__end);
+                return const_iterator(__end());
             }
 
             //--------------------------------rbegin and rend---------------------------------//
@@ -305,11 +646,11 @@ namespace my_stl {
 
             //------------------------------cbegin and cend----------------------------------//
             const_iterator cbegin() const noexcept{
-                return const_iterator(__end -> next);
+                return const_iterator(__end() -> next);
             };
 
             const_iterator cend() const noexcept{
-                return const_iterator(__end);
+                return const_iterator(__end());
             }
 
             //------------------------------rcbegin and rcend---------------------------------//
@@ -344,23 +685,33 @@ namespace my_stl {
                 return size_type(-1);
             }
 
+            Alloc get_allocator() const {return __end_and_alloc.second();}
+
             void swap(list& other) noexcept {
-                __node_ptr temp = __end;
-                this -> __end = other.__end;
-                other.__end = temp;
+                //the allocators go with the nodes
+                __end_and_alloc.swap(other.__end_and_alloc);
+                size_type temp_size = __size;
+                this -> __size = other.__size;
+                other.__size = temp_size;
             }
 
 			void clear() noexcept {
-				__node_ptr __ptr = __end->next;
-				while (__ptr != __end) {
+				__node_ptr __ptr = __end()->next;
+				while (__ptr != __end()) {
 					__node_ptr temp = __ptr->next;
                     my_stl::destroy(&__ptr->val);
 					__destroy_node(__ptr);
 					__ptr = temp;
 				}
-                __end -> prev = __end -> next = __end;
+                __end() -> prev = __end() -> next = __end();
+                __size = 0;
 			}
 
+            //hand the memory kept for freed nodes back, only a node pool keeps any
+            void shrink_to_fit() noexcept {
+                __shrink_allocator(__alloc());
+            }
+
             //--------------------------------------------------------------------------------
             //-------------------------Assign operation --------------------------------------
             //--------------------------------------------------------------------------------
@@ -404,11 +755,11 @@ namespace my_stl {
 
             //empty and size
             bool empty() const {
-                return __end -> next == __end;
+                return __end() -> next == __end();
             }
 
             size_type size() const noexcept{
-                return my_stl::distance(cbegin(), cend());
+                return __size;
             }
 
             //push and pop
@@ -437,9 +788,9 @@ namespace my_stl {
             //-----------------------------Splice operation--------------------------
             //-----------------------------------------------------------------------
             //entire list
-            void splice(const_iterator __position, list& __other) noexcept;
+            void splice(const_iterator __position, list& __other) noexcept(__is_nothrow_joinable<Alloc>::value);
             
-            void splice(const_iterator __position, list&& __other) noexcept;
+            void splice(const_iterator __position, list&& __other) noexcept(__is_nothrow_joinable<Alloc>::value);
             
             //single element
             void splice(const_iterator __position, list& __other, const_iterator __i);
@@ -468,8 +819,17 @@ namespace my_stl {
 
             template<typename _Comp>
             void sort(_Comp comp);
+
+            //the same sort split over threads is my_stl::parallel_sort, in m_list_parallel.h
+            //to keep the thread pool out of here
+            template <typename _List> friend struct __list_parallel_sorter;
     };
 
+    //the nodes (including the end node) all live on the heap and never point back to the
+    //list object, so a list can be memcpy-ed to a new place
+    template <typename _Tp, typename Alloc>
+    struct is_trivially_relocatable<list<_Tp, Alloc>>: __is_relocatable_alloc<Alloc> {};
+
     //non member swap function, no throw
     template <typename _Tp, typename Alloc>
     void swap(list<_Tp, Alloc>& lhs, list<_Tp, Alloc>& rhs) noexcept{
@@ -480,8 +840,15 @@ namespace my_stl {
     //-----------------------------Constructors------------------------------
     //------------------------------------------------------------------------
     template<typename _Tp, typename Alloc>
-    list<_Tp, Alloc>::list(): __end(__get_node()) {
-        __end -> next = __end -> prev = __end;
+    list<_Tp, Alloc>::list(): __end_and_alloc(nullptr), __size(0) {
+        __end() = __get_node();
+        __end() -> next = __end() -> prev = __end();
+    }
+
+    template<typename _Tp, typename Alloc>
+    list<_Tp, Alloc>::list(const Alloc& __a): __end_and_alloc(nullptr, __a), __size(0) {
+        __end() = __get_node();
+        __end() -> next = __end() -> prev = __end();
     }
 
     template<typename _Tp, typename Alloc>
@@ -502,8 +869,10 @@ namespace my_stl {
     
     //move
     template<typename _Tp, typename Alloc>
-    list<_Tp, Alloc>::list (list&& x) noexcept: __end(x.__end) {
-        x.__end = nullptr;
+    list<_Tp, Alloc>::list (list&& x) noexcept: __end_and_alloc(x.__end(), x.__alloc()),
+            __size(x.__size) {
+        x.__end() = nullptr;
+        x.__size = 0;
     }
     
     //range
@@ -543,7 +912,7 @@ namespace my_stl {
         }
         else {
             //clear the rest
-            erase(iter, n);
+            erase(iter, cend());
         }
     }
 
@@ -601,8 +970,11 @@ namespace my_stl {
 
     //move assign
     template<typename _Tp, typename Alloc>
-    inline list<_Tp, Alloc>& list<_Tp, Alloc>::operator=(list&& _x) noexcept{
+    inline list<_Tp, Alloc>& list<_Tp, Alloc>::operator=(list&& _x)
+            noexcept(__is_nothrow_joinable<Alloc>::value) {
         if (this != &_x) {
+            //joined before anything is freed, if it throws we are left as we were
+            if (_x.size())  __join_allocators(__alloc(), _x.__alloc());
             clear();
             splice(end(), _x);
         }
@@ -623,6 +995,7 @@ namespace my_stl {
         __a_node -> prev = __position.node_ptr -> prev;
         __position.node_ptr -> prev -> next = __a_node;
         __position.node_ptr -> prev = __a_node;
+        ++__size;
         return iterator(__a_node);
     }
 
@@ -702,7 +1075,8 @@ namespace my_stl {
         //allocate a new node
         __node_ptr _a_node= __get_node();
         construct(&_a_node->val, std::forward<Args>(args)...);
-        __link_nodes(__end -> next, _a_node, _a_node);
+        __link_nodes(__end() -> next, _a_node, _a_node);
+        ++__size;
     }
 
     template<typename _Tp, typename Alloc>
@@ -711,7 +1085,8 @@ namespace my_stl {
         //allocate a new node
         __node_ptr _a_node= __get_node();
         construct(&_a_node->val, std::forward<Args>(args)...);
-        __link_nodes(__end, _a_node, _a_node);
+        __link_nodes(__end(), _a_node, _a_node);
+        ++__size;
     }
 
     //erase implementations
@@ -721,6 +1096,7 @@ namespace my_stl {
         __unlink_nodes(__position.node_ptr, __position.node_ptr);
         my_stl::destroy(&__position.node_ptr -> val);
         __destroy_node(__position.node_ptr);
+        --__size;
         return temp;
     }
     
@@ -734,6 +1110,7 @@ namespace my_stl {
                 ++__first;
                 my_stl::destroy (&__node_ptr -> val);
                 __destroy_node(__node_ptr);
+                --__size;
             }
         }
         return __list_iterator<_Tp>(__last.node_ptr);
@@ -755,7 +1132,7 @@ namespace my_stl {
         const_iterator head = begin();
         const_iterator tail = end();
         while (head != tail) {
-            iterator next = head;
+            const_iterator next = head;
             ++next;
             if (*head == value)    erase(head);
             head = next;
@@ -784,19 +1161,25 @@ namespace my_stl {
     //LLVM implementation is preferred
     //entire list
     template<typename _Tp, typename Alloc>
-    void list<_Tp, Alloc>::splice(const_iterator __pos, list& __x) noexcept{
+    void list<_Tp, Alloc>::splice(const_iterator __pos, list& __x)
+            noexcept(__is_nothrow_joinable<Alloc>::value) {
         if (!__x.empty()) {
+            //the nodes of __x will be freed by us from now on
+            __join_allocators(__alloc(), __x.__alloc());
             //unlink the old list
-            __node_ptr first = __x.__end -> next;
-            __node_ptr last = __x.__end -> prev;
+            __node_ptr first = __x.__end() -> next;
+            __node_ptr last = __x.__end() -> prev;
             __unlink_nodes(first, last);
             //link the new list
             __link_nodes(__pos.node_ptr, first, last);
+            __size += __x.__size;
+            __x.__size = 0;
         }
     }
 
     template<typename _Tp, typename Alloc>
-    void list<_Tp, Alloc>::splice(const_iterator __pos, list&& __x) noexcept{
+    void list<_Tp, Alloc>::splice(const_iterator __pos, list&& __x)
+            noexcept(__is_nothrow_joinable<Alloc>::value) {
         //just a delegate method
         splice(__pos, __x);
     }
@@ -806,9 +1189,13 @@ namespace my_stl {
     void list<_Tp, Alloc>::splice(const_iterator __pos, list& __x, const_iterator __i) {
         //note the edge case, if __pos == __i, the unlinked nodes will never be linked back
         if (__pos != __i && __pos.node_ptr != __i.node_ptr -> next) {
+            if (this != &__x) __join_allocators(__alloc(), __x.__alloc());
             __node_ptr shift_node = __i.node_ptr;
             __unlink_nodes(shift_node, shift_node);
             __link_nodes(__pos.node_ptr, shift_node, shift_node);
+            //no change if __x is ourself
+            --__x.__size;
+            ++__size;
         }
     }
 
@@ -823,6 +1210,14 @@ namespace my_stl {
     void list<_Tp, Alloc>::splice(const_iterator __pos, list& __x, const_iterator __first,
             const_iterator __last) {
         if (__first != __last) {
+            //the nodes have to be counted when they come from another list, which makes this
+            //the only O(n) splice
+            if (this != &__x) {
+                __join_allocators(__alloc(), __x.__alloc());
+                size_type n = my_stl::distance(__first, __last);
+                __x.__size -= n;
+                __size += n;
+            }
             __node_ptr start = __first.node_ptr;
             __node_ptr end = __last.node_ptr -> prev;
             __unlink_nodes(start, end);
@@ -850,31 +1245,21 @@ namespace my_stl {
     template<typename _Comp>
     void list<_Tp, Alloc>::merge(list& _x, _Comp comp) {
         //do not merge with ourself
-        //llvm implementation is referred
         if (this != &_x) {
-            __node_ptr _f1 = begin().node_ptr;
-            const __node_ptr _l1 = end().node_ptr;
-            __node_ptr _f2 = _x.begin().node_ptr;
-            const __node_ptr _l2 = _x.end().node_ptr;
-            for (;_f1 != _l1 && _f2 != _l2;) {
-                if (comp(_f2 -> val, _f1 -> val)) {
-                    //note that f2 is less than f1, we have to insert f2 into before f1
-                    //if we unlink f2 and insert into f1, we might need to repeatedly set
-                    //a lot of pointers, think about the case when all the subsequent nodes in
-                    //f2 is less than f1
-                    //What we want to do is unlink as many nodes as possible at once and link it
-                    __node_ptr _temp = _f2 -> next;
-                    for (; _temp != _l2 && comp(_temp -> val, _f1 -> val); _temp = _temp -> next);
-                    __node_ptr _e2 = _temp -> prev;
-                    __unlink_nodes(_f2, _e2);
-                    __link_nodes(_f1, _f2, _e2);
-                    _f2 = _temp;
-                }
-                _f1 = _f1 -> next;
+            __join_allocators(__alloc(), _x.__alloc());
+            size_type _n = 0;
+            try {
+                __merge_node_chains(__end(), _x.__end(), comp,
+                        [](__node_ptr __p) -> _Tp& {return __p -> val;}, _n);
+            }
+            catch (...) {
+                __size += _n;
+                _x.__size -= _n;
+                throw;
             }
-            splice (const_iterator(_l1), _x);
+            __size += _x.__size;
+            _x.__size = 0;
         }
-        
     }
 
     //-----------------------------------------------------------------------
@@ -888,34 +1273,7 @@ namespace my_stl {
     template<typename _Tp, typename Alloc>
     template<typename _Comp>
     void list<_Tp, Alloc>::sort(_Comp comp) {
-        //if size less than or equal 1, return
-        if (__end -> next -> next == __end) return;
-        //one of the most awesome algorithm in STL!
-        //using a iterative merge sort to sort the whole list, but it is sorted bottom up
-        //and technically we only need O(1) space to do the merge sort
-        //
-        list _carry;         //carry is the auxillary list that merge from bottom-up every iteration
-        list _counter[64];   //counter keeps the sorted list with counter[i].size() in [2^(i-1) 2^i)
-        int _fill = 0;       //fill keeps the highest filled list(largest size) idx - 1 in the counter
-        //so if there are still elements in the list, take one each time, merge up the ladder 
-        //if we see a empty slot, just stop there and put the carry list in
-        for (; !empty(); ) {
-            //take one element
-            _carry.splice(_carry.end(), *this, begin());
-            //move up the ladder
-            int _level = 0;
-            for (; _level < _fill && !_counter[_level].empty(); ) {
-                _carry.merge(_counter[_level++], comp);
-            }
-            //either we at the upmost level, or we see an empty slot
-            _carry.swap(_counter[_level]);
-            if (_level == _fill)    ++_fill;      //if the upmost level has been filled, move up one
-        }
-        //now carry the last merge, from the bottom all the way to the top
-        for (int _level = 1; _level < _fill; ++_level) {
-            _counter[_level].merge(_counter[_level - 1], comp);
-        }
-        swap(_counter[_fill - 1]);
+        __sort_node_chain(__end(), __size, comp, [](__node_ptr __p) -> _Tp& {return __p -> val;});
     }
 }
 
@@ -0,0 +1,118 @@
+//The parallel sort of list, kept apart from m_list.h so that only its users pull in the
+//thread pool (and with it <thread>, <mutex> and the rest)
+#ifndef __MY_STL_LIST_PARALLEL_H
+#define __MY_STL_LIST_PARALLEL_H
+
+#include "m_list.h"
+#include "m_thread_pool.h"
+#include <cstddef>            //for size_t
+#include <exception>          //for std::exception_ptr
+
+
+namespace my_stl {
+
+    //the chain is cut into one segment per thread, the segments are sorted at the same time
+    //on the shared thread_pool and then the neighbours are merged pairwise, a level of the
+    //merge tree at a time, the left one first to be stable. Only the segment ends are kept
+    //aside. Every task works with its own copy of comp
+    template <typename _NodePtr, typename _Comp, typename _ValueOf>
+    struct __parallel_chain_sorter {
+        using __sorter = __chain_sorter<_NodePtr, _Comp, _ValueOf>;
+        using __run = typename __sorter::__run;
+
+        //every thread gets this many nodes at least
+        enum {__min_segment = 1 << 14, __max_segments = 64};
+
+        static void sort(_NodePtr __end, size_t __n, _Comp comp, _ValueOf __value_of,
+                size_t __threads) {
+            if (__threads > __n / __min_segment)    __threads = __n / __min_segment;
+            if (__threads > __max_segments) __threads = __max_segments;
+            if (__threads < 2) {
+                __sorter::sort(__end, __n, comp, __value_of);
+                return;
+            }
+            __run segs[__max_segments];
+            std::exception_ptr errors[__max_segments];
+            _NodePtr p = __end -> next;
+            for (size_t i = 0; i < __threads; ++i) {
+                segs[i].head = p;
+                segs[i].len = __n / __threads + (i < __n % __threads);
+                for (size_t j = 1; j < segs[i].len; ++j) p = p -> next;
+                segs[i].tail = p;
+                p = p -> next;
+                segs[i].tail -> next = nullptr;
+            }
+            //sort segment i when width is 0, else merge segment i + width into it
+            auto __task = [&](size_t i, size_t width) {
+                try {
+                    _Comp __c(comp);
+                    _ValueOf __v(__value_of);
+                    __sorter __s(__c, __v);
+                    if (width == 0) __s.__sort_run(segs[i]);
+                    else    __s.__merge_runs(segs[i], segs[i + width]);
+                }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            };
+            size_t width = 0, stride = 1;
+            bool failed = false;
+            task_group __group;
+            for (;;) {
+                for (size_t i = stride; i + width < __threads; i += stride) {
+                    try {
+                        __group.fork([&__task, i, width] {__task(i, width);});
+                    }
+                    catch (...) {
+                        //no memory for the task, do it here
+                        __task(i, width);
+                    }
+                }
+                __task(0, width);
+                __group.join();
+                for (size_t i = 0; i < __threads; ++i) {
+                    if (errors[i])  failed = true;
+                }
+                if (failed || stride >= __threads)  break;
+                width = stride;
+                stride *= 2;
+            }
+            if (failed) {
+                //the segments left are at the multiples of stride, link them back
+                for (size_t i = stride; i < __threads; i += stride) {
+                    segs[0].tail -> next = segs[i].head;
+                    segs[0].tail = segs[i].tail;
+                }
+                __sorter::__relink(__end, segs[0].head);
+                for (size_t i = 0; i < __threads; ++i) {
+                    if (errors[i])  std::rethrow_exception(errors[i]);
+                }
+            }
+            __sorter::__relink(__end, segs[0].head);
+        }
+    };
+
+    //a friend of list, it hands the node chain of a list to the sorter above
+    template <typename _List>
+    struct __list_parallel_sorter {
+        using __node_ptr = typename _List::__node_ptr;
+        using _Tp = typename _List::value_type;
+
+        template <typename _Comp>
+        static void sort(_List& l, _Comp comp, size_t __threads) {
+            if (__threads == 0) __threads = thread_pool::instance().concurrency();
+            auto __value_of = [](__node_ptr __p) -> _Tp& {return __p -> val;};
+            __parallel_chain_sorter<__node_ptr, _Comp, decltype(__value_of)>::sort(l.__end(),
+                    l.__size, comp, __value_of, __threads);
+        }
+    };
+
+    //list::sort split over threads, for long lists. 0 threads is one per core of the pool,
+    //every thread gets a copy of comp
+    template <typename _Tp, typename Alloc, typename _Comp = less<_Tp>>
+    inline void parallel_sort(list<_Tp, Alloc>& l, _Comp comp = _Comp(), size_t __threads = 0) {
+        __list_parallel_sorter<list<_Tp, Alloc>>::sort(l, comp, __threads);
+    }
+}
+
+#endif
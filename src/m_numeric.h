@@ -0,0 +1,32 @@
+#ifndef __MY_STL_NUMERIC_H
+#define __MY_STL_NUMERIC_H
+
+#include "m_functional.h"
+#include "m_iterator.h"
+#include <utility>      //for std::move
+
+namespace my_stl {
+    //fold [first, last) into init with op. Unlike accumulate the order of the operations is
+    //not fixed, op has to be associative and commutative, which lets the parallel reduce of
+    //m_execution.h split the range
+    template <typename _InputIter, typename _Tp, typename _BinaryOp>
+    inline _Tp reduce(_InputIter first, _InputIter last, _Tp init, _BinaryOp op) {
+        for (; first != last; ++first) {
+            init = op(std::move(init), *first);
+        }
+        return init;
+    }
+
+    template <typename _InputIter, typename _Tp>
+    inline _Tp reduce(_InputIter first, _InputIter last, _Tp init) {
+        return my_stl::reduce(first, last, std::move(init), plus<_Tp>());
+    }
+
+    template <typename _InputIter>
+    inline typename iterator_traits<_InputIter>::value_type reduce(_InputIter first, _InputIter last) {
+        typedef typename iterator_traits<_InputIter>::value_type _Tp;
+        return my_stl::reduce(first, last, _Tp());
+    }
+}
+
+#endif
@@ -0,0 +1,591 @@
+//a vector keeping its first _Nm elements inside the object, the heap is only used once it
+//grows past them. Same interface as vector
+#ifndef __MY_STL_SMALL_VECTOR_H
+#define __MY_STL_SMALL_VECTOR_H
+
+#include "m_memory.h"       //for allocator, uninitialized_* and __uninitialized_relocate
+#include "m_algobase.h"     //for move, move_backward and fill
+#include "m_unique_ptr.h"   //for compressed_pair
+#include <cstddef>          //for size_t, ptrdiff_t
+#include <string.h>         //for memmove
+#include <utility>          //for std::move, std::forward
+#include <initializer_list>
+#include <iostream>         //for the boundary error of the debug build
+#include <stdexcept>        //for out_of_range
+
+namespace my_stl {
+    template <typename _Tp, size_t _Nm, typename Alloc = __malloc_alloc<0>>
+    class small_vector {
+        private:
+            //[start, last) are the elements, start is __inline_begin() until the first spill
+            // |-------elements-------| ######|
+            // ^                      ^       ^
+            // start                  last    end of storage
+            _Tp* start;
+            _Tp* last;
+            compressed_pair<_Tp*, Alloc> __end_and_alloc;
+            alignas(_Tp) unsigned char __inline_buf[(_Nm ? _Nm : 1) * sizeof(_Tp)];
+            using data_allocator = my_simple_alloc<_Tp, Alloc>;
+
+        public:
+            typedef _Tp value_type;
+            typedef _Tp* pointer;
+            typedef _Tp* iterator;
+            typedef const _Tp* const_pointer;
+            typedef const _Tp* const_iterator;
+            typedef _Tp& reference;
+            typedef const _Tp& const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef Alloc allocator_type;
+
+        private:
+            _Tp*& end_of_storage() noexcept {return __end_and_alloc.first();}
+            _Tp* end_of_storage() const noexcept {return __end_and_alloc.first();}
+            Alloc& __alloc() noexcept {return __end_and_alloc.second();}
+
+            _Tp* __inline_begin() noexcept {return reinterpret_cast<_Tp*>(__inline_buf);}
+            bool __is_inline() const noexcept {
+                return start == reinterpret_cast<const _Tp*>(__inline_buf);
+            }
+
+            void __reset_inline() noexcept {
+                start = last = __inline_begin();
+                end_of_storage() = start + _Nm;
+            }
+
+            iterator __allocate(size_type n) {
+                return n ? data_allocator::allocate(__alloc(), n) : nullptr;
+            }
+
+            //give the heap storage back, the inline buffer is not ours to free
+            void __release_storage() noexcept {
+                if (!__is_inline()) data_allocator::deallocate(__alloc(), start, capacity());
+            }
+
+            //room for n elements, inline when they fit
+            iterator __storage_for(size_type n) {
+                return n <= _Nm ? __inline_begin() : __allocate(n);
+            }
+
+            void __discard_storage(iterator p, size_type n) noexcept {
+                if (p != __inline_begin())  data_allocator::deallocate(__alloc(), p, n);
+            }
+
+            //the capacity we grow to when there is no room for count more elements
+            size_type __next_capacity(size_type count) const noexcept {
+                const size_type n = size();
+                return n + (count > n ? count : n);
+            }
+
+            typedef typename is_trivially_relocatable<_Tp>::type __relocatable;
+
+            //relocate all the elements to new_first, leaving gap raw slots in front of pos,
+            //returns the new last. The old storage is raw memory after it returns
+            iterator __relocate_with_gap(iterator pos, iterator new_first, size_type gap,
+                    __true_type) noexcept {
+                iterator new_pos = my_stl::__uninitialized_relocate(start, pos, new_first, __true_type());
+                return my_stl::__uninitialized_relocate(pos, last, new_pos + gap, __true_type());
+            }
+
+            iterator __relocate_with_gap(iterator pos, iterator new_first, size_type gap,
+                    __false_type) {
+                iterator new_pos = my_stl::__uninitialized_move_if_noexcept(start, pos, new_first);
+                iterator new_last;
+                try {
+                    new_last = my_stl::__uninitialized_move_if_noexcept(pos, last, new_pos + gap);
+                }
+                catch (...) {
+                    destroy(new_first, new_pos);
+                    throw;
+                }
+                destroy(start, last);
+                return new_last;
+            }
+
+            //take new_start as the storage, the old one is raw memory by now
+            void __adopt(iterator new_start, iterator new_last, size_type new_cap) noexcept {
+                __release_storage();
+                start = new_start;
+                last = new_last;
+                end_of_storage() = start + new_cap;
+            }
+
+            //and the allocator can resize a heap block for us (maybe in place)
+            typedef integral_constant<bool, is_trivially_relocatable<_Tp>::value &&
+                __has_reallocate<Alloc>::value> __use_reallocate;
+
+            //the elements only ever go from the inline buffer to the heap, or to a bigger heap
+            void __reallocate(size_type new_cap) {
+                if (__is_inline())  __reallocate(new_cap, __false_type());
+                else    __reallocate(new_cap, __use_reallocate());
+            }
+
+            void __reallocate(size_type new_cap, __true_type) {
+                const size_type n = size();
+                start = data_allocator::reallocate(__alloc(), start, capacity(), new_cap);
+                last = start + n;
+                end_of_storage() = start + new_cap;
+            }
+
+            void __reallocate(size_type new_cap, __false_type) {
+                iterator new_start = __allocate(new_cap);
+                iterator new_last;
+                try {
+                    new_last = __relocate_with_gap(last, new_start, 0, __relocatable());
+                }
+                catch (...) {
+                    data_allocator::deallocate(__alloc(), new_start, new_cap);
+                    throw;
+                }
+                __adopt(new_start, new_last, new_cap);
+            }
+
+            //slow path of emplace_back, args may refer to an element of this vector so the new
+            //element is constructed before the old ones go away
+            template <typename... Args>
+            void __realloc_emplace_back(Args&&... args) {
+                if (__is_inline())  __realloc_emplace_back_aux(__false_type(), std::forward<Args>(args)...);
+                else    __realloc_emplace_back_aux(__use_reallocate(), std::forward<Args>(args)...);
+            }
+
+            //the old block is gone once it is resized, so the element is built aside first, as
+            //vector does
+            template <typename... Args>
+            void __realloc_emplace_back_aux(__true_type, Args&&... args) {
+                alignas(_Tp) unsigned char __buf[sizeof(_Tp)];
+                _Tp* __tmp = reinterpret_cast<_Tp*>(__buf);
+                construct(__tmp, std::forward<Args>(args)...);
+                try {
+                    __reallocate(__next_capacity(1), __true_type());
+                }
+                catch (...) {
+                    destroy(__tmp);
+                    throw;
+                }
+                memcpy((void*)last, (const void*)__tmp, sizeof(_Tp));
+                ++last;
+            }
+
+            template <typename... Args>
+            void __realloc_emplace_back_aux(__false_type, Args&&... args) {
+                const size_type new_cap = __next_capacity(1);
+                iterator new_start = __allocate(new_cap);
+                iterator new_last = new_start + size();
+                try {
+                    construct(new_last, std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    data_allocator::deallocate(__alloc(), new_start, new_cap);
+                    throw;
+                }
+                try {
+                    __relocate_with_gap(last, new_start, 0, __relocatable());
+                }
+                catch (...) {
+                    destroy(new_last);
+                    data_allocator::deallocate(__alloc(), new_start, new_cap);
+                    throw;
+                }
+                __adopt(new_start, new_last + 1, new_cap);
+            }
+
+            //insert count copies of value at pos when the capacity is enough, as vector does
+            void __insert_in_place(iterator pos, size_type count, const _Tp& value, __true_type) {
+                const _Tp value_copy(value);
+                const size_type n_tail = last - pos;
+                memmove((void*)(pos + count), (const void*)pos, n_tail * sizeof(_Tp));
+                try {
+                    my_stl::uninitialized_fill_n(pos, count, value_copy);
+                }
+                catch (...) {
+                    memmove((void*)pos, (const void*)(pos + count), n_tail * sizeof(_Tp));
+                    throw;
+                }
+                last += count;
+            }
+
+            void __insert_in_place(iterator pos, size_type count, const _Tp& value, __false_type) {
+                const _Tp value_copy(value);
+                if (size_type(last - pos) >= count) {
+                    my_stl::uninitialized_move(last - count, last, last);
+                    my_stl::move_backward(pos, last - count, last);
+                    my_stl::fill(pos, pos + count, value_copy);
+                }
+                else {
+                    my_stl::uninitialized_move(pos, last, count + pos);
+                    my_stl::fill(pos, last, value_copy);
+                    my_stl::uninitialized_fill_n(last, pos + count - last, value_copy);
+                }
+                last += count;
+            }
+
+            void __erase_range(iterator head, iterator tail, __true_type) noexcept {
+                destroy(head, tail);
+                memmove((void*)head, (const void*)tail, (last - tail) * sizeof(_Tp));
+                last -= tail - head;
+            }
+
+            void __erase_range(iterator head, iterator tail, __false_type) {
+                iterator new_last = my_stl::move(tail, last, head);
+                destroy(new_last, last);
+                last = new_last;
+            }
+
+            void __fill_initialize(size_type n, const _Tp& value) {
+                iterator p = __storage_for(n);
+                try {
+                    my_stl::uninitialized_fill_n(p, n, value);
+                }
+                catch (...) {
+                    __discard_storage(p, n);
+                    __reset_inline();
+                    throw;
+                }
+                start = p;
+                last = p + n;
+                end_of_storage() = n <= _Nm ? p + _Nm : p + n;
+            }
+
+            template <typename RandomAccessIterator>
+            void __construct_from_iterator(RandomAccessIterator _first, RandomAccessIterator _last,
+                    random_access_iterator_tag) {
+                const size_type n = _last - _first;
+                iterator p = __storage_for(n);
+                try {
+                    last = my_stl::uninitialized_copy(_first, _last, p);
+                }
+                catch (...) {
+                    __discard_storage(p, n);
+                    __reset_inline();
+                    throw;
+                }
+                start = p;
+                end_of_storage() = n <= _Nm ? p + _Nm : p + n;
+            }
+
+            template <typename InputIterator>
+            void __construct_from_iterator(InputIterator _first, InputIterator _last,
+                    input_iterator_tag) {
+                try {
+                    for (; _first != _last; ++_first) {
+                        push_back(*_first);
+                    }
+                }
+                catch (...) {
+                    clear();
+                    __release_storage();
+                    throw;
+                }
+            }
+
+            //steal the heap storage of rhs, or relocate its inline elements into ours
+            void __take(small_vector& rhs) {
+                if (rhs.__is_inline()) {
+                    last = my_stl::__uninitialized_relocate(rhs.start, rhs.last, start);
+                    rhs.last = rhs.start;
+                }
+                else {
+                    start = rhs.start;
+                    last = rhs.last;
+                    end_of_storage() = rhs.end_of_storage();
+                    rhs.__reset_inline();
+                }
+            }
+
+            //out of line, so the checks don't bloat the accessors inlined into loops
+            __attribute__((noinline, noreturn)) static void __throw_out_of_range() {
+                throw std::out_of_range("small_vector::at");
+            }
+
+        #ifdef __MY_STL_DEBUG
+            void __check_boundary(size_type n) const {
+                if (n >= size()) {
+                    std::cerr << "out of small_vector boundary" << std::endl;
+                    exit(1);
+                }
+            }
+        #endif
+
+        public:
+            iterator begin() {return start;}
+            iterator end() {return last;}
+            const_iterator cbegin() const {return start;};
+            const_iterator cend() const {return last;};
+            size_type size() const {return last - start;}
+            size_type capacity() const {return end_of_storage() - start;}
+            bool empty() const {return start == last;}
+
+            //unchecked, so loops over the elements can be vectorized. Build with __MY_STL_DEBUG
+            //to have every access checked
+            reference operator[](size_type n) {
+            #ifdef __MY_STL_DEBUG
+                __check_boundary(n);
+            #endif
+                return *(start + n);
+            }
+
+            const_reference operator[](size_type n) const {
+            #ifdef __MY_STL_DEBUG
+                __check_boundary(n);
+            #endif
+                return *(start + n);
+            }
+
+            //checked access, throws out_of_range
+            reference at(size_type n) {
+                if (n >= size())    __throw_out_of_range();
+                return *(start + n);
+            }
+
+            const_reference at(size_type n) const {
+                if (n >= size())    __throw_out_of_range();
+                return *(start + n);
+            }
+
+            pointer data() noexcept {return start;}
+            const_pointer data() const noexcept {return start;}
+
+            allocator_type get_allocator() const {return __end_and_alloc.second();}
+
+            //ctors
+            small_vector() noexcept: __end_and_alloc(nullptr) {
+                __reset_inline();
+            }
+
+            explicit small_vector(const Alloc& __a) noexcept: __end_and_alloc(nullptr, __a) {
+                __reset_inline();
+            }
+
+            small_vector(size_type n, const _Tp& value, const Alloc& __a = Alloc()):
+                __end_and_alloc(nullptr, __a) {
+                __fill_initialize(n, value);
+            }
+
+            small_vector(int n, const _Tp& value, const Alloc& __a = Alloc()): __end_and_alloc(nullptr, __a) {
+                __fill_initialize(n, value);
+            }
+
+            small_vector(long n, const _Tp& value, const Alloc& __a = Alloc()): __end_and_alloc(nullptr, __a) {
+                __fill_initialize(n, value);
+            }
+
+            explicit small_vector(size_type n, const Alloc& __a = Alloc()): __end_and_alloc(nullptr, __a) {
+                __fill_initialize(n, _Tp());
+            }
+
+            small_vector(const small_vector& rhs): small_vector(rhs, rhs.get_allocator()) {}
+
+            small_vector(const small_vector& rhs, const Alloc& __a): __end_and_alloc(nullptr, __a) {
+                __construct_from_iterator(rhs.start, rhs.last, random_access_iterator_tag());
+            }
+
+            small_vector(std::initializer_list<_Tp> _il, const Alloc& __a = Alloc()):
+                __end_and_alloc(nullptr, __a) {
+                __construct_from_iterator(_il.begin(), _il.end(), random_access_iterator_tag());
+            }
+
+            template<typename InputIterator>
+            small_vector(InputIterator _first, InputIterator _last, const Alloc& __a = Alloc()):
+                __end_and_alloc(nullptr, __a) {
+                __reset_inline();
+                __construct_from_iterator(_first, _last,
+                        typename iterator_traits<InputIterator>::iterator_category());
+            }
+
+            //a heap storage is taken over, inline elements have to be moved one by one
+            small_vector(small_vector&& rhs) noexcept(is_nothrow_move_constructible<_Tp>::value):
+                __end_and_alloc(nullptr, std::move(rhs.__alloc())) {
+                __reset_inline();
+                __take(rhs);
+            }
+
+            small_vector& operator=(const small_vector& rhs) {
+                small_vector temp(rhs);
+                swap(temp);
+                return *this;
+            }
+
+            small_vector& operator=(small_vector&& rhs) noexcept(is_nothrow_move_constructible<_Tp>::value) {
+                if (this != &rhs) {
+                    clear();
+                    __release_storage();
+                    __reset_inline();
+                    __alloc() = std::move(rhs.__alloc());
+                    __take(rhs);
+                }
+                return *this;
+            }
+
+            bool operator==(const small_vector& rhs) const {
+                if (size() != rhs.size())   return false;
+                for (auto _i1 = cbegin(), _i2 = rhs.cbegin(); _i1 != cend(); ++_i1, ++_i2) {
+                    if (*_i1 != *_i2)   return false;
+                }
+                return true;
+            }
+
+            bool operator!=(const small_vector& rhs) const {
+                return !operator==(rhs);
+            }
+
+            //two heap storages swap their pointers, otherwise the elements are moved
+            void swap(small_vector& rhs) {
+                if (this == &rhs)   return;
+                if (!__is_inline() && !rhs.__is_inline()) {
+                    iterator start_temp = start;
+                    iterator last_temp = last;
+                    start = rhs.start;
+                    last = rhs.last;
+                    rhs.start = start_temp;
+                    rhs.last = last_temp;
+                    __end_and_alloc.swap(rhs.__end_and_alloc);
+                    return;
+                }
+                small_vector temp(std::move(rhs));
+                rhs = std::move(*this);
+                *this = std::move(temp);
+            }
+
+            ~small_vector() {
+                destroy(start, last);
+                __release_storage();
+            }
+
+            reference front() {
+                return *start;
+            }
+
+            reference back() {
+                return *(last - 1);
+            }
+
+            template <typename... Args>
+            void emplace_back(Args&&... args) {
+                if (last != end_of_storage()) {
+                    construct(last, std::forward<Args>(args)...);
+                    ++last;
+                }
+                else {
+                    __realloc_emplace_back(std::forward<Args>(args)...);
+                }
+            }
+
+            void push_back(const _Tp& x) {
+                emplace_back(x);
+            }
+
+            void push_back(_Tp&& x) {
+                emplace_back(std::move(x));
+            }
+
+            void pop_back() {
+                destroy(--last);
+            }
+
+            void resize(size_type new_size, const _Tp& x) {
+                if (size() > new_size) {
+                    destroy(start + new_size, last);
+                    last = start + new_size;
+                }
+                else if (size() < new_size) {
+                    if (capacity() >= new_size) {
+                        my_stl::uninitialized_fill(last, start + new_size, x);
+                        last = start + new_size;
+                    }
+                    else {
+                        //fill the new elements first, x may be one of our elements
+                        iterator new_start = __allocate(new_size);
+                        iterator new_end = new_start + size();
+                        try {
+                            my_stl::uninitialized_fill(new_end, new_start + new_size, x);
+                        }
+                        catch (...) {
+                            data_allocator::deallocate(__alloc(), new_start, new_size);
+                            throw;
+                        }
+                        try {
+                            __relocate_with_gap(last, new_start, 0, __relocatable());
+                        }
+                        catch (...) {
+                            destroy(new_end, new_start + new_size);
+                            data_allocator::deallocate(__alloc(), new_start, new_size);
+                            throw;
+                        }
+                        __adopt(new_start, new_start + new_size, new_size);
+                    }
+                }
+            }
+
+            void resize(size_type new_size) {
+                resize(new_size, _Tp());
+            }
+
+            //the storage is kept, heap or not
+            void clear() {
+                destroy(start, last);
+                last = start;
+            }
+
+            iterator erase(iterator head, iterator tail) {
+                if (head >= tail)    return head;
+                __erase_range(head, tail, __relocatable());
+                return head;
+            }
+
+            iterator erase(iterator position) {
+                __erase_range(position, position + 1, __relocatable());
+                return position;
+            }
+
+            iterator insert(const iterator pos, const _Tp& value) {
+                return insert(pos, 1, value);
+            }
+
+            iterator insert(const iterator pos, size_type count, const _Tp& value);
+
+            void reserve(size_type size) {
+                if (capacity() < size) {
+                    __reallocate(size);
+                }
+            }
+    };
+
+    template <typename _Tp, size_t _Nm, typename Alloc>
+    typename small_vector<_Tp, _Nm, Alloc>::iterator small_vector<_Tp, _Nm, Alloc>::insert(
+            const typename small_vector<_Tp, _Nm, Alloc>::iterator pos,
+            typename small_vector<_Tp, _Nm, Alloc>::size_type count, const _Tp& value) {
+        const difference_type offset = pos - start;
+        if (count) {
+            if (size_type(end_of_storage() - last) >= count) {
+                __insert_in_place(pos, count, value, __relocatable());
+            }
+            else {
+                const size_type new_cap = __next_capacity(count);
+                iterator new_first = __allocate(new_cap);
+                //fill the value first, it may refer to one of the old elements
+                iterator new_pos = new_first + offset;
+                try {
+                    my_stl::uninitialized_fill_n(new_pos, count, value);
+                }
+                catch (...) {
+                    data_allocator::deallocate(__alloc(), new_first, new_cap);
+                    throw;
+                }
+                iterator new_last;
+                try {
+                    new_last = __relocate_with_gap(pos, new_first, count, __relocatable());
+                }
+                catch (...) {
+                    destroy(new_pos, new_pos + count);
+                    data_allocator::deallocate(__alloc(), new_first, new_cap);
+                    throw;
+                }
+                __adopt(new_first, new_last, new_cap);
+            }
+        }
+        return start + offset;
+    }
+}
+
+#endif
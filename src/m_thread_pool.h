@@ -0,0 +1,433 @@
+#ifndef __MY_STL_THREAD_POOL_H
+#define __MY_STL_THREAD_POOL_H
+
+#include "m_vector.h"
+#include "m_unique_ptr.h"
+#include "m_alloc.h"
+#include <cstddef>              //for size_t
+#include <new>                  //for placement new
+#include <utility>              //for std::move
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>            //for std::exception_ptr
+
+namespace my_stl {
+    //-----------------------------------synopsis--------------------------------------
+    class thread_pool;
+    class task_group;
+    template <typename _Index, typename _Fn>
+    void parallel_for(thread_pool& pool, _Index begin, _Index end, size_t grain, _Fn fn);
+    template <typename _Index, typename _Fn>
+    void parallel_for(_Index begin, _Index end, size_t grain, _Fn fn);
+    //-------------------------------end of synopsis-----------------------------------
+
+    //a forked function, owned by whoever takes it out of a queue
+    struct __task {
+        task_group* __group;
+
+        explicit __task(task_group* group): __group(group) {}
+        virtual ~__task() {}
+        virtual void __run() = 0;
+    };
+
+    template <typename _Fn>
+    struct __task_impl: __task {
+        _Fn __fn;
+
+        __task_impl(task_group* group, _Fn&& fn): __task(group), __fn(std::move(fn)) {}
+        void __run() override {__fn();}
+    };
+
+    //the deque of a worker by Chase and Lev (with the memory orders of Le et al.): the worker
+    //pushes and pops at the bottom, the other threads steal from the top, only the last task
+    //is fought over with a cas. A full ring is replaced by one twice as big, the old rings are
+    //kept until the deque goes away since a thief may still be reading one
+    class __work_deque {
+        private:
+            typedef std::atomic<__task*> _Slot;
+            typedef my_simple_alloc<_Slot, alloc> _Slot_alloc;
+
+            struct __ring {
+                size_t __mask;
+                _Slot* __slots;
+
+                explicit __ring(size_t cap): __mask(cap - 1), __slots(_Slot_alloc::allocate(cap)) {
+                    for (size_t i = 0; i < cap; ++i) {
+                        new (__slots + i) _Slot(nullptr);
+                    }
+                }
+
+                ~__ring() {_Slot_alloc::deallocate(__slots, __mask + 1);}
+
+                size_t capacity() const {return __mask + 1;}
+                __task* get(long i) const {return __slots[i & __mask].load(std::memory_order_relaxed);}
+                void put(long i, __task* t) {__slots[i & __mask].store(t, std::memory_order_relaxed);}
+            };
+
+            enum {__initial_capacity = 64};
+
+            std::atomic<long> __top;
+            std::atomic<long> __bottom;
+            std::atomic<__ring*> __array;
+            vector<unique_ptr<__ring>> __rings;
+
+        public:
+            __work_deque(): __top(0), __bottom(0) {
+                __rings.emplace_back(new __ring(__initial_capacity));
+                __array.store(__rings[0].get(), std::memory_order_relaxed);
+            }
+
+            __work_deque(const __work_deque&) = delete;
+            __work_deque& operator=(const __work_deque&) = delete;
+
+            //the owner only
+            void push(__task* t) {
+                const long b = __bottom.load(std::memory_order_relaxed);
+                const long top = __top.load(std::memory_order_acquire);
+                __ring* a = __array.load(std::memory_order_relaxed);
+                if (b - top > long(a -> capacity()) - 1) {
+                    __ring* bigger = new __ring(a -> capacity() * 2);
+                    __rings.emplace_back(bigger);
+                    for (long i = top; i < b; ++i) {
+                        bigger -> put(i, a -> get(i));
+                    }
+                    __array.store(bigger, std::memory_order_release);
+                    a = bigger;
+                }
+                a -> put(b, t);
+                __bottom.store(b + 1, std::memory_order_release);
+            }
+
+            //the owner only, the newest task
+            __task* pop() {
+                const long b = __bottom.load(std::memory_order_relaxed) - 1;
+                __ring* a = __array.load(std::memory_order_relaxed);
+                __bottom.store(b, std::memory_order_seq_cst);
+                long top = __top.load(std::memory_order_seq_cst);
+                if (top > b) {
+                    __bottom.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                __task* t = a -> get(b);
+                if (top == b) {
+                    //the last one, a thief may be taking it as well
+                    if (!__top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                std::memory_order_relaxed)) {
+                        t = nullptr;
+                    }
+                    __bottom.store(b + 1, std::memory_order_relaxed);
+                }
+                return t;
+            }
+
+            //any thread, the oldest task
+            __task* steal() {
+                long top = __top.load(std::memory_order_seq_cst);
+                const long b = __bottom.load(std::memory_order_seq_cst);
+                if (top >= b)   return nullptr;
+                __ring* a = __array.load(std::memory_order_acquire);
+                __task* t = a -> get(top);
+                if (!__top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                            std::memory_order_relaxed)) {
+                    return nullptr;
+                }
+                return t;
+            }
+    };
+
+    //-----------------------------------------------------------------------
+    //-----------------------------thread_pool-------------------------------
+    //-----------------------------------------------------------------------
+    //the scheduler of the parallel algorithms and containers. Every worker has a deque: a
+    //task forked on a worker goes to its own deque and is popped newest first, an idle worker
+    //steals the oldest task of another one (the biggest piece, for divide and conquer).
+    //Tasks forked by other threads go to a shared queue. A thread waiting for a task group
+    //runs tasks until its group is done, so the caller works too and nested fork/join does
+    //not block the workers. Idle threads sleep until a task is queued or a group finishes
+    class thread_pool {
+        private:
+            friend class task_group;
+
+            struct __worker_id {
+                thread_pool* pool;
+                size_t index;
+            };
+
+            vector<unique_ptr<__work_deque>> __deques;
+            vector<std::thread> __workers;
+            //the queue of the tasks forked outside the workers
+            std::mutex __inject_lock;
+            vector<__task*> __injected;
+            size_t __inject_head;
+            std::atomic<size_t> __inject_size;
+            //sleeping: a thread waits on __wake until __epoch changes, which it does on
+            //every fork and every group finished
+            std::mutex __sleep_lock;
+            std::condition_variable __wake;
+            std::atomic<size_t> __epoch;
+            std::atomic<size_t> __sleepers;
+            bool __stop;
+
+            static __worker_id& __this_worker() {
+                static thread_local __worker_id id = {nullptr, 0};
+                return id;
+            }
+
+            static unsigned __random() {
+                static thread_local unsigned state = 2463534242u;
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                return state;
+            }
+
+            void __notify() {
+                __epoch.fetch_add(1);
+                if (__sleepers.load()) {
+                    std::lock_guard<std::mutex> guard(__sleep_lock);
+                    __wake.notify_all();
+                }
+            }
+
+            //sleep until something happened after epoch was read, or done() holds. False
+            //once the pool is stopping
+            template <typename _Pred>
+            bool __sleep(size_t epoch, _Pred done) {
+                std::unique_lock<std::mutex> guard(__sleep_lock);
+                ++__sleepers;
+                __wake.wait(guard, [&] {return __stop || __epoch.load() != epoch || done();});
+                --__sleepers;
+                return !__stop;
+            }
+
+            void __push(__task* t) {
+                __worker_id& self = __this_worker();
+                if (self.pool == this) {
+                    __deques[self.index] -> push(t);
+                }
+                else {
+                    std::lock_guard<std::mutex> guard(__inject_lock);
+                    __injected.push_back(t);
+                    __inject_size.fetch_add(1);
+                }
+                __notify();
+            }
+
+            __task* __take_injected() {
+                if (__inject_size.load() == 0)  return nullptr;
+                std::lock_guard<std::mutex> guard(__inject_lock);
+                if (__inject_head == __injected.size()) return nullptr;
+                __task* t = __injected[__inject_head++];
+                if (__inject_head == __injected.size()) {
+                    __injected.clear();
+                    __inject_head = 0;
+                }
+                __inject_size.fetch_sub(1);
+                return t;
+            }
+
+            //the own deque, the shared queue, then the others from a random one on
+            __task* __find_task() {
+                __worker_id& self = __this_worker();
+                __task* t = nullptr;
+                if (self.pool == this && (t = __deques[self.index] -> pop()))   return t;
+                if ((t = __take_injected()))    return t;
+                const size_t n = __deques.size();
+                if (n == 0) return nullptr;
+                const size_t start = __random() % n;
+                for (size_t i = 0; i < n; ++i) {
+                    if ((t = __deques[(start + i) % n] -> steal())) return t;
+                }
+                return nullptr;
+            }
+
+            inline void __execute(__task* t);
+
+            bool __run_one() {
+                __task* t = __find_task();
+                if (!t) return false;
+                __execute(t);
+                return true;
+            }
+
+            void __worker_loop(size_t index) {
+                __this_worker() = __worker_id{this, index};
+                for (;;) {
+                    const size_t epoch = __epoch.load();
+                    if (__run_one())    continue;
+                    if (!__sleep(epoch, [] {return false;}))    return;
+                }
+            }
+
+        public:
+            //workers threads besides the threads which wait for their tasks
+            explicit thread_pool(size_t workers)
+                : __inject_head(0), __inject_size(0), __epoch(0), __sleepers(0), __stop(false) {
+                __deques.reserve(workers);
+                for (size_t i = 0; i < workers; ++i) {
+                    __deques.emplace_back(new __work_deque());
+                }
+                __workers.reserve(workers);
+                for (size_t i = 0; i < workers; ++i) {
+                    try {
+                        __workers.emplace_back(&thread_pool::__worker_loop, this, i);
+                    }
+                    catch (...) {
+                        //no more threads, make do with the ones we have (their deques
+                        //are still stolen from)
+                        break;
+                    }
+                }
+            }
+
+            thread_pool(const thread_pool&) = delete;
+            thread_pool& operator=(const thread_pool&) = delete;
+
+            //every task group has to be done by now
+            ~thread_pool() {
+                {
+                    std::lock_guard<std::mutex> guard(__sleep_lock);
+                    __stop = true;
+                }
+                __wake.notify_all();
+                for (size_t i = 0; i < __workers.size(); ++i) {
+                    __workers[i].join();
+                }
+            }
+
+            //the pool shared by the library, one thread per core with the caller
+            static thread_pool& instance() {
+                static thread_pool pool(std::thread::hardware_concurrency() > 1 ?
+                        std::thread::hardware_concurrency() - 1 : 0);
+                return pool;
+            }
+
+            size_t size() const {return __workers.size();}
+            //the threads working on a task group, the waiting one included
+            size_t concurrency() const {return __workers.size() + 1;}
+    };
+
+    //-----------------------------------------------------------------------
+    //-----------------------------task_group--------------------------------
+    //-----------------------------------------------------------------------
+    //fork runs fn on the pool, join waits for all the functions forked so far, running
+    //tasks meanwhile. The first exception cancels the functions of the group not started yet
+    //and is rethrown by join. The destructor joins as well, dropping the exception
+    class task_group {
+        private:
+            friend class thread_pool;
+
+            thread_pool& __pool;
+            std::atomic<size_t> __pending;
+            std::atomic<bool> __cancelled;
+            std::mutex __error_lock;
+            std::exception_ptr __error;
+
+            void __fail(std::exception_ptr e) {
+                std::lock_guard<std::mutex> guard(__error_lock);
+                if (!__error)   __error = e;
+                __cancelled.store(true);
+            }
+
+            void __wait() {
+                while (__pending.load(std::memory_order_acquire) != 0) {
+                    const size_t epoch = __pool.__epoch.load();
+                    if (__pool.__run_one()) continue;
+                    __pool.__sleep(epoch, [this] {return __pending.load() == 0;});
+                }
+            }
+
+        public:
+            explicit task_group(thread_pool& pool = thread_pool::instance())
+                : __pool(pool), __pending(0), __cancelled(false) {}
+
+            task_group(const task_group&) = delete;
+            task_group& operator=(const task_group&) = delete;
+
+            ~task_group() {
+                __wait();
+            }
+
+            template <typename _Fn>
+            void fork(_Fn fn) {
+                unique_ptr<__task> t(new __task_impl<_Fn>(this, std::move(fn)));
+                __pending.fetch_add(1);
+                __pool.__push(t.get());
+                t.release();
+            }
+
+            void join() {
+                __wait();
+                std::exception_ptr e;
+                {
+                    std::lock_guard<std::mutex> guard(__error_lock);
+                    e = __error;
+                    __error = nullptr;
+                }
+                __cancelled.store(false);
+                if (e)  std::rethrow_exception(e);
+            }
+    };
+
+    //nothing may touch the group once its count is down, the thread in join may be gone
+    inline void thread_pool::__execute(__task* t) {
+        unique_ptr<__task> owner(t);
+        task_group* group = t -> __group;
+        if (!group -> __cancelled.load()) {
+            try {
+                t -> __run();
+            }
+            catch (...) {
+                group -> __fail(std::current_exception());
+            }
+        }
+        owner.reset();
+        if (group -> __pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            __notify();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    //-----------------------------parallel_for------------------------------
+    //-----------------------------------------------------------------------
+    //fn(b, e) over pieces of [begin, end) of at most grain elements. The range is halved,
+    //the right half forked and the left one split again, so the thieves take the big pieces.
+    //begin and end are integers or random access iterators
+    template <typename _Index, typename _Fn>
+    void __parallel_for_split(task_group& group, _Index begin, _Index end, size_t grain, _Fn& fn) {
+        while (size_t(end - begin) > grain) {
+            _Index middle = begin + (end - begin) / 2;
+            group.fork([&group, middle, end, grain, &fn] {
+                my_stl::__parallel_for_split(group, middle, end, grain, fn);
+            });
+            end = middle;
+        }
+        fn(begin, end);
+    }
+
+    template <typename _Index, typename _Fn>
+    void parallel_for(thread_pool& pool, _Index begin, _Index end, size_t grain, _Fn fn) {
+        if (!(begin < end)) return;
+        if (grain == 0) grain = 1;
+        if (size_t(end - begin) <= grain || pool.size() == 0) {
+            fn(begin, end);
+            return;
+        }
+        //the split is a task too, so whatever fn throws goes through the group and cancels
+        //the pieces not started yet
+        task_group group(pool);
+        group.fork([&group, begin, end, grain, &fn] {
+            my_stl::__parallel_for_split(group, begin, end, grain, fn);
+        });
+        group.join();
+    }
+
+    template <typename _Index, typename _Fn>
+    inline void parallel_for(_Index begin, _Index end, size_t grain, _Fn fn) {
+        my_stl::parallel_for(thread_pool::instance(), begin, end, grain, std::move(fn));
+    }
+}
+
+#endif
@@ -6,6 +6,7 @@
 #define __MY_STL_TYPE_TRAITS_H
 
 #include <cstddef> //for nullptr_t
+#include <new>     //for placement new
 
 namespace my_stl {
     //************************************************************
@@ -57,6 +58,20 @@ namespace my_stl {
 
     //member introspection, missing quite a few
     template <typename _Tp> struct is_empty;
+    template <typename _Tp> struct is_trivial;
+    template <typename _Tp> struct is_trivially_copyable;
+    template <typename _Tp> struct is_pod;
+
+    //supported operations
+    template <typename _Tp, typename... _Args> struct is_constructible;
+    template <typename _Tp, typename... _Args> struct is_nothrow_constructible;
+    template <typename _Tp> struct is_copy_constructible;
+    template <typename _Tp> struct is_move_constructible;
+    template <typename _Tp> struct is_nothrow_move_constructible;
+    template <typename _Tp> struct is_trivially_destructible;
+
+    //not in the standard, whether an object can be moved to another address by memcpy
+    template <typename _Tp> struct is_trivially_relocatable;
 
 
     //************************************************************
@@ -709,142 +724,134 @@ namespace my_stl {
     template <typename _Tp>
     constexpr bool is_empty_v = is_empty<_Tp>::value;
 
-    //-----------------old type traits(SGI style)-----------------------
-    //it is the original effort in SGI STL implementation to using TMP to 
-    //staticly dispatch functions based on there type(whether can we call memmove/memcpy etc)
-    //it is not used in any of the modern compiler (MSVC, GCC, LLVM-Clang) but I still keep it
-    //as a reference
-    
-    template <typename TYPE>
-    struct __type_traits {
-        //be conservative, meaning we want to set all the type to be false
-        typedef __false_type has_trivial_ctor;
-        typedef __false_type has_trivial_copy_ctor;
-        typedef __false_type has_trivial_assignment_operator;
-        typedef __false_type has_trivial_dtor;
-        typedef __false_type is_POD_type;
-    };
+    //supported operations
+    //----------------declval------------------------------------------
+    //only used in unevaluated context (decltype, noexcept, sizeof)
+    template <typename _Tp>
+    add_rvalue_reference_t<_Tp> declval() noexcept;
 
-    //template partial specialization, for all primitive types
-    //if for any class we want it to have the same copy, assignment behavior as primitive types
-    //we can define it by our own specialization
-    template<>
-    struct __type_traits <char> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+    //----------------is_constructible---------------------------------
+    //SFINAE again, if the placement new expression is ill-formed we fall back to the
+    //overload returning false_type
+    namespace __is_constructible_imp {
+        template <typename _Tp, typename... _Args>
+        decltype(::new (declval<void*>()) _Tp(declval<_Args>()...), true_type())
+        __is_constructible_test(int);
 
-    template<>
-    struct __type_traits <unsigned char> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+        template <typename _Tp, typename... _Args>
+        false_type __is_constructible_test(...);
 
-    template<>
-    struct __type_traits <signed char> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
-    
-    template<>
-    struct __type_traits <short> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+        template <bool, typename _Tp, typename... _Args>
+        struct __is_nothrow_constructible_aux: false_type {};
 
-    template<>
-    struct __type_traits <unsigned short> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+        template <typename _Tp, typename... _Args>
+        struct __is_nothrow_constructible_aux<true, _Tp, _Args...>:
+            integral_constant<bool, noexcept(::new (declval<void*>()) _Tp(declval<_Args>()...))> {};
+    } //__is_constructible_imp
 
-    template<>
-    struct __type_traits <int> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+    template <typename _Tp, typename... _Args>
+    struct is_constructible: 
+        decltype(__is_constructible_imp::__is_constructible_test<_Tp, _Args...>(0)) {};
 
-    template<>
-    struct __type_traits <unsigned int> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+    template <typename _Tp, typename... _Args>
+    constexpr bool is_constructible_v = is_constructible<_Tp, _Args...>::value;
 
-    template<>
-    struct __type_traits <long> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
-    
-    template<>
-    struct __type_traits <unsigned long> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+    //----------------is_nothrow_constructible-------------------------
+    template <typename _Tp, typename... _Args>
+    struct is_nothrow_constructible: __is_constructible_imp::__is_nothrow_constructible_aux<
+        is_constructible<_Tp, _Args...>::value, _Tp, _Args...> {};
 
-    template<>
-    struct __type_traits <float> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+    template <typename _Tp, typename... _Args>
+    constexpr bool is_nothrow_constructible_v = is_nothrow_constructible<_Tp, _Args...>::value;
 
-    template<>
-    struct __type_traits <double> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+    //----------------copy and move construction-----------------------
+    template <typename _Tp>
+    struct is_copy_constructible: is_constructible<_Tp, add_lvalue_reference_t<add_const_t<_Tp>>> {};
 
-    template<>
-    struct __type_traits <long double> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
-    };
+    template <typename _Tp>
+    constexpr bool is_copy_constructible_v = is_copy_constructible<_Tp>::value;
 
-    //pointer type
-    template<typename T>
-    struct __type_traits <T*> {
-        typedef __true_type has_trivial_ctor;
-        typedef __true_type has_trivial_copy_ctor;
-        typedef __true_type has_trivial_assignment_operator;
-        typedef __true_type has_trivial_dtor;
-        typedef __true_type is_POD_type;
+    template <typename _Tp>
+    struct is_move_constructible: is_constructible<_Tp, add_rvalue_reference_t<_Tp>> {};
+
+    template <typename _Tp>
+    constexpr bool is_move_constructible_v = is_move_constructible<_Tp>::value;
+
+    template <typename _Tp>
+    struct is_nothrow_move_constructible: is_nothrow_constructible<_Tp, add_rvalue_reference_t<_Tp>> {};
+
+    template <typename _Tp>
+    constexpr bool is_nothrow_move_constructible_v = is_nothrow_move_constructible<_Tp>::value;
+
+    //----------------triviality---------------------------------------
+    //these can not be done by TMP, we have to ask the compiler, gcc and clang provide all of
+    //them as intrinsics
+    template <typename _Tp>
+    struct is_trivial: integral_constant<bool, __is_trivial(_Tp)> {};
+
+    template <typename _Tp>
+    constexpr bool is_trivial_v = is_trivial<_Tp>::value;
+
+    template <typename _Tp>
+    struct is_trivially_copyable: integral_constant<bool, __is_trivially_copyable(_Tp)> {};
+
+    template <typename _Tp>
+    constexpr bool is_trivially_copyable_v = is_trivially_copyable<_Tp>::value;
+
+    template <typename _Tp>
+    struct is_pod: integral_constant<bool, __is_trivial(_Tp) && __is_standard_layout(_Tp)> {};
+
+    template <typename _Tp>
+    constexpr bool is_pod_v = is_pod<_Tp>::value;
+
+    //clang deprecates __has_trivial_destructor in favor of __is_trivially_destructible,
+    //which gcc does not have
+#if defined(__clang__)
+    template <typename _Tp>
+    struct is_trivially_destructible: integral_constant<bool, __is_trivially_destructible(_Tp)> {};
+#else
+    template <typename _Tp>
+    struct is_trivially_destructible: integral_constant<bool, __has_trivial_destructor(_Tp)> {};
+#endif
+
+    template <typename _Tp>
+    constexpr bool is_trivially_destructible_v = is_trivially_destructible<_Tp>::value;
+
+    //-----------------old type traits(SGI style)-----------------------
+    //it is the original effort in SGI STL implementation to using TMP to 
+    //staticly dispatch functions based on there type(whether can we call memmove/memcpy etc)
+    //SGI had to specialize it by hand for every builtin type and default everything else to
+    //false, we fill it from the compiler intrinsics instead so every trivial class type (POD
+    //records etc) takes the memmove / skip-dtor fast path as well. It can still be specialized
+    //for a type to override the compiler
+    template <typename TYPE>
+    struct __type_traits {
+        typedef integral_constant<bool, __is_trivially_constructible(TYPE)> has_trivial_ctor;
+        typedef integral_constant<bool, __is_trivially_constructible(TYPE, const TYPE&)> has_trivial_copy_ctor;
+        typedef integral_constant<bool, __is_trivially_assignable(TYPE&, const TYPE&)>
+            has_trivial_assignment_operator;
+        typedef typename is_trivially_destructible<TYPE>::type has_trivial_dtor;
+        typedef typename is_pod<TYPE>::type is_POD_type;
     };
+
+    //----------------is_trivially_relocatable--------------------------
+    //a type is trivially relocatable if moving an object to a new address and then destroying
+    //the old one is the same as a memcpy and forgetting the old bytes. Every trivially copyable
+    //type is, and so are most of the handle types (vector, unique_ptr...) which never point to
+    //themselves, those have to opt in by a specialization of this template
+    template <typename _Tp>
+    struct is_trivially_relocatable: is_trivially_copyable<_Tp> {};
+
+    template <typename _Tp>
+    struct is_trivially_relocatable<const _Tp>: is_trivially_relocatable<_Tp> {};
+
+    //an allocator held by a container can be moved around bitwise when it is empty
+    template <typename _Alloc>
+    struct __is_relocatable_alloc: integral_constant<bool, is_empty<_Alloc>::value ||
+        is_trivially_relocatable<_Alloc>::value> {};
+
+    template <typename _Tp>
+    constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<_Tp>::value;
 }
 
 #endif
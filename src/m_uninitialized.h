@@ -7,49 +7,207 @@
 #ifndef MY_STL_UNINITIALIZED_H
 #define MY_STL_UNINITIALIZED_H
 
-#include <string.h>   //for memmove
+#include <string.h>   //for memcpy
+#include <utility>    //for std::move
 #include "m_type_traits.h"
+#include "m_construct.h"   //for construct and destroy
+#include "m_iterator.h"    //for iterator_traits
+#include "m_algobase.h"    //for copy and fill
 
 
 namespace my_stl {
     //this function construct object in the allocated memory [result, result + (last - first))
     //by calling the copy ctor, note that the construction of these object has to be "commit or rollback"
     //which means if any exception is thrown, we have to destroy all the previous object
+    //constructing a copy is the same as assigning to the raw memory when both the copy ctor
+    //and operator= are trivial (SGI asks for a POD here, which is more than we need), with a
+    //trivial dtor on top the objects are plain bytes and can be memcpy-ed or memset
+    template <typename _Tp>
+    struct __construct_is_assign: integral_constant<bool, __type_traits<_Tp>::has_trivial_copy_ctor::value
+                                  && __type_traits<_Tp>::has_trivial_assignment_operator::value
+                                  && __type_traits<_Tp>::has_trivial_dtor::value> {};
+
+    //for such types we hand the work over to copy, which uses memmove for pointers, and there
+    //is nothing to roll back
     template <typename InputIterator, typename ForwardIterator>
-    ForwardIterator uninitialized_copy (InputIterator first, InputIterator last, ForwardIterator result) {
-       for (; first != last; ++result, ++first) {
-           construct (&*result, *first);
-       }
-       return result;
+    inline ForwardIterator __uninitialized_copy_aux (InputIterator first, InputIterator last,
+            ForwardIterator result, __true_type) {
+        return my_stl::copy(first, last, result);
     }
 
-    //specialized version, for char* and wchar_t*, use memmove, is much faster than constructing
-    inline char* uninitialized_copy (const char* first, const char* last, char* result) {
-        memmove (result, first, last - first);
-        return result + (last - first);
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator __uninitialized_copy_aux (InputIterator first, InputIterator last,
+            ForwardIterator result, __false_type) {
+        ForwardIterator cur = result;
+        try {
+            for (; first != last; ++cur, ++first) {
+                construct (&*cur, *first);
+            }
+        }
+        catch (...) {
+            destroy(result, cur);
+            throw;
+        }
+        return cur;
     }
 
-    inline wchar_t* uninitialized_copy (const wchar_t* first, wchar_t* last, wchar_t* result) {
-        memmove (result, first, last - first);
-        return result + (last - first);
+    //contiguous ranges of the same type, the destination is raw memory so it can not overlap
+    //the source, a single memcpy does it (this covers the char and wchar_t ranges as well)
+    template <typename _Tp>
+    inline _Tp* __uninitialized_copy_aux (const _Tp* first, const _Tp* last, _Tp* result, __true_type) {
+        const size_t n = last - first;
+        if (n) memcpy((void*)result, (const void*)first, n * sizeof(_Tp));
+        return result + n;
+    }
+
+    template <typename _Tp>
+    inline _Tp* __uninitialized_copy_aux (_Tp* first, _Tp* last, _Tp* result, __true_type) {
+        return __uninitialized_copy_aux((const _Tp*)first, (const _Tp*)last, result, __true_type());
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator uninitialized_copy (InputIterator first, InputIterator last, ForwardIterator result) {
+        typedef typename iterator_traits<ForwardIterator>::value_type _value_type;
+        return __uninitialized_copy_aux(first, last, result, typename __construct_is_assign<_value_type>::type());
+    }
+
+
+    //same as uninitialized_copy, but the objects are moved out of [first, last), the source
+    //objects are still alive (in a moved-from state) and need to be destroyed by the caller
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator uninitialized_move (InputIterator first, InputIterator last, ForwardIterator result) {
+        ForwardIterator cur = result;
+        try {
+            for (; first != last; ++cur, ++first) {
+                construct (&*cur, std::move(*first));
+            }
+        }
+        catch (...) {
+            destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    //used by the containers to relocate their elements into a new storage. We move when the
+    //move ctor can not throw (or when there is no copy ctor to fall back on), and copy otherwise,
+    //so a ctor throwing in the middle leaves the old elements untouched (the rule of
+    //std::move_if_noexcept)
+    template <typename _Tp>
+    struct __relocate_by_move: integral_constant<bool, is_nothrow_move_constructible<_Tp>::value
+                               || !is_copy_constructible<_Tp>::value> {};
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator __uninitialized_move_if_noexcept (InputIterator first, InputIterator last,
+            ForwardIterator result, __true_type) {
+        return my_stl::uninitialized_move(first, last, result);
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator __uninitialized_move_if_noexcept (InputIterator first, InputIterator last,
+            ForwardIterator result, __false_type) {
+        return my_stl::uninitialized_copy(first, last, result);
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator __uninitialized_move_if_noexcept (InputIterator first, InputIterator last,
+            ForwardIterator result) {
+        typedef typename iterator_traits<InputIterator>::value_type _value_type;
+        return __uninitialized_move_if_noexcept(first, last, result,
+                typename __relocate_by_move<_value_type>::type());
+    }
+
+    //relocate the objects in [first, last) to the raw memory at result, afterwards the objects
+    //live at result and [first, last) is raw memory again. Trivially relocatable types are
+    //just memcpy-ed, no ctor or dtor is called. Otherwise this is move_if_noexcept plus
+    //destroying the source, and on exception the source is left untouched
+    template <typename _Tp>
+    inline _Tp* __uninitialized_relocate (_Tp* first, _Tp* last, _Tp* result, __true_type) noexcept {
+        size_t n = last - first;
+        if (n) memcpy((void*)result, (const void*)first, n * sizeof(_Tp));
+        return result + n;
+    }
+
+    template <typename _Tp>
+    inline _Tp* __uninitialized_relocate (_Tp* first, _Tp* last, _Tp* result, __false_type) {
+        _Tp* res = my_stl::__uninitialized_move_if_noexcept(first, last, result);
+        destroy(first, last);
+        return res;
+    }
+
+    template <typename _Tp>
+    inline _Tp* __uninitialized_relocate (_Tp* first, _Tp* last, _Tp* result) {
+        return my_stl::__uninitialized_relocate(first, last, result,
+                typename is_trivially_relocatable<_Tp>::type());
     }
-    
 
     //this function will initialize the memory in [first, last) by the given value T
     template <typename ForwardIterator, typename TYPE>
-    void uninitialized_fill (ForwardIterator first, ForwardIterator last, const TYPE& value) {
-        for (; first != last; ++first) {
-            construct (&*first, value);
+    inline void __uninitialized_fill_aux (ForwardIterator first, ForwardIterator last,
+            const TYPE& value, __true_type) {
+        my_stl::fill(first, last, value);
+    }
+
+    template <typename _Tp>
+    inline void __uninitialized_fill_aux (_Tp* first, _Tp* last, const _Tp& value, __true_type) {
+        //raw memory of such a type can be filled by bytes, fill does it with memset or
+        //vector stores
+        my_stl::__fill_trivial(first, last - first, value);
+    }
+
+    template <typename ForwardIterator, typename TYPE>
+    void __uninitialized_fill_aux (ForwardIterator first, ForwardIterator last,
+            const TYPE& value, __false_type) {
+        ForwardIterator cur = first;
+        try {
+            for (; cur != last; ++cur) {
+                construct (&*cur, value);
+            }
+        }
+        catch (...) {
+            destroy(first, cur);
+            throw;
         }
     }
 
+    template <typename ForwardIterator, typename TYPE>
+    inline void uninitialized_fill (ForwardIterator first, ForwardIterator last, const TYPE& value) {
+        typedef typename iterator_traits<ForwardIterator>::value_type _value_type;
+        __uninitialized_fill_aux(first, last, value, typename __construct_is_assign<_value_type>::type());
+    }
+
     //this function will contruct exactly n object in the range [first, first + n) by given value T
     template <typename ForwardIterator, typename TYPE>
-    ForwardIterator uninitialized_fill_n (ForwardIterator first, size_t n, const TYPE& value) {
-        for (; n > 0; --n, ++first) {
-            construct(&*first, value);
+    inline ForwardIterator __uninitialized_fill_n_aux (ForwardIterator first, size_t n,
+            const TYPE& value, __true_type) {
+        return my_stl::fill_n(first, n, value);
+    }
+
+    template <typename _Tp>
+    inline _Tp* __uninitialized_fill_n_aux (_Tp* first, size_t n, const _Tp& value, __true_type) {
+        return my_stl::__fill_trivial(first, n, value);
+    }
+
+    template <typename ForwardIterator, typename TYPE>
+    ForwardIterator __uninitialized_fill_n_aux (ForwardIterator first, size_t n,
+            const TYPE& value, __false_type) {
+        ForwardIterator cur = first;
+        try {
+            for (; n > 0; --n, ++cur) {
+                construct(&*cur, value);
+            }
+        }
+        catch (...) {
+            destroy(first, cur);
+            throw;
         }
-        return first;
+        return cur;
+    }
+
+    template <typename ForwardIterator, typename TYPE>
+    inline ForwardIterator uninitialized_fill_n (ForwardIterator first, size_t n, const TYPE& value) {
+        typedef typename iterator_traits<ForwardIterator>::value_type _value_type;
+        return __uninitialized_fill_n_aux(first, n, value, typename __construct_is_assign<_value_type>::type());
     }
 }
 
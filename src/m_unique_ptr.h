@@ -134,6 +134,11 @@ namespace my_stl {
         const_pointer operator->() const noexcept;
     };
 
+    //a unique_ptr is a raw pointer (and its deleter), it can be memcpy-ed to a new place
+    template <typename _Tp, typename _Dp>
+    struct is_trivially_relocatable<unique_ptr<_Tp, _Dp>>: integral_constant<bool,
+        is_empty<_Dp>::value || is_trivially_relocatable<_Dp>::value> {};
+
     //non member function declarations
     template <typename _Tp, typename... Args>
     unique_ptr<_Tp> make_unique(Args&&... args) {
@@ -347,8 +352,8 @@ namespace my_stl {
 
             void swap(compressed_pair& _pair2) noexcept {
                 using std::swap;
-                swap(_first, _pair2.first);
-                swap(_second, _pair2.second);
+                swap(_first, _pair2._first);
+                swap(_second, _pair2._second);
             }
         };
         
@@ -394,7 +399,7 @@ namespace my_stl {
 
             void swap(compressed_pair& _pair2) noexcept {
                 using std::swap;
-                swap(_second, _pair2.second);
+                swap(_second, _pair2._second);
             }
         };
 
@@ -0,0 +1,1223 @@
+//An unrolled linked list, the list keeps a small array of elements in every node
+//so walking through it touches one node per N elements rather than one per element
+#ifndef __MY_STL_UNROLLED_LIST_H
+#define __MY_STL_UNROLLED_LIST_H
+
+#include "m_list.h"           //for the node linking helpers, the allocators
+#include <utility>            //for std::swap
+#include <cstddef>            //for std::ptrdiff_t
+
+
+namespace my_stl {
+
+    //elements in one node by default, around 256 bytes worth of elements
+    template <typename _Tp>
+    struct __unrolled_list_default_size:
+        integral_constant<size_t, (sizeof(_Tp) < 64 ? 256 / sizeof(_Tp) : 4)> {};
+
+    //the node keeps up to N elements in [0, count) of its buffer, the end node keeps none
+    template <typename _Tp, size_t N>
+    struct __unrolled_list_node {
+        __unrolled_list_node *prev;
+        __unrolled_list_node *next;
+        size_t count;
+        alignas(_Tp) unsigned char buffer[N * sizeof(_Tp)];
+
+        _Tp* data() noexcept {
+            return reinterpret_cast<_Tp*>(buffer);
+        }
+    };
+
+
+    //the iterator is the node and the index in it, the end iterator is (end node, 0)
+    //as for list, both const iterator and iterator derive from the base
+    template <typename _Tp, size_t N>
+    struct __unrolled_list_iterator_base {
+        using value_type = _Tp;
+        using iterator_category = bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using __node_ptr_type = __unrolled_list_node<_Tp, N>*;
+
+        __node_ptr_type node_ptr;
+        size_t idx;
+        __unrolled_list_iterator_base(__node_ptr_type __node_ptr, size_t __idx):
+            node_ptr(__node_ptr), idx(__idx) {}
+        __unrolled_list_iterator_base(): node_ptr(nullptr), idx(0) {}
+
+        void __incr() noexcept {
+            if (++idx == node_ptr -> count) {
+                node_ptr = node_ptr -> next;
+                idx = 0;
+            }
+        }
+
+        void __decr() noexcept {
+            if (idx == 0) {
+                node_ptr = node_ptr -> prev;
+                idx = node_ptr -> count;
+            }
+            --idx;
+        }
+
+        bool operator==(const __unrolled_list_iterator_base& __other) const {
+            return node_ptr == __other.node_ptr && idx == __other.idx;
+        }
+
+        bool operator!=(const __unrolled_list_iterator_base& __other) const {
+            return !operator==(__other);
+        }
+    };
+
+    template <typename _Tp, size_t N>
+    struct __unrolled_list_iterator: public __unrolled_list_iterator_base<_Tp, N> {
+        using pointer = _Tp*;
+        using reference = _Tp&;
+        using __iterator_base = __unrolled_list_iterator_base<_Tp, N>;
+
+        __unrolled_list_iterator(typename __iterator_base::__node_ptr_type __node_ptr, size_t __idx):
+            __iterator_base(__node_ptr, __idx) {}
+        __unrolled_list_iterator(): __iterator_base() {}
+
+        reference operator*() const {
+            return this -> node_ptr -> data()[this -> idx];
+        }
+
+        pointer operator->() const {
+            return this -> node_ptr -> data() + this -> idx;
+        }
+
+        __unrolled_list_iterator& operator++() {
+            this -> __incr();
+            return *this;
+        }
+
+        __unrolled_list_iterator operator++(int) {
+            __unrolled_list_iterator _temp(*this);
+            this -> __incr();
+            return _temp;
+        }
+
+        __unrolled_list_iterator& operator--() {
+            this -> __decr();
+            return *this;
+        }
+
+        __unrolled_list_iterator operator--(int) {
+            __unrolled_list_iterator _temp(*this);
+            this -> __decr();
+            return _temp;
+        }
+    };
+
+    template <typename _Tp, size_t N>
+    struct __unrolled_list_const_iterator: public __unrolled_list_iterator_base<_Tp, N> {
+        using pointer = const _Tp*;
+        using reference = const _Tp&;
+        using __iterator_base = __unrolled_list_iterator_base<_Tp, N>;
+
+        __unrolled_list_const_iterator(typename __iterator_base::__node_ptr_type __node_ptr, size_t __idx):
+            __iterator_base(__node_ptr, __idx) {}
+        __unrolled_list_const_iterator(): __iterator_base() {}
+
+        //implicit conversion from plain iterator
+        __unrolled_list_const_iterator(const __unrolled_list_iterator<_Tp, N>& other):
+            __iterator_base(other.node_ptr, other.idx) {}
+
+        reference operator*() const {
+            return this -> node_ptr -> data()[this -> idx];
+        }
+
+        pointer operator->() const {
+            return this -> node_ptr -> data() + this -> idx;
+        }
+
+        __unrolled_list_const_iterator& operator++() {
+            this -> __incr();
+            return *this;
+        }
+
+        __unrolled_list_const_iterator operator++(int) {
+            __unrolled_list_const_iterator _temp(*this);
+            this -> __incr();
+            return _temp;
+        }
+
+        __unrolled_list_const_iterator& operator--() {
+            this -> __decr();
+            return *this;
+        }
+
+        __unrolled_list_const_iterator operator--(int) {
+            __unrolled_list_const_iterator _temp(*this);
+            this -> __decr();
+            return _temp;
+        }
+    };
+
+    //the same interface as list, but the elements are packed N to a node
+    //the price is on iterator stability: an insert or erase may shift the elements of the
+    //node it touches (or split the node, or merge it into a neighbour), the iterators to
+    //that node are invalid afterwards. The iterators to the other nodes stay valid. The same
+    //goes for splice, which only splits the nodes at the ends of the range, the nodes in
+    //between are relinked as they are. merge and sort move the elements
+    template <typename _Tp, size_t N = __unrolled_list_default_size<_Tp>::value,
+             typename Alloc = __malloc_alloc<0>>
+    class unrolled_list {
+        static_assert(N > 0, "an unrolled list node has to hold at least one element");
+
+        public:
+            using iterator = __unrolled_list_iterator<_Tp, N>;
+            using const_iterator = __unrolled_list_const_iterator<_Tp, N>;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using value_type = _Tp;
+            using pointer = _Tp*;
+            using const_pointer = const _Tp*;
+            using reference = _Tp&;
+            using const_reference = const _Tp&;
+
+            using reverse_iterator = my_stl::reverse_iterator<iterator>;
+            using const_reverse_iterator = my_stl::reverse_iterator<const_iterator>;
+
+        protected:
+            using __node = __unrolled_list_node<_Tp, N>;
+            using __node_ptr = __node*;
+
+            //the end node and the allocator, as in list
+            compressed_pair<__node_ptr, Alloc> __end_and_alloc;
+            size_type __size;
+            using data_allocator = my_simple_alloc<__node, Alloc>;
+
+            __node_ptr& __end() noexcept {return __end_and_alloc.first();}
+            __node_ptr __end() const noexcept {return __end_and_alloc.first();}
+            Alloc& __alloc() noexcept {return __end_and_alloc.second();}
+
+            __node_ptr __get_node() {
+                __node_ptr p = data_allocator::allocate(__alloc(), 1);
+                p -> count = 0;
+                return p;
+            }
+
+            void __put_node(__node_ptr p) noexcept {
+                data_allocator::deallocate(__alloc(), p, 1);
+            }
+
+            //a list moved from has no end node, it is made again on the first insert, and
+            //until then a null position is its end
+            __node_ptr __end_node() {
+                if (!__end()) {
+                    __end() = __get_node();
+                    __end() -> next = __end() -> prev = __end();
+                }
+                return __end();
+            }
+
+            //an empty node linked in front of position
+            __node_ptr __new_node_before(__node_ptr __position) {
+                __node_ptr p = __get_node();
+                __link_nodes(__position, p, p);
+                return p;
+            }
+
+            //unlink and free a node with no elements left
+            void __drop_node(__node_ptr p) noexcept {
+                __unlink_nodes(p, p);
+                __put_node(p);
+            }
+
+            iterator __normalize(__node_ptr n, size_type i) noexcept {
+                return i == n -> count ? iterator(n -> next, 0) : iterator(n, i);
+            }
+
+            //move [k, count) of n to a new node right after n, which is returned
+            __node_ptr __split(__node_ptr n, size_type k) {
+                __node_ptr m = __get_node();
+                try {
+                    my_stl::uninitialized_move(n -> data() + k, n -> data() + n -> count, m -> data());
+                }
+                catch (...) {
+                    __put_node(m);
+                    throw;
+                }
+                my_stl::destroy(n -> data() + k, n -> data() + n -> count);
+                m -> count = n -> count - k;
+                n -> count = k;
+                __link_nodes(n -> next, m, m);
+                return m;
+            }
+
+            //split the node of at so that at is the first element of a node, the iterators
+            //o1 and o2 are updated if their elements are moved
+            void __isolate(iterator& at, iterator& o1, iterator& o2) {
+                if (at.idx == 0)    return;
+                __node_ptr n = at.node_ptr;
+                size_type k = at.idx;
+                __node_ptr m = __split(n, k);
+                if (o1.node_ptr == n && o1.idx >= k)    o1 = iterator(m, o1.idx - k);
+                if (o2.node_ptr == n && o2.idx >= k)    o2 = iterator(m, o2.idx - k);
+                at = iterator(m, 0);
+            }
+
+            //move the elements of the next node to the back of n
+            void __coalesce(__node_ptr n) {
+                __node_ptr m = n -> next;
+                my_stl::uninitialized_move(m -> data(), m -> data() + m -> count, n -> data() + n -> count);
+                my_stl::destroy(m -> data(), m -> data() + m -> count);
+                n -> count += m -> count;
+                __drop_node(m);
+            }
+
+            //remove [first, last) of the elements in n, the size is left to the caller
+            void __erase_in_node(__node_ptr n, size_type first, size_type last) {
+                _Tp* d = n -> data();
+                _Tp* new_end = my_stl::move(d + last, d + n -> count, d + first);
+                my_stl::destroy(new_end, d + n -> count);
+                n -> count -= last - first;
+            }
+
+            //the position following an erase at (n, i), a node left empty is freed, and
+            //one that gets too sparse is merged with a neighbour (only when moving can not
+            //throw, erase should not fail half way)
+            iterator __after_erase(__node_ptr n, size_type i) {
+                if (n -> count == 0) {
+                    __node_ptr next = n -> next;
+                    __drop_node(n);
+                    return iterator(next, 0);
+                }
+                if (is_nothrow_move_constructible<_Tp>::value && n -> count < N / 4) {
+                    __node_ptr p = n -> prev;
+                    if (n -> next != __end() && n -> count + n -> next -> count <= N) {
+                        __coalesce(n);
+                    }
+                    else if (p != __end() && p -> count + n -> count <= N) {
+                        i += p -> count;
+                        __coalesce(p);
+                        n = p;
+                    }
+                }
+                return __normalize(n, i);
+            }
+
+            //emplace in front of the i-th element of n
+            template <typename... Args>
+            iterator __emplace(__node_ptr n, size_type i, Args&&... args);
+
+            //a sorted run of elements for merge and sort, a chain of nodes linked through
+            //next only and ended by null
+            struct __run {
+                __node_ptr head;
+                __node_ptr tail;
+            };
+
+            //where a merge reads a run: the elements [i, e) of node, then the nodes from next on
+            struct __cursor {
+                __node_ptr node;
+                size_type i;
+                size_type e;
+                __node_ptr next;
+
+                void __set(__node_ptr n) noexcept {
+                    node = n;
+                    if (n) {
+                        i = 0;
+                        e = n -> count;
+                        next = n -> next;
+                    }
+                }
+            };
+
+            //all the nodes as a run, the end node is left alone
+            __run __detach() noexcept {
+                __run r{__end() -> next, __end() -> prev};
+                r.tail -> next = nullptr;
+                __end() -> next = __end() -> prev = __end();
+                return r;
+            }
+
+            //hang the run from the end node again, setting prev, the elements are counted
+            size_type __hang(const __run& r) noexcept {
+                size_type n = 0;
+                __node_ptr prev = __end();
+                __end() -> next = r.head;
+                for (__node_ptr p = r.head; p; p = p -> next) {
+                    p -> prev = prev;
+                    n += p -> count;
+                    prev = p;
+                }
+                prev -> next = __end();
+                __end() -> prev = prev;
+                return n;
+            }
+
+            //two free nodes linked through next, all a merge needs besides the nodes it drains
+            __node_ptr __get_spares() {
+                __node_ptr p = __get_node();
+                try {
+                    p -> next = __get_node();
+                }
+                catch (...) {
+                    __put_node(p);
+                    throw;
+                }
+                p -> next -> next = nullptr;
+                return p;
+            }
+
+            void __put_nodes(__node_ptr p) noexcept {
+                while (p) {
+                    __node_ptr next = p -> next;
+                    __put_node(p);
+                    p = next;
+                }
+            }
+
+            //move [i, e) of n to the front, only used to clean up after an exception so a move
+            //that throws loses the elements not moved yet. The new count is returned
+            static size_type __pack(__node_ptr n, size_type i, size_type e) noexcept;
+
+            //merge run b into run a, b is left empty. If comp throws a still holds all the
+            //elements, in some order
+            template <typename _Comp>
+            static void __merge_runs(__run& a, __run& b, __node_ptr& __spares, _Comp& comp);
+
+            //insertion sort of the elements of one node, only swaps so no element is lost
+            //when the comparison throws
+            template <typename _Comp>
+            static void __insertion_sort(_Tp* first, _Tp* last, _Comp comp);
+
+            template <typename _Integer>
+            iterator __insert_dispatch(const_iterator __position, _Integer i1,
+                    _Integer i2, __true_type);
+
+            template<typename _InputIterator>
+            iterator __insert_dispatch(const_iterator __position, _InputIterator first,
+                    _InputIterator last, __false_type);
+
+        public:
+            //------------------------Constructors------------------------------
+            unrolled_list();
+
+            explicit unrolled_list(const Alloc& __a);
+
+            explicit unrolled_list(size_type n);
+
+            unrolled_list(size_type n, const value_type& val);
+
+            unrolled_list(const unrolled_list& x);
+
+            unrolled_list(unrolled_list&& x) noexcept;
+
+            unrolled_list(std::initializer_list<value_type> il);
+
+            template<typename InputIterator>
+            unrolled_list(InputIterator first, InputIterator last);
+
+            unrolled_list& operator=(const unrolled_list& x) {
+                unrolled_list temp(x);
+                swap(temp);
+                return *this;
+            }
+
+            unrolled_list& operator=(unrolled_list&& x) noexcept(__is_nothrow_joinable<Alloc>::value) {
+                if (this == &x) return *this;
+                if (!__end()) {
+                    //moved from, so x hands over its end node too, as to the move constructor
+                    if (x.__end())  __join_allocators(__alloc(), x.__alloc());
+                    __end() = x.__end();
+                    __size = x.__size;
+                    x.__end() = nullptr;
+                    x.__size = 0;
+                    return *this;
+                }
+                //joined before anything is freed, as in list
+                if (x.size())   __join_allocators(__alloc(), x.__alloc());
+                clear();
+                splice(cend(), x);
+                return *this;
+            }
+
+            unrolled_list& operator=(std::initializer_list<value_type> il) {
+                assign(il.begin(), il.end());
+                return *this;
+            }
+
+            ~unrolled_list() {
+                if (__end()) {
+                    clear();
+                    __put_node(__end());
+                }
+            }
+
+            //--------------------------------iterators----------------------------------//
+            iterator begin() noexcept {
+                return iterator(__end() ? __end() -> next : nullptr, 0);
+            }
+
+            const_iterator begin() const noexcept {
+                return const_iterator(__end() ? __end() -> next : nullptr, 0);
+            }
+
+            iterator end() noexcept {
+                return iterator(__end(), 0);
+            }
+
+            const_iterator end() const noexcept {
+                return const_iterator(__end(), 0);
+            }
+
+            const_iterator cbegin() const noexcept {
+                return begin();
+            }
+
+            const_iterator cend() const noexcept {
+                return end();
+            }
+
+            reverse_iterator rbegin() noexcept {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const noexcept {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() noexcept {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const noexcept {
+                return const_reverse_iterator(begin());
+            }
+
+            const_reverse_iterator crbegin() const noexcept {
+                return rbegin();
+            }
+
+            const_reverse_iterator crend() const noexcept {
+                return rend();
+            }
+
+            //------------------------------element access------------------------------------
+            reference front() {
+                return *begin();
+            }
+
+            const_reference front() const {
+                return *cbegin();
+            }
+
+            reference back() {
+                __node_ptr last = __end() -> prev;
+                return last -> data()[last -> count - 1];
+            }
+
+            const_reference back() const {
+                __node_ptr last = __end() -> prev;
+                return last -> data()[last -> count - 1];
+            }
+
+            bool empty() const noexcept {
+                return __size == 0;
+            }
+
+            size_type size() const noexcept {
+                return __size;
+            }
+
+            size_type max_size() const noexcept {
+                return size_type(-1);
+            }
+
+            Alloc get_allocator() const {return __end_and_alloc.second();}
+
+            void swap(unrolled_list& other) noexcept {
+                __end_and_alloc.swap(other.__end_and_alloc);
+                size_type temp_size = __size;
+                __size = other.__size;
+                other.__size = temp_size;
+            }
+
+            void clear() noexcept {
+                if (!__end())   return;
+                __node_ptr n = __end() -> next;
+                while (n != __end()) {
+                    __node_ptr next = n -> next;
+                    my_stl::destroy(n -> data(), n -> data() + n -> count);
+                    __put_node(n);
+                    n = next;
+                }
+                __end() -> prev = __end() -> next = __end();
+                __size = 0;
+            }
+
+            //hand the memory kept for freed nodes back, only a node pool keeps any
+            void shrink_to_fit() noexcept {
+                __shrink_allocator(__alloc());
+            }
+
+            template<typename InputIterator>
+            void assign(InputIterator first, InputIterator last) {
+                clear();
+                insert(cend(), first, last);
+            }
+
+            void assign(size_type n, const value_type& val) {
+                clear();
+                insert(cend(), n, val);
+            }
+
+            //-------------------------Insert and erase --------------------------------------
+            template <typename... Args>
+            iterator emplace(const_iterator __position, Args&&... args) {
+                return __emplace(__position.node_ptr, __position.idx, std::forward<Args>(args)...);
+            }
+
+            iterator insert(const_iterator __position, const value_type& value) {
+                return __emplace(__position.node_ptr, __position.idx, value);
+            }
+
+            iterator insert(const_iterator __position, value_type&& value) {
+                return __emplace(__position.node_ptr, __position.idx, std::move(value));
+            }
+
+            iterator insert(const_iterator __position, size_type n, const value_type& val);
+
+            template <typename InputIterator>
+            iterator insert(const_iterator __position, InputIterator first, InputIterator last) {
+                return __insert_dispatch(__position, first, last,
+                        typename is_integer<InputIterator>::type());
+            }
+
+            iterator insert(const_iterator __position, std::initializer_list<value_type> il) {
+                return insert(__position, il.begin(), il.end());
+            }
+
+            iterator erase(const_iterator __position);
+
+            iterator erase(const_iterator __first, const_iterator __last);
+
+            void push_back(const value_type& value) {
+                __emplace(__end(), 0, value);
+            }
+
+            void push_back(value_type&& value) {
+                __emplace(__end(), 0, std::move(value));
+            }
+
+            void push_front(const value_type& value) {
+                __emplace(begin().node_ptr, 0, value);
+            }
+
+            void push_front(value_type&& value) {
+                __emplace(begin().node_ptr, 0, std::move(value));
+            }
+
+            template <typename... Args>
+            void emplace_back(Args&&... args) {
+                __emplace(__end(), 0, std::forward<Args>(args)...);
+            }
+
+            template <typename... Args>
+            void emplace_front(Args&&... args) {
+                __emplace(begin().node_ptr, 0, std::forward<Args>(args)...);
+            }
+
+            void pop_back() {
+                erase(--cend());
+            }
+
+            void pop_front() {
+                erase(cbegin());
+            }
+
+            //remove the same value
+            void remove(const value_type& value);
+
+            //unique will remove all the adjacent duplicate values
+            void unique();
+
+            //-----------------------------Splice operation--------------------------
+            //unlike list, splice may split a node, so it may throw
+            void splice(const_iterator __position, unrolled_list& __other);
+
+            void splice(const_iterator __position, unrolled_list&& __other) {
+                splice(__position, __other);
+            }
+
+            void splice(const_iterator __position, unrolled_list& __other, const_iterator __i);
+
+            void splice(const_iterator __position, unrolled_list&& __other, const_iterator __i) {
+                splice(__position, __other, __i);
+            }
+
+            void splice(const_iterator __position, unrolled_list& __other,
+                    const_iterator __first, const_iterator __last);
+
+            void splice(const_iterator __position, unrolled_list&& __other,
+                    const_iterator __first, const_iterator __last) {
+                splice(__position, __other, __first, __last);
+            }
+
+            //-------------------------Merge and sort ------------------------------------
+            void merge(unrolled_list& x) {
+                merge(x, less<_Tp>());
+            }
+
+            template<typename _Comp>
+            void merge(unrolled_list& x, _Comp comp);
+
+            void sort() {
+                sort(less<_Tp>());
+            }
+
+            template<typename _Comp>
+            void sort(_Comp comp);
+    };
+
+    //the nodes all live on the heap as for list
+    template <typename _Tp, size_t N, typename Alloc>
+    struct is_trivially_relocatable<unrolled_list<_Tp, N, Alloc>>: __is_relocatable_alloc<Alloc> {};
+
+    template <typename _Tp, size_t N, typename Alloc>
+    void swap(unrolled_list<_Tp, N, Alloc>& lhs, unrolled_list<_Tp, N, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    inline bool operator==(const unrolled_list<_Tp, N, Alloc>& lhs, const unrolled_list<_Tp, N, Alloc>& rhs) {
+        if (lhs.size() != rhs.size())   return false;
+        auto _it1 = lhs.cbegin();
+        auto _it2 = rhs.cbegin();
+        for (; _it1 != lhs.cend(); ++_it1, ++_it2) {
+            if (!(*_it1 == *_it2))  return false;
+        }
+        return true;
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    inline bool operator!=(const unrolled_list<_Tp, N, Alloc>& lhs, const unrolled_list<_Tp, N, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    //------------------------------------------------------------------------
+    //-----------------------------Constructors------------------------------
+    //------------------------------------------------------------------------
+    template <typename _Tp, size_t N, typename Alloc>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(): __end_and_alloc(nullptr), __size(0) {
+        __end() = __get_node();
+        __end() -> next = __end() -> prev = __end();
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(const Alloc& __a): __end_and_alloc(nullptr, __a), __size(0) {
+        __end() = __get_node();
+        __end() -> next = __end() -> prev = __end();
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(size_type n): unrolled_list() {
+        insert(cend(), n, _Tp());
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(size_type n, const value_type& val): unrolled_list() {
+        insert(cend(), n, val);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(const unrolled_list& x): unrolled_list() {
+        insert(cend(), x.cbegin(), x.cend());
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(unrolled_list&& x) noexcept:
+            __end_and_alloc(x.__end(), x.__alloc()), __size(x.__size) {
+        x.__end() = nullptr;
+        x.__size = 0;
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(std::initializer_list<value_type> il): unrolled_list() {
+        insert(cend(), il.begin(), il.end());
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename InputIterator>
+    unrolled_list<_Tp, N, Alloc>::unrolled_list(InputIterator first, InputIterator last): unrolled_list() {
+        insert(cend(), first, last);
+    }
+
+    //--------------------------------------------------------------------------------
+    //-------------------------Insert operation --------------------------------------
+    //--------------------------------------------------------------------------------
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename... Args>
+    typename unrolled_list<_Tp, N, Alloc>::iterator
+    unrolled_list<_Tp, N, Alloc>::__emplace(__node_ptr n, size_type i, Args&&... args) {
+        if (!n) n = __end_node();
+        if (i == 0 && n -> prev != __end() && n -> prev -> count < N) {
+            //in front of a node, the previous node has room at its back
+            n = n -> prev;
+            i = n -> count;
+        }
+        else if (n == __end() || (i == 0 && n -> count == N)) {
+            n = __new_node_before(n);
+        }
+        if (i == n -> count) {
+            //at the back of a node, nothing has to move
+            try {
+                construct(n -> data() + i, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                if (n -> count == 0)    __drop_node(n);
+                throw;
+            }
+            ++n -> count;
+            ++__size;
+            return iterator(n, i);
+        }
+        //the value is built first, args may refer to an element we are about to move
+        _Tp __tmp(std::forward<Args>(args)...);
+        if (n -> count == N) {
+            //a full node, half of it goes to a new node
+            __node_ptr m = __split(n, N / 2);
+            if (i > N / 2) {
+                n = m;
+                i -= N / 2;
+            }
+        }
+        _Tp* d = n -> data();
+        size_type c = n -> count;
+        if (i == c) {
+            construct(d + i, std::move(__tmp));
+        }
+        else {
+            //shift [i, c) one to the back
+            construct(d + c, std::move(d[c - 1]));
+            my_stl::move_backward(d + i, d + c - 1, d + c);
+            d[i] = std::move(__tmp);
+        }
+        n -> count = c + 1;
+        ++__size;
+        return iterator(n, i);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    typename unrolled_list<_Tp, N, Alloc>::iterator
+    unrolled_list<_Tp, N, Alloc>::insert(const_iterator __position, size_type n, const value_type& val) {
+        if (n == 0) return iterator(__position.node_ptr, __position.idx);
+        //all of them are the same, so each goes in front of the last one, which is copied
+        //as val may be an element moved by the inserts
+        iterator res = insert(__position, val);
+        for (; n > 1; --n) {
+            res = insert(res, *res);
+        }
+        return res;
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename _Integer>
+    inline typename unrolled_list<_Tp, N, Alloc>::iterator
+    unrolled_list<_Tp, N, Alloc>::__insert_dispatch(const_iterator __position, _Integer _i1, _Integer _i2,
+                __true_type) {
+        return insert(__position, (size_type) _i1, _i2);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename InputIterator>
+    typename unrolled_list<_Tp, N, Alloc>::iterator
+    unrolled_list<_Tp, N, Alloc>::__insert_dispatch(const_iterator __position, InputIterator first,
+            InputIterator last, __false_type) {
+        //an insert may move the element at __position, follow it through the returned iterator
+        iterator pos(__position.node_ptr, __position.idx);
+        size_type n = 0;
+        for (; first != last; ++first, ++n) {
+            pos = insert(pos, *first);
+            ++pos;
+        }
+        for (; n > 0; --n) {
+            --pos;
+        }
+        return pos;
+    }
+
+    //--------------------------------------------------------------------------------
+    //-------------------------Erase operation --------------------------------------
+    //--------------------------------------------------------------------------------
+    template <typename _Tp, size_t N, typename Alloc>
+    typename unrolled_list<_Tp, N, Alloc>::iterator
+    unrolled_list<_Tp, N, Alloc>::erase(const_iterator __position) {
+        __node_ptr n = __position.node_ptr;
+        size_type i = __position.idx;
+        __erase_in_node(n, i, i + 1);
+        --__size;
+        return __after_erase(n, i);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    typename unrolled_list<_Tp, N, Alloc>::iterator
+    unrolled_list<_Tp, N, Alloc>::erase(const_iterator __first, const_iterator __last) {
+        __node_ptr n = __first.node_ptr;
+        __node_ptr l = __last.node_ptr;
+        if (__first == __last)  return iterator(l, __last.idx);
+        size_type i = __first.idx;
+        if (n == l) {
+            __erase_in_node(n, i, __last.idx);
+            __size -= __last.idx - i;
+            return __after_erase(n, i);
+        }
+        //the back of the first node, the nodes in between, the front of the last node
+        __size -= n -> count - i;
+        __erase_in_node(n, i, n -> count);
+        for (__node_ptr m = n -> next; m != l;) {
+            __node_ptr next = m -> next;
+            __size -= m -> count;
+            my_stl::destroy(m -> data(), m -> data() + m -> count);
+            __drop_node(m);
+            m = next;
+        }
+        if (__last.idx) {
+            __erase_in_node(l, 0, __last.idx);
+            __size -= __last.idx;
+        }
+        if (n -> count == 0)    __drop_node(n);
+        return iterator(l, 0);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    void unrolled_list<_Tp, N, Alloc>::remove(const value_type& value) {
+        //value may be one of our elements
+        if (empty())    return;
+        const value_type __v(value);
+        for (__node_ptr n = __end() -> next; n != __end();) {
+            //compact the node in place, keeping the elements not equal to value
+            _Tp* d = n -> data();
+            size_type keep = 0;
+            for (size_type j = 0; j < n -> count; ++j) {
+                if (d[j] == __v)    continue;
+                if (keep != j)  d[keep] = std::move(d[j]);
+                ++keep;
+            }
+            my_stl::destroy(d + keep, d + n -> count);
+            __size -= n -> count - keep;
+            n -> count = keep;
+            __node_ptr next = n -> next;
+            if (keep == 0)  __drop_node(n);
+            n = next;
+        }
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    void unrolled_list<_Tp, N, Alloc>::unique() {
+        //the last element kept, it may be in a node we have finished
+        if (empty())    return;
+        _Tp* __last_kept = nullptr;
+        for (__node_ptr n = __end() -> next; n != __end();) {
+            _Tp* d = n -> data();
+            size_type keep = 0;
+            for (size_type j = 0; j < n -> count; ++j) {
+                if (__last_kept && *__last_kept == d[j])    continue;
+                if (keep != j)  d[keep] = std::move(d[j]);
+                __last_kept = d + keep;
+                ++keep;
+            }
+            my_stl::destroy(d + keep, d + n -> count);
+            __size -= n -> count - keep;
+            n -> count = keep;
+            __node_ptr next = n -> next;
+            if (keep == 0)  __drop_node(n);
+            n = next;
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    //-------------------------Splice operation --------------------------------------
+    //--------------------------------------------------------------------------------
+    template <typename _Tp, size_t N, typename Alloc>
+    void unrolled_list<_Tp, N, Alloc>::splice(const_iterator __pos, unrolled_list& __x) {
+        if (__x.empty() || this == &__x)    return;
+        __join_allocators(__alloc(), __x.__alloc());
+        __node_ptr at = __pos.idx ? __split(__pos.node_ptr, __pos.idx)
+                : __pos.node_ptr ? __pos.node_ptr : __end_node();
+        __node_ptr first = __x.__end() -> next;
+        __node_ptr last = __x.__end() -> prev;
+        __unlink_nodes(first, last);
+        __link_nodes(at, first, last);
+        __size += __x.__size;
+        __x.__size = 0;
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    void unrolled_list<_Tp, N, Alloc>::splice(const_iterator __pos, unrolled_list& __x, const_iterator __i) {
+        const_iterator __j = __i;
+        ++__j;
+        //already in place
+        if (__pos == __i || __pos == __j)   return;
+        splice(__pos, __x, __i, __j);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    void unrolled_list<_Tp, N, Alloc>::splice(const_iterator __pos, unrolled_list& __x,
+            const_iterator __first, const_iterator __last) {
+        if (__first == __last)  return;
+        if (this != &__x)   __join_allocators(__alloc(), __x.__alloc());
+        iterator p(__pos.node_ptr ? __pos.node_ptr : __end_node(), __pos.idx);
+        iterator f(__first.node_ptr, __first.idx);
+        iterator l(__last.node_ptr, __last.idx);
+        //split the nodes so that the range is made of whole nodes [f.node_ptr, l.node_ptr)
+        __x.__isolate(l, f, p);
+        __x.__isolate(f, l, p);
+        __isolate(p, f, l);
+        if (this != &__x) {
+            size_type n = 0;
+            for (__node_ptr m = f.node_ptr; m != l.node_ptr; m = m -> next) {
+                n += m -> count;
+            }
+            __x.__size -= n;
+            __size += n;
+        }
+        if (p.node_ptr != l.node_ptr) {
+            __transfer(p.node_ptr, f.node_ptr, l.node_ptr);
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    //-------------------------Merge and sort --------------------------------------
+    //--------------------------------------------------------------------------------
+    template <typename _Tp, size_t N, typename Alloc>
+    typename unrolled_list<_Tp, N, Alloc>::size_type
+    unrolled_list<_Tp, N, Alloc>::__pack(__node_ptr n, size_type i, size_type e) noexcept {
+        if (i == 0) return e;
+        _Tp* d = n -> data();
+        size_type k = 0;
+        try {
+            for (; i < e; ++i, ++k) {
+                construct(d + k, std::move(d[i]));
+                destroy(d + i);
+            }
+        }
+        catch (...) {
+            my_stl::destroy(d + i, d + e);
+        }
+        return k;
+    }
+
+    //the elements taken go to the back of a node drained earlier, every node taken from the
+    //spares is made up for by a node drained before it fills: merging the first N elements
+    //drains at least one node less than that only if a and b each still hold part of one,
+    //which two spares cover. So __spares never runs out, and holds at least two nodes again
+    //at the end
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename _Comp>
+    void unrolled_list<_Tp, N, Alloc>::__merge_runs(__run& a, __run& b, __node_ptr& __spares,
+            _Comp& comp) {
+        if (!b.head)    return;
+        if (!a.head) {
+            a = b;
+            b = __run();
+            return;
+        }
+        __cursor ca, cb;
+        ca.__set(a.head);
+        cb.__set(b.head);
+        const __node_ptr tail_a = a.tail, tail_b = b.tail;
+        __node_ptr head = nullptr, tail = nullptr;      //the nodes filled so far
+        __node_ptr fill = nullptr;                      //the node being filled
+        auto __link = [&](__node_ptr n) {
+            if (tail)   tail -> next = n;
+            else    head = n;
+            tail = n;
+        };
+        //move the next element of c to the back of fill, its node is free once it is empty
+        auto __take = [&](__cursor& c) {
+            if (fill -> count == N) {
+                __link(fill);
+                fill = __spares;
+                __spares = fill -> next;
+                fill -> count = 0;
+            }
+            _Tp* src = c.node -> data() + c.i;
+            construct(fill -> data() + fill -> count, std::move(*src));
+            ++fill -> count;
+            destroy(src);
+            if (++c.i == c.e) {
+                __node_ptr done = c.node;
+                c.__set(c.next);
+                done -> next = __spares;
+                __spares = done;
+            }
+        };
+        //what is left of c: its elements in the node moved to the front, then the nodes after
+        auto __link_rest = [&](__cursor& c, __node_ptr run_tail) {
+            if (!c.node)    return;
+            c.node -> count = __pack(c.node, c.i, c.e);
+            if (c.node -> count) {
+                __link(c.node);
+            }
+            else {
+                c.node -> next = __spares;
+                __spares = c.node;
+            }
+            if (c.next) {
+                __link(c.next);
+                tail = run_tail;
+            }
+        };
+        auto __link_fill = [&]() {
+            if (!fill)  return;
+            if (fill -> count) {
+                __link(fill);
+            }
+            else {
+                fill -> next = __spares;
+                __spares = fill;
+            }
+            fill = nullptr;
+        };
+        try {
+            //already in order, or b goes first as a whole, nothing has to move
+            if (!comp(cb.node -> data()[0], tail_a -> data()[tail_a -> count - 1])) {
+                tail_a -> next = b.head;
+                a.tail = tail_b;
+                b = __run();
+                return;
+            }
+            if (comp(tail_b -> data()[tail_b -> count - 1], ca.node -> data()[0])) {
+                tail_b -> next = a.head;
+                a.head = b.head;
+                b = __run();
+                return;
+            }
+            fill = __spares;
+            __spares = fill -> next;
+            fill -> count = 0;
+            while (ca.node && cb.node) {
+                //take from b only if it is strictly less, so the merge is stable
+                if (comp(cb.node -> data()[cb.i], ca.node -> data()[ca.i]))  __take(cb);
+                else    __take(ca);
+            }
+            //the rest of the node we stopped in is moved, the nodes after it stay as they are
+            __cursor& r = ca.node ? ca : cb;
+            if (r.i != 0) {
+                for (__node_ptr n = r.node; r.node == n; ) __take(r);
+            }
+        }
+        catch (...) {
+            __link_fill();
+            __link_rest(ca, tail_a);
+            __link_rest(cb, tail_b);
+            tail -> next = nullptr;
+            a = __run{head, tail};
+            b = __run();
+            throw;
+        }
+        __link_fill();
+        __link_rest(ca, tail_a);
+        __link_rest(cb, tail_b);
+        tail -> next = nullptr;
+        a = __run{head, tail};
+        b = __run();
+    }
+
+    //the runs are merged into the nodes they free, two spare nodes are taken first so
+    //nothing is allocated once the elements start moving. If comp throws all the elements
+    //are left here
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename _Comp>
+    void unrolled_list<_Tp, N, Alloc>::merge(unrolled_list& _x, _Comp comp) {
+        if (this == &_x || _x.empty())  return;
+        __join_allocators(__alloc(), _x.__alloc());
+        if (empty()) {
+            splice(cend(), _x);
+            return;
+        }
+        __node_ptr __spares = __get_spares();
+        const size_type n = _x.__size;
+        __run _a = __detach();
+        __run _b = _x.__detach();
+        _x.__size = 0;
+        try {
+            __merge_runs(_a, _b, __spares, comp);
+        }
+        catch (...) {
+            __size = __hang(_a);
+            __put_nodes(__spares);
+            throw;
+        }
+        __hang(_a);
+        __size += n;
+        __put_nodes(__spares);
+    }
+
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename _Comp>
+    void unrolled_list<_Tp, N, Alloc>::__insertion_sort(_Tp* first, _Tp* last, _Comp comp) {
+        using std::swap;
+        for (_Tp* cur = first; cur != last; ++cur) {
+            for (_Tp* j = cur; j != first && comp(*j, *(j - 1)); --j) {
+                swap(*j, *(j - 1));
+            }
+        }
+    }
+
+    //the bottom-up merge sort of list, but the runs start as whole nodes sorted in place
+    //and the counters are runs of nodes, the merges work on the chain as in merge
+    template <typename _Tp, size_t N, typename Alloc>
+    template <typename _Comp>
+    void unrolled_list<_Tp, N, Alloc>::sort(_Comp comp) {
+        if (__size <= 1)    return;
+        __node_ptr n = __end() -> next;
+        if (n -> next == __end()) {
+            __insertion_sort(n -> data(), n -> data() + n -> count, comp);
+            return;
+        }
+        __node_ptr __spares = __get_spares();
+        __run _rest = __detach();
+        __run _carry = __run();
+        __run _counter[64] = {};
+        int _fill = 0;
+        try {
+            while (_rest.head) {
+                //take the first node
+                _carry.head = _carry.tail = _rest.head;
+                _rest.head = _rest.head -> next;
+                _carry.tail -> next = nullptr;
+                __insertion_sort(_carry.head -> data(), _carry.head -> data() + _carry.head -> count, comp);
+                //move up the ladder, the counters hold the older elements, they go first
+                int _level = 0;
+                for (; _level < _fill && _counter[_level].head; ++_level) {
+                    __merge_runs(_counter[_level], _carry, __spares, comp);
+                    _carry = _counter[_level];
+                    _counter[_level] = __run();
+                }
+                _counter[_level] = _carry;
+                _carry = __run();
+                if (_level == _fill)    ++_fill;
+            }
+            for (int _level = 1; _level < _fill; ++_level) {
+                __merge_runs(_counter[_level], _counter[_level - 1], __spares, comp);
+            }
+        }
+        catch (...) {
+            //a throwing comparison, all the runs are hung back one after the other
+            __run _all = _carry;
+            auto __append = [&](const __run& r) {
+                if (!r.head)    return;
+                if (_all.head)  _all.tail -> next = r.head;
+                else    _all.head = r.head;
+                _all.tail = r.tail;
+            };
+            for (int _level = 0; _level < _fill; ++_level) {
+                __append(_counter[_level]);
+            }
+            __append(_rest);
+            __size = __hang(_all);
+            __put_nodes(__spares);
+            throw;
+        }
+        __hang(_counter[_fill - 1]);
+        __put_nodes(__spares);
+    }
+}
+
+#endif
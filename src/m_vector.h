@@ -5,10 +5,49 @@
 
 #include "m_memory.h"  //for allocator
 #include "m_algobase.h"  //for copy function
+#include "m_unique_ptr.h"  //for compressed_pair
+#include "m_algorithm.h"  //for __rotate
+#include <stdexcept>  //for out_of_range
+#include <iostream>  //for the boundary error of the debug build
 //#include <stdio.h>
 
 namespace my_stl {
-    template <typename _Tp, typename Alloc = __malloc_alloc<0>>
+    //growth policies of vector: next<Alloc>(size, count, elem_size) is the capacity to grow to
+    //when count more elements don't fit in a vector of size elements, never below size + count.
+    //_Min is the first allocation, a vector of small objects can skip the 1, 2, 4.. steps
+
+    //twice the size, the default
+    template <size_t _Min = 1>
+    struct double_growth {
+        template <typename Alloc>
+        static size_t next(size_t size, size_t count, size_t) noexcept {
+            const size_t n = size + (count > size ? count : size);
+            return n < _Min ? _Min : n;
+        }
+    };
+
+    //1.5 times the size, less slack on big vectors for a few more reallocations
+    template <size_t _Min = 1>
+    struct one_and_half_growth {
+        template <typename Alloc>
+        static size_t next(size_t size, size_t count, size_t) noexcept {
+            const size_t n = size + (count > size / 2 ? count : size / 2);
+            return n < _Min ? _Min : n;
+        }
+    };
+
+    //_Base rounded up to the bytes Alloc hands out anyway, the tail of the block that would be
+    //wasted becomes capacity instead
+    template <typename _Base = double_growth<>>
+    struct size_class_growth {
+        template <typename Alloc>
+        static size_t next(size_t size, size_t count, size_t elem_size) noexcept {
+            const size_t n = _Base::template next<Alloc>(size, count, elem_size);
+            return __alloc_good_size<Alloc>(n * elem_size) / elem_size;
+        }
+    };
+
+    template <typename _Tp, typename Alloc = __malloc_alloc<0>, typename _Growth = double_growth<>>
     class vector {
         private:
             //three pointers pointed to the [start, last) and the end of the allocated memory
@@ -18,9 +57,12 @@ namespace my_stl {
             // start                  last    end of storage
             _Tp* start;
             _Tp* last;
-            _Tp* end_of_storage;
-            //allocator for memory management
-            new_allocator<_Tp> data_allocator;
+            //the end of storage is kept together with the allocator instance, all the allocators
+            //in the library are empty classes so the pair takes no more than the pointer itself,
+            //a stateful allocator (arena etc.) is stored here as well
+            compressed_pair<_Tp*, Alloc> __end_and_alloc;
+            //all the storage goes through Alloc, which deals in bytes
+            using data_allocator = my_simple_alloc<_Tp, Alloc>;
             
         public:
             //all the nested data type
@@ -33,11 +75,25 @@ namespace my_stl {
             typedef const _Tp& const_reference;
             typedef size_t size_type;
             typedef ptrdiff_t difference_type;
+            typedef Alloc allocator_type;
             //followings are interfaces required by STL standard
         private:
+            _Tp*& end_of_storage() noexcept {return __end_and_alloc.first();}
+            _Tp* end_of_storage() const noexcept {return __end_and_alloc.first();}
+            Alloc& __alloc() noexcept {return __end_and_alloc.second();}
+
+            //raw storage for n objects from our allocator instance, nothing for n == 0
+            iterator __allocate(size_type n) {
+                return n ? data_allocator::allocate(__alloc(), n) : nullptr;
+            }
+
+            void __deallocate(iterator p, size_type n) noexcept {
+                if (p) data_allocator::deallocate(__alloc(), p, n);
+            }
+
             // helper function to allocate n object and initialize it by default value
             iterator allocate_and_fill(size_type n, const _Tp& value) {
-                iterator res = data_allocator.allocate(n);
+                iterator res = __allocate(n);
                 my_stl::uninitialized_fill (res, res + n, value);
                 return res;
             }
@@ -45,24 +101,201 @@ namespace my_stl {
             void deallocate() noexcept {
                 if (!start) return;
                 destroy(start, last);
-                data_allocator.deallocate(start, end_of_storage - start);
+                __deallocate(start, end_of_storage() - start);
             }
            
             //initialize all the data member field
             void fill_initialize (size_type n, const _Tp& value) {
                 start = allocate_and_fill(n, value);
-                end_of_storage = last = start + n;
+                end_of_storage() = last = start + n;
+            }
+
+            //the capacity we grow to when there is no room for count more elements
+            size_type __next_capacity(size_type count = 1) const noexcept {
+                return _Growth::template next<Alloc>(size(), count, sizeof(_Tp));
+            }
+
+            //the element type can be moved around by memcpy, no ctor or dtor involved
+            typedef typename is_trivially_relocatable<_Tp>::type __relocatable;
+            //and the allocator can also resize the block for us (maybe in place)
+            typedef integral_constant<bool, is_trivially_relocatable<_Tp>::value &&
+                __has_reallocate<Alloc>::value> __use_reallocate;
+
+            //move all the elements into a new storage of new_cap elements
+            void __reallocate(size_type new_cap) {
+                __reallocate(new_cap, __use_reallocate());
+            }
+
+            void __reallocate(size_type new_cap, __true_type) {
+                const size_type n = size();
+                start = start ? data_allocator::reallocate(__alloc(), start, capacity(), new_cap) :
+                    __allocate(new_cap);
+                last = start + n;
+                end_of_storage() = start + new_cap;
+            }
+
+            //elements are copied instead if their move ctor may throw, so on exception the
+            //vector is left untouched
+            void __reallocate(size_type new_cap, __false_type) {
+                iterator new_start = __allocate(new_cap);
+                iterator new_last;
+                try {
+                    new_last = __relocate_with_gap(last, new_start, 0, __relocatable());
+                }
+                catch (...) {
+                    __deallocate(new_start, new_cap);
+                    throw;
+                }
+                __deallocate(start, capacity());
+                start = new_start;
+                last = new_last;
+                end_of_storage() = start + new_cap;
+            }
+
+            //relocate all the elements to new_first, leaving gap raw slots in front of pos,
+            //returns the new last. The old storage is raw memory after it returns
+            iterator __relocate_with_gap(iterator pos, iterator new_first, size_type gap,
+                    __true_type) noexcept {
+                iterator new_pos = my_stl::__uninitialized_relocate(start, pos, new_first, __true_type());
+                return my_stl::__uninitialized_relocate(pos, last, new_pos + gap, __true_type());
+            }
+
+            //both halves have to make it to the new storage before we destroy the old ones
+            iterator __relocate_with_gap(iterator pos, iterator new_first, size_type gap,
+                    __false_type) {
+                iterator new_pos = my_stl::__uninitialized_move_if_noexcept(start, pos, new_first);
+                iterator new_last;
+                try {
+                    new_last = my_stl::__uninitialized_move_if_noexcept(pos, last, new_pos + gap);
+                }
+                catch (...) {
+                    destroy(new_first, new_pos);
+                    throw;
+                }
+                destroy(start, last);
+                return new_last;
+            }
+
+            //slow path of emplace_back, args may refer to an element of this vector
+            //(v.push_back(v[0])) so the new element is constructed before the old ones go away
+            template <typename... Args>
+            void __realloc_emplace_back(Args&&... args) {
+                __realloc_emplace_back_aux(__use_reallocate(), std::forward<Args>(args)...);
+            }
+
+            //with reallocate the old storage is gone once the block is resized, so we build the
+            //element aside first and memcpy it into place, which is fine for a relocatable type
+            template <typename... Args>
+            void __realloc_emplace_back_aux(__true_type, Args&&... args) {
+                alignas(_Tp) unsigned char __buf[sizeof(_Tp)];
+                _Tp* __tmp = reinterpret_cast<_Tp*>(__buf);
+                construct(__tmp, std::forward<Args>(args)...);
+                try {
+                    __reallocate(__next_capacity(), __true_type());
+                }
+                catch (...) {
+                    destroy(__tmp);
+                    throw;
+                }
+                memcpy((void*)last, (const void*)__tmp, sizeof(_Tp));
+                ++last;
             }
 
-            template <typename RandomAccessIterator>
-            inline void __construct_from_iterator(RandomAccessIterator _first,
-                    RandomAccessIterator _last, random_access_iterator_tag)
+            template <typename... Args>
+            void __realloc_emplace_back_aux(__false_type, Args&&... args) {
+                const size_type new_cap = __next_capacity();
+                iterator new_start = __allocate(new_cap);
+                iterator new_last = new_start + size();
+                try {
+                    construct(new_last, std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    __deallocate(new_start, new_cap);
+                    throw;
+                }
+                try {
+                    __relocate_with_gap(last, new_start, 0, __relocatable());
+                }
+                catch (...) {
+                    destroy(new_last);
+                    __deallocate(new_start, new_cap);
+                    throw;
+                }
+                __deallocate(start, capacity());
+                start = new_start;
+                last = new_last + 1;
+                end_of_storage() = start + new_cap;
+            }
+
+            //insert count copies of value at pos when the capacity is enough. A relocatable
+            //tail is shifted by a single memmove, the hole is then filled by copy construction
+            void __insert_in_place(iterator pos, size_type count, const _Tp& value, __true_type) {
+                //value may be one of the elements we are about to shift, take a copy first
+                const _Tp value_copy(value);
+                const size_type n_tail = last - pos;
+                memmove((void*)(pos + count), (const void*)pos, n_tail * sizeof(_Tp));
+                try {
+                    my_stl::uninitialized_fill_n(pos, count, value_copy);
+                }
+                catch (...) {
+                    memmove((void*)pos, (const void*)(pos + count), n_tail * sizeof(_Tp));
+                    throw;
+                }
+                last += count;
+            }
+
+            void __insert_in_place(iterator pos, size_type count, const _Tp& value, __false_type) {
+                //value may be one of the elements we are about to shift, take a copy first
+                const _Tp value_copy(value);
+                //if the end already passed the pos + n, we need to move [end - n, end)
+                //to [end, end + n)
+                if (size_type(last - pos) >= count) {
+                    my_stl::uninitialized_move(last - count, last, last);
+                    //then move [pos, end - n) to [pos + n, end)
+                    //note we should use move_backward, otherwise, there will be corrupted element
+                    my_stl::move_backward(pos, last - count, last);
+                    //fill element in the range [pos, pos + n)
+                    my_stl::fill(pos, pos + count, value_copy);
+                }
+                //in this case, end is less than pos + n
+                else {
+                    //move [pos, last) into [last + n - (last - pos), last + n)
+                    my_stl::uninitialized_move(pos, last, count + pos);
+                    //fill [post, last) with value
+                    my_stl::fill(pos, last, value_copy);
+                    //initialize [last, pos + n) with value
+                    my_stl::uninitialized_fill_n(last, pos + count - last, value_copy);
+                }
+                last += count;
+            }
+
+            //remove [head, tail), a relocatable tail is memmoved over the hole instead of
+            //being assigned element by element
+            void __erase_range(iterator head, iterator tail, __true_type) noexcept {
+                destroy(head, tail);
+                memmove((void*)head, (const void*)tail, (last - tail) * sizeof(_Tp));
+                last -= tail - head;
+            }
+
+            void __erase_range(iterator head, iterator tail, __false_type) {
+                iterator new_last = my_stl::move(tail, last, head);
+                destroy(new_last, last);
+                last = new_last;
+            }
+
+            //a forward range can be walked twice, count it and allocate exactly once
+            template <typename ForwardIterator>
+            inline void __construct_from_iterator(ForwardIterator _first,
+                    ForwardIterator _last, forward_iterator_tag)
             {
-                auto n = _last - _first;
-                start = data_allocator.allocate(n);
-                last = end_of_storage = start + n;
-                for (iterator it = start;  n != 0; --n, ++it, ++_first) {
-                    construct(it, *_first);
+                const size_type n = my_stl::distance(_first, _last);
+                start = __allocate(n);
+                try {
+                    last = end_of_storage() = my_stl::uninitialized_copy(_first, _last, start);
+                }
+                catch (...) {
+                    __deallocate(start, n);
+                    throw;
                 }
             }
 
@@ -74,99 +307,255 @@ namespace my_stl {
                 }
             }
 
+            //insert(pos, n, value) with two integers lands in the range insert, send it back
+            template <typename Integer>
+            void __insert_dispatch(iterator pos, Integer n, Integer value, __true_type) {
+                insert(pos, size_type(n), _Tp(value));
+            }
+
+            template <typename InputIterator>
+            void __insert_dispatch(iterator pos, InputIterator _first, InputIterator _last, __false_type) {
+                __range_insert(pos, _first, _last,
+                        typename iterator_traits<InputIterator>::iterator_category());
+            }
+
+            //a single pass range has no length up front, it is appended and then rotated into
+            //place, instead of shifting the tail once per element
+            template <typename InputIterator>
+            void __range_insert(iterator pos, InputIterator _first, InputIterator _last,
+                    input_iterator_tag) {
+                const size_type offset = pos - start, old_size = size();
+                for (; _first != _last; ++_first) {
+                    emplace_back(*_first);
+                }
+                my_stl::__rotate(start + offset, start + old_size, last);
+            }
+
+            //the length is known, so there is at most one reallocation and the tail moves once
+            template <typename ForwardIterator>
+            void __range_insert(iterator pos, ForwardIterator _first, ForwardIterator _last,
+                    forward_iterator_tag) {
+                if (_first == _last)    return;
+                const size_type count = my_stl::distance(_first, _last);
+                if (size_type(end_of_storage() - last) >= count) {
+                    __insert_range_in_place(pos, _first, _last, count, __relocatable());
+                    return;
+                }
+                const size_type new_cap = __next_capacity(count);
+                //appending only needs the storage to grow, which may be a realloc
+                if (pos == last) {
+                    __reallocate(new_cap);
+                    last = my_stl::uninitialized_copy(_first, _last, last);
+                    return;
+                }
+                iterator new_first = __allocate(new_cap);
+                iterator new_pos = new_first + (pos - start);
+                try {
+                    my_stl::uninitialized_copy(_first, _last, new_pos);
+                }
+                catch (...) {
+                    __deallocate(new_first, new_cap);
+                    throw;
+                }
+                iterator new_last;
+                try {
+                    new_last = __relocate_with_gap(pos, new_first, count, __relocatable());
+                }
+                catch (...) {
+                    destroy(new_pos, new_pos + count);
+                    __deallocate(new_first, new_cap);
+                    throw;
+                }
+                __deallocate(start, capacity());
+                start = new_first;
+                last = new_last;
+                end_of_storage() = start + new_cap;
+            }
+
+            //[first, last) into pos when the capacity is enough, a relocatable tail is shifted by
+            //a single memmove and the hole is copy constructed (memmove again for trivial types)
+            template <typename ForwardIterator>
+            void __insert_range_in_place(iterator pos, ForwardIterator _first, ForwardIterator _last,
+                    size_type count, __true_type) {
+                const size_type n_tail = last - pos;
+                memmove((void*)(pos + count), (const void*)pos, n_tail * sizeof(_Tp));
+                try {
+                    my_stl::uninitialized_copy(_first, _last, pos);
+                }
+                catch (...) {
+                    memmove((void*)pos, (const void*)(pos + count), n_tail * sizeof(_Tp));
+                    throw;
+                }
+                last += count;
+            }
+
+            template <typename ForwardIterator>
+            void __insert_range_in_place(iterator pos, ForwardIterator _first, ForwardIterator _last,
+                    size_type count, __false_type) {
+                const size_type n_tail = last - pos;
+                iterator old_last = last;
+                //the tail is longer than the range, its last count elements go to raw memory
+                if (n_tail > count) {
+                    my_stl::uninitialized_move(last - count, last, last);
+                    last += count;
+                    my_stl::move_backward(pos, old_last - count, old_last);
+                    my_stl::copy(_first, _last, pos);
+                }
+                //otherwise the part of the range past the tail and the whole tail go there
+                else {
+                    ForwardIterator mid = _first;
+                    my_stl::advance(mid, n_tail);
+                    my_stl::uninitialized_copy(mid, _last, last);
+                    last += count - n_tail;
+                    try {
+                        my_stl::uninitialized_move(pos, old_last, last);
+                    }
+                    catch (...) {
+                        destroy(old_last, last);
+                        last = old_last;
+                        throw;
+                    }
+                    last += n_tail;
+                    my_stl::copy(_first, mid, pos);
+                }
+            }
+
+            //out of line, so the checks don't bloat the accessors inlined into loops
+            __attribute__((noinline, noreturn)) static void __throw_out_of_range() {
+                throw std::out_of_range("vector::at");
+            }
+
+        #ifdef __MY_STL_DEBUG
+            void __check_boundary(size_type n) const {
+                if (n >= size()) {
+                    std::cerr << "out of vector boundary" << std::endl;
+                    exit(1);
+                }
+            }
+        #endif
+
         public:
             iterator begin() {return start;}
             iterator end() {return last;}
             const_iterator cbegin() const {return start;};
             const_iterator cend() const {return last;};
             size_type size() const {return last - start;}
-            size_type capacity() const {return end_of_storage - start;}
+            size_type capacity() const {return end_of_storage() - start;}
             bool empty() const {return start == last;}
 
+            //unchecked, so loops over the elements can be vectorized. Build with __MY_STL_DEBUG
+            //to have every access checked
             reference operator[](size_type n) {
-                //check boundary and return
-                if (n >= size()) {
-                    std::cerr << "out of vector boundary" << std::endl;
-                    exit(1);
-                }
+            #ifdef __MY_STL_DEBUG
+                __check_boundary(n);
+            #endif
                 return *(start + n);
             }
-            
+
             const_reference operator[](size_type n) const {
-                if (n >= size()) {
-                    std::cerr << "out of vector boundary" << std::endl;
-                    exit(1);
-                }
+            #ifdef __MY_STL_DEBUG
+                __check_boundary(n);
+            #endif
+                return *(start + n);
+            }
+
+            //checked access, throws out_of_range
+            reference at(size_type n) {
+                if (n >= size())    __throw_out_of_range();
                 return *(start + n);
             }
 
+            const_reference at(size_type n) const {
+                if (n >= size())    __throw_out_of_range();
+                return *(start + n);
+            }
+
+            pointer data() noexcept {return start;}
+            const_pointer data() const noexcept {return start;}
+
+            allocator_type get_allocator() const {return __end_and_alloc.second();}
+
             //ctors
-            vector() noexcept: start(nullptr), last(nullptr), end_of_storage(nullptr){}
+            vector() noexcept: start(nullptr), last(nullptr), __end_and_alloc(nullptr){}
 
-            vector(size_type n, const _Tp& value) {
+            //every ctor can take an allocator instance, which is copied into the vector
+            explicit vector(const Alloc& __a) noexcept: start(nullptr), last(nullptr),
+                __end_and_alloc(nullptr, __a) {}
+
+            vector(size_type n, const _Tp& value, const Alloc& __a = Alloc()):
+                __end_and_alloc(nullptr, __a) {
                 fill_initialize(n, value);
             }
 
-            vector(int n, const _Tp& value) {
+            vector(int n, const _Tp& value, const Alloc& __a = Alloc()): __end_and_alloc(nullptr, __a) {
                 fill_initialize(n, value);
             }
-            vector(long n, const _Tp& value) {
+            vector(long n, const _Tp& value, const Alloc& __a = Alloc()): __end_and_alloc(nullptr, __a) {
                 fill_initialize(n, value);
             }
 
-            explicit vector(size_type n) {
+            explicit vector(size_type n, const Alloc& __a = Alloc()): __end_and_alloc(nullptr, __a) {
                 //note that this will require the default ctor of the type
                 fill_initialize(n, _Tp());
             }
 
-            vector(const vector<_Tp>& rhs) {
+            //the copy shares the allocator of rhs
+            vector(const vector& rhs): vector(rhs, rhs.get_allocator()) {}
+
+            vector(const vector& rhs, const Alloc& __a): __end_and_alloc(nullptr, __a) {
                 //copy constructor, need to allocate and initialize all the elements
-                start = data_allocator.allocate(rhs.size());
-                end_of_storage = last = my_stl::uninitialized_copy(rhs.start, rhs.last, start);
+                start = __allocate(rhs.size());
+                end_of_storage() = last = my_stl::uninitialized_copy(rhs.start, rhs.last, start);
             }
 
             //c++11
-            vector(std::initializer_list<_Tp> _il) {
+            vector(std::initializer_list<_Tp> _il, const Alloc& __a = Alloc()): start(nullptr),
+                last(nullptr), __end_and_alloc(nullptr, __a) {
                 if (_il.size() > 0) {
-                    start = data_allocator.allocate(_il.size());
-                    end_of_storage = last = my_stl::uninitialized_copy(_il.begin(), _il.end(), start);
+                    start = __allocate(_il.size());
+                    end_of_storage() = last = my_stl::uninitialized_copy(_il.begin(), _il.end(), start);
                 }
             }
 
-            vector<_Tp>& operator=(const vector<_Tp>& rhs) {
+            vector& operator=(const vector& rhs) {
                 //note this is the only exception safe implementation which also also
                 //overloading with move assignment operator
-                vector<_Tp> temp(rhs);
+                //the allocator of rhs comes along with its elements
+                vector temp(rhs);
                 swap(temp);
                 return *this;
             }
 
-            //move constructor
-            vector(vector<_Tp>&& rhs) noexcept: start(rhs.start), last(rhs.last), end_of_storage(rhs.end_of_storage) {
-                rhs.start = rhs.last = rhs.end_of_storage = nullptr;
+            //move constructor, the allocator moves with the storage
+            vector(vector&& rhs) noexcept: start(rhs.start), last(rhs.last),
+                __end_and_alloc(rhs.end_of_storage(), std::move(rhs.__alloc())) {
+                rhs.start = rhs.last = rhs.end_of_storage() = nullptr;
             }
 
             //move assignment
-            vector<_Tp>& operator=(vector<_Tp> &&rhs) noexcept {
+            vector& operator=(vector &&rhs) noexcept {
                 if (this != &rhs) {
+                    //our storage has to go back to our own allocator before we take the new one
                     deallocate();
+                    __alloc() = std::move(rhs.__alloc());
                     start = rhs.start;
                     last = rhs.last;
-                    end_of_storage = rhs.end_of_storage;
-                    rhs.start = rhs.last = rhs.end_of_storage = nullptr;
+                    end_of_storage() = rhs.end_of_storage();
+                    rhs.start = rhs.last = rhs.end_of_storage() = nullptr;
                 }
                 return *this;
             }
 
 
             template<typename InputIterator>
-            vector(InputIterator _first, InputIterator _last) {
+            vector(InputIterator _first, InputIterator _last, const Alloc& __a = Alloc()):
+                start(nullptr), last(nullptr), __end_and_alloc(nullptr, __a) {
                 //construct vector based on the iterator type, if it is random iterator, we get the distance before iterate it
                 __construct_from_iterator(_first, _last, typename iterator_traits<InputIterator>::iterator_category());
             }
                 
 
-            bool operator==(const vector<_Tp>& rhs) const {
+            bool operator==(const vector& rhs) const {
                 if (size() != rhs.size())   return false;
                 for (auto _i1 = cbegin(), _i2 = rhs.cbegin(); _i1 != cend(); ++_i1, ++_i2) {
                     if (*_i1 != *_i2)   return false;
@@ -174,21 +563,20 @@ namespace my_stl {
                 return true;
             }
 
-            bool operator!=(const vector<_Tp>& rhs) const {
+            bool operator!=(const vector& rhs) const {
                 return !operator==(rhs);
             }
 
             //swap function, should implement std::swap but let's keep it as it is 
-            void swap(vector<_Tp> &rhs) noexcept{
+            //the allocators are swapped together with the storage
+            void swap(vector &rhs) noexcept{
                 iterator start_temp = start;
                 iterator last_temp = last;
-                iterator end_temp = end_of_storage;
                 start = rhs.start;
                 last = rhs.last;
-                end_of_storage = rhs.end_of_storage;
                 rhs.start = start_temp;
                 rhs.last = last_temp;
-                rhs.end_of_storage = end_temp;
+                __end_and_alloc.swap(rhs.__end_and_alloc);
             }
                 
             //dtor
@@ -204,29 +592,27 @@ namespace my_stl {
                 return *(last - 1);
             }
 
-            void push_back (const _Tp& x) {
-                if (last != end_of_storage) {
-                    construct(last++, x);
-                }
-                else if (start) {
-                    //allocate twice the size
-                    int temp= size();
-                    iterator new_first = data_allocator.allocate(temp * 2);
-                    iterator new_last = uninitialized_copy(start, last, new_first);
-                    deallocate();
-                    start = new_first;
-                    last  = new_last;
-                    end_of_storage = start + temp * 2;
-                    construct(last++, x);
+            //construct the element in place at the end, grows to twice the size (or one
+            //element for an empty vector) when the storage is full
+            template <typename... Args>
+            void emplace_back (Args&&... args) {
+                if (last != end_of_storage()) {
+                    construct(last, std::forward<Args>(args)...);
+                    ++last;
                 }
                 else {
-                    //its empty vetor, allocate exact one element
-                    start = data_allocator.allocate(1);
-                    end_of_storage = last = start + 1;
-                    construct(start, x);
+                    __realloc_emplace_back(std::forward<Args>(args)...);
                 }
             }
 
+            void push_back (const _Tp& x) {
+                emplace_back(x);
+            }
+
+            void push_back (_Tp&& x) {
+                emplace_back(std::move(x));
+            }
+
             void pop_back() {
                 destroy(--last);
             }
@@ -241,17 +627,32 @@ namespace my_stl {
                     last = start + new_size;
                 }
                 else if (size() < new_size) {
-                    if (end_of_storage - start >= new_size) {
-                        uninitialized_fill(last, start + new_size, x);
+                    if (capacity() >= new_size) {
+                        my_stl::uninitialized_fill(last, start + new_size, x);
                         last = start + new_size;
                     }
                     else {
-                        iterator new_start = data_allocator.allocate(new_size);
-                        iterator new_end = uninitialized_copy(start, last, new_start);
-                        uninitialized_fill(new_end, new_start + new_size, x);
-                        deallocate();
+                        //fill the new elements first, x may be one of our elements
+                        iterator new_start = __allocate(new_size);
+                        iterator new_end = new_start + size();
+                        try {
+                            my_stl::uninitialized_fill(new_end, new_start + new_size, x);
+                        }
+                        catch (...) {
+                            __deallocate(new_start, new_size);
+                            throw;
+                        }
+                        try {
+                            __relocate_with_gap(last, new_start, 0, __relocatable());
+                        }
+                        catch (...) {
+                            destroy(new_end, new_start + new_size);
+                            __deallocate(new_start, new_size);
+                            throw;
+                        }
+                        __deallocate(start, capacity());
                         start = new_start;
-                        last = end_of_storage = start + new_size;
+                        last = end_of_storage() = start + new_size;
                     }
                 }
             }
@@ -272,19 +673,13 @@ namespace my_stl {
             iterator erase(iterator head, iterator tail) {
                 //destroy the range first
                 if (head >= tail)    return head;
-                iterator new_last = copy(tail, last, head);
-                destroy(new_last, last);
-                last = new_last;
+                __erase_range(head, tail, __relocatable());
                 return head;
             }
 
             //remove one single elements in the index
             iterator erase(iterator position) {
-                if (position + 1 != end()) {
-                    copy(position + 1, last, position);
-                }
-                --last;
-                destroy(last);
+                __erase_range(position, position + 1, __relocatable());
                 return position;
             }
 
@@ -293,75 +688,78 @@ namespace my_stl {
 
             iterator insert(const iterator pos, size_type count, const _Tp& value);
 
+            //insert [first, last) before pos, the range must not come from this vector
+            template <typename InputIterator>
+            iterator insert(const iterator pos, InputIterator _first, InputIterator _last) {
+                const difference_type offset = pos - start;
+                __insert_dispatch(pos, _first, _last, typename is_integer<InputIterator>::type());
+                return start + offset;
+            }
+
+            //insert [first, last) at the end
+            template <typename InputIterator>
+            void append(InputIterator _first, InputIterator _last) {
+                insert(last, _first, _last);
+            }
+
             //the reserve function
             void reserve(size_type size) {
                 if (capacity() < size) {
-                    iterator new_start = data_allocator.allocate(size);
-                    iterator new_last = uninitialized_copy(start, last, new_start);
-                    deallocate();
-                    start = new_start;
-                    last = new_last;
-                    end_of_storage = start + size;
+                    __reallocate(size);
                 }
             }
     };
 
+    //the vector only holds pointers to its heap storage, it can be memcpy-ed to a new place
+    template <typename _Tp, typename Alloc, typename _Growth>
+    struct is_trivially_relocatable<vector<_Tp, Alloc, _Growth>>: __is_relocatable_alloc<Alloc> {};
 
-    template <typename _Tp, typename Alloc>
-    typename vector<_Tp, Alloc>::iterator vector<_Tp, Alloc>::insert(const typename vector<_Tp, Alloc>::iterator pos,
+    template <typename _Tp, typename Alloc, typename _Growth>
+    typename vector<_Tp, Alloc, _Growth>::iterator vector<_Tp, Alloc, _Growth>::insert(const typename vector<_Tp, Alloc, _Growth>::iterator pos,
             const _Tp& value){
         return insert(pos, 1, value);
     }
 
-    template <typename _Tp, typename Alloc>
-    typename vector<_Tp, Alloc>::iterator vector<_Tp, Alloc>::insert(
-            const typename vector<_Tp, Alloc>::iterator pos,
-            typename vector<_Tp, Alloc>::size_type count, const _Tp& value){
+    template <typename _Tp, typename Alloc, typename _Growth>
+    typename vector<_Tp, Alloc, _Growth>::iterator vector<_Tp, Alloc, _Growth>::insert(
+            const typename vector<_Tp, Alloc, _Growth>::iterator pos,
+            typename vector<_Tp, Alloc, _Growth>::size_type count, const _Tp& value){
+        const difference_type offset = pos - start;
         if (count) {         //only insert if n is not 0
-            if (end_of_storage - last >= count) {     //if there is enough space
-                //if the end already passed the pos + n, we need to copy [end - n, end)
-                //to [end, end + n)
-                if (last - pos >= count) {
-                    my_stl::uninitialized_copy(last - count, last, last);
-                    //then copy [pos, end - n) to [pos + n, end)
-                    //note we should use copy_backward, otherwise, there will be corrupted element
-                    my_stl::copy_backward(pos, last - count, last);
-                    //fill element in the range [pos, pos + n)
-                    my_stl::fill(pos, pos + count, value); 
-                }
-                //in this case, end is less than pos + n
-                else {
-                    //copy [pos, last) into [last + n - (last - pos), last + n)
-                    my_stl::uninitialized_copy(pos, last, count + pos);
-                    //fill [post, last) with value
-                    my_stl::fill(pos, last, value);
-                    //initialize [last, pos + n) with value
-                    my_stl::uninitialized_fill_n(last, pos + count - last, value);
-                }
-                last += count;
+            if (size_type(end_of_storage() - last) >= count) {     //if there is enough space
+                __insert_in_place(pos, count, value, __relocatable());
             }
             else {                  //there is not enough space need to allocate enough space
-                //printf ("start inserting----alocate new memory\n");
-                //we need to determine how much space is allocated 2 times or right amount
-                const size_type old_size = size();
-                //printf ("old size is %d\n", (int)old_size);
-                const size_type new_size = old_size + (count > old_size? count: old_size);
-                //printf ("new size is %d\n", (int)new_size);
-                iterator new_first = data_allocator.allocate(new_size);
-                //copy the first part
-                iterator new_last = uninitialized_copy(start, pos, new_first);
-                //fill the value
-                new_last = uninitialized_fill_n(new_last, count, value);
-                //copy the last part
-                new_last = uninitialized_copy(pos, last, new_last);
-                //deallocate the memmoty
-                deallocate();
+                //the growth policy decides how much more than count we take
+                const size_type new_size = __next_capacity(count);
+                iterator new_first = __allocate(new_size);
+                //fill the value first, it may refer to one of the old elements
+                iterator new_pos = new_first + offset;
+                try {
+                    my_stl::uninitialized_fill_n(new_pos, count, value);
+                }
+                catch (...) {
+                    __deallocate(new_first, new_size);
+                    throw;
+                }
+                //then relocate the two parts around it
+                iterator new_last;
+                try {
+                    new_last = __relocate_with_gap(pos, new_first, count, __relocatable());
+                }
+                catch (...) {
+                    destroy(new_pos, new_pos + count);
+                    __deallocate(new_first, new_size);
+                    throw;
+                }
+                //deallocate the memmoty, the old elements are already gone
+                __deallocate(start, capacity());
                 start = new_first;
                 last = new_last;
-                end_of_storage = start + new_size;
+                end_of_storage() = start + new_size;
             }
         }
-        return start;
+        return start + offset;
     }
 }
 #endif
@@ -0,0 +1,69 @@
+#include "../src/m_algobase.h"
+#include <gtest/gtest.h>
+#include "test_objects.h"
+#include <vector>
+#include <algorithm>
+
+
+//fill a buffer at every offset and length around the vector width, compare with std::fill
+//and check nothing outside the range is touched
+template <typename T>
+void testFillRange(const T& value, const T& guard) {
+    const size_t max_n = 300;
+    for (size_t offset = 0; offset < 4; ++offset) {
+        for (size_t n = 0; n < max_n; n += (n < 70 ? 1 : 37)) {
+            std::vector<T> buf(max_n + 8, guard);
+            std::vector<T> expected(buf);
+            std::fill(expected.begin() + offset, expected.begin() + offset + n, value);
+            my_stl::fill(&buf[offset], &buf[offset] + n, value);
+            ASSERT_EQ(buf == expected, true) << "fill failed for n = " << n << " offset = " << offset;
+
+            std::vector<T> buf_n(max_n + 8, guard);
+            T* res = my_stl::fill_n(&buf_n[offset], n, value);
+            ASSERT_EQ(res, &buf_n[offset] + n);
+            ASSERT_EQ(buf_n == expected, true) << "fill_n failed for n = " << n << " offset = " << offset;
+        }
+    }
+}
+
+TEST(AlgobaseTest, TestFillArithmetic) {
+    testFillRange<char>('a', 'z');
+    testFillRange<short>(0x1234, -1);
+    testFillRange<short>(0, -1);
+    testFillRange<int>(0x12345678, 7);
+    testFillRange<float>(3.5f, 0.0f);
+    testFillRange<double>(-2.25, 1.0);
+    testFillRange<double>(0.0, 1.0);
+    testFillRange<long long>(0x0102030405060708ll, 0);
+    testFillRange<long double>(1.5, 0.0);
+}
+
+TEST(AlgobaseTest, TestFillObjects) {
+    testFillRange(Test_FOO_Simple(1, 2, 'c'), Test_FOO_Simple(3, 4, 'd'));
+    testFillRange<int*>(nullptr, (int*)&std::cout);
+
+    //non trivial type goes through operator=
+    std::vector<Test_FOO_Heap> hv(100, Test_FOO_Heap(1));
+    my_stl::fill(&hv[10], &hv[90], Test_FOO_Heap(5));
+    for (size_t i = 0; i < hv.size(); ++i) {
+        ASSERT_EQ(hv[i] == Test_FOO_Heap((i >= 10 && i < 90) ? 5 : 1), true);
+    }
+
+    //other iterators
+    std::vector<int> iv(1000, 1);
+    my_stl::fill(iv.begin(), iv.end(), 5);
+    my_stl::fill_n(iv.begin(), 10, 6);
+    ASSERT_EQ(std::count(iv.begin(), iv.end(), 5), 990);
+}
+
+TEST(AlgobaseTest, TestFillAliasing) {
+    //the value is an element of the range
+    std::vector<int> iv(500);
+    for (size_t i = 0; i < iv.size(); ++i) iv[i] = i;
+    my_stl::fill(&iv[0], &iv[0] + iv.size(), iv[250]);
+    ASSERT_EQ(std::count(iv.begin(), iv.end(), 250), 500);
+    std::vector<Test_FOO_Simple> sv(500);
+    for (size_t i = 0; i < sv.size(); ++i) sv[i] = Test_FOO_Simple((int)i);
+    my_stl::fill(&sv[0], &sv[0] + sv.size(), sv[0]);
+    ASSERT_EQ(std::count(sv.begin(), sv.end(), Test_FOO_Simple(0)), 500);
+}
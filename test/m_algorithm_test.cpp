@@ -0,0 +1,206 @@
+#include "../src/m_algorithm.h"
+#include "../src/m_vector.h"
+#include <gtest/gtest.h>
+#include "test_objects.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <utility>
+
+
+//the inputs that trip up the quicksorts: sorted, reversed, equal, few keys, organ pipe,
+//sawtooth, sorted with a few swaps and random
+static std::vector<std::vector<int>> sort_shapes() {
+    std::vector<std::vector<int>> shapes;
+    srand(17);
+    for (int n : {0, 1, 2, 3, 10, 23, 24, 25, 100, 129, 1000, 20000}) {
+        std::vector<int> v(n);
+        for (int i = 0; i < n; ++i) v[i] = i;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = n - i;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = 7;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = rand() % 4;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = i < n / 2 ? i : n - i;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = i % 64;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = i;
+        for (int i = 0; i < n / 50; ++i) std::swap(v[rand() % n], v[rand() % n]);
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = rand() - RAND_MAX / 2;
+        shapes.push_back(v);
+    }
+    return shapes;
+}
+
+//sort by the key only, the payload tells whether the equal keys kept their order
+struct key_less {
+    bool operator()(const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) const {
+        return lhs.first < rhs.first;
+    }
+};
+
+TEST(AlgorithmTest, TestSort) {
+    for (const auto& shape : sort_shapes()) {
+        //ints with less take the branchless partition
+        std::vector<int> s_v(shape), m_v(shape);
+        std::sort(s_v.begin(), s_v.end());
+        my_stl::sort(m_v.data(), m_v.data() + m_v.size());
+        ASSERT_TRUE(s_v == m_v) << "size " << shape.size();
+
+        std::vector<double> s_d(shape.begin(), shape.end()), m_d(s_d);
+        std::sort(s_d.begin(), s_d.end(), std::greater<double>());
+        my_stl::sort(m_d.data(), m_d.data() + m_d.size(), my_stl::greater<double>());
+        ASSERT_TRUE(s_d == m_d);
+
+        //strings and a comparator object take the other one
+        std::vector<std::string> s_s, m_s;
+        for (int x : shape) s_s.push_back(std::to_string(x));
+        m_s = s_s;
+        std::sort(s_s.begin(), s_s.end());
+        my_stl::sort(m_s.data(), m_s.data() + m_s.size());
+        ASSERT_TRUE(s_s == m_s);
+    }
+
+    //the library's own vector
+    my_stl::vector<Test_FOO_Simple> m_v;
+    std::vector<int> s_v;
+    for (int i = 0; i < 5000; ++i) {
+        s_v.push_back(rand() % 1000);
+        m_v.push_back(Test_FOO_Simple(s_v.back()));
+    }
+    std::sort(s_v.begin(), s_v.end());
+    my_stl::sort(m_v.begin(), m_v.end(), [](const Test_FOO_Simple& lhs, const Test_FOO_Simple& rhs) {
+            return lhs.getIntMember() < rhs.getIntMember();});
+    for (size_t i = 0; i < s_v.size(); ++i) {
+        ASSERT_EQ(m_v[i].getIntMember(), s_v[i]);
+    }
+}
+
+TEST(AlgorithmTest, TestStableSort) {
+    for (const auto& shape : sort_shapes()) {
+        std::vector<std::pair<int, int>> s_v, m_v, i_v;
+        for (size_t i = 0; i < shape.size(); ++i) {
+            s_v.push_back(std::make_pair(shape[i] % 100, i));
+        }
+        m_v = i_v = s_v;
+        std::stable_sort(s_v.begin(), s_v.end(), key_less());
+        my_stl::stable_sort(m_v.data(), m_v.data() + m_v.size(), key_less());
+        ASSERT_TRUE(s_v == m_v) << "size " << shape.size();
+        //the merges by rotation, used when there is no memory for the buffer
+        key_less comp;
+        my_stl::__inplace_stable_sort(i_v.data(), i_v.data() + i_v.size(), comp);
+        ASSERT_TRUE(s_v == i_v) << "size " << shape.size();
+    }
+
+    //a type without a default constructor goes through the buffer too
+    std::vector<std::string> s_s, m_s;
+    for (int i = 0; i < 1000; ++i) s_s.push_back(std::to_string(rand() % 300));
+    m_s = s_s;
+    std::stable_sort(s_s.begin(), s_s.end());
+    my_stl::stable_sort(m_s.data(), m_s.data() + m_s.size());
+    ASSERT_TRUE(s_s == m_s);
+}
+
+TEST(AlgorithmTest, TestPartialSortAndNthElement) {
+    for (const auto& shape : sort_shapes()) {
+        std::vector<int> sorted(shape);
+        std::sort(sorted.begin(), sorted.end());
+        const size_t n = shape.size();
+        for (size_t k : {size_t(0), size_t(1), n / 3, n / 2, n == 0 ? 0 : n - 1, n}) {
+            if (k > n)  continue;
+            std::vector<int> v(shape);
+            my_stl::partial_sort(v.data(), v.data() + k, v.data() + n);
+            for (size_t i = 0; i < k; ++i) ASSERT_EQ(v[i], sorted[i]);
+            std::sort(v.begin(), v.end());
+            ASSERT_TRUE(v == sorted);
+
+            if (k == n) continue;
+            v = shape;
+            my_stl::nth_element(v.data(), v.data() + k, v.data() + n);
+            ASSERT_EQ(v[k], sorted[k]) << "size " << n << " k " << k;
+            for (size_t i = 0; i < k; ++i) ASSERT_TRUE(v[i] <= v[k]);
+            for (size_t i = k + 1; i < n; ++i) ASSERT_TRUE(v[k] <= v[i]);
+        }
+    }
+
+    std::vector<std::string> s_v;
+    for (int i = 0; i < 1000; ++i) s_v.push_back(std::to_string(rand() % 500));
+    std::vector<std::string> m_v(s_v);
+    std::partial_sort(s_v.begin(), s_v.begin() + 10, s_v.end(), std::greater<std::string>());
+    my_stl::partial_sort(m_v.data(), m_v.data() + 10, m_v.data() + m_v.size(),
+            my_stl::greater<std::string>());
+    ASSERT_TRUE(std::equal(s_v.begin(), s_v.begin() + 10, m_v.begin()));
+}
+
+//radix sort against std::stable_sort by the same key
+template <typename T>
+void testRadixSort(const std::vector<T>& input) {
+    std::vector<T> s_v(input), m_v(input);
+    std::stable_sort(s_v.begin(), s_v.end());
+    my_stl::radix_sort(m_v.data(), m_v.data() + m_v.size());
+    ASSERT_TRUE(s_v == m_v) << "size " << input.size();
+}
+
+struct record {
+    unsigned key;
+    int payload;
+    bool operator==(const record& rhs) const {return key == rhs.key && payload == rhs.payload;}
+};
+
+TEST(AlgorithmTest, TestRadixSort) {
+    srand(19);
+    for (size_t n : {0, 1, 63, 64, 1000, 70000}) {
+        std::vector<unsigned> u32;
+        std::vector<unsigned long long> u64;
+        std::vector<int> i32;
+        std::vector<short> i16;
+        std::vector<float> f32;
+        std::vector<double> f64;
+        for (size_t i = 0; i < n; ++i) {
+            u32.push_back(rand());
+            u64.push_back((unsigned long long)rand() << 33 ^ rand());
+            i32.push_back(rand() - RAND_MAX / 2);
+            i16.push_back(rand());
+            f32.push_back((rand() - RAND_MAX / 2) / 1000.0f);
+            f64.push_back((rand() - RAND_MAX / 2) * 1e-3);
+        }
+        if (n > 10) {
+            f32[3] = 1.0f / 0.0f;
+            f32[4] = -1.0f / 0.0f;
+            f64[5] = 0.0;
+            f64[6] = -0.0;
+        }
+        testRadixSort(u32);
+        testRadixSort(u64);
+        testRadixSort(i32);
+        testRadixSort(i16);
+        testRadixSort(f32);
+        testRadixSort(f64);
+        //small keys in a wide type, most passes are skipped
+        for (auto& x : u64) x %= 1000;
+        testRadixSort(u64);
+    }
+
+    //records by their key, the payload shows the order of the equal keys was kept
+    std::vector<record> s_v;
+    for (int i = 0; i < 100000; ++i) s_v.push_back(record{unsigned(rand() % 5000), i});
+    my_stl::vector<record> m_v;
+    for (const auto& r : s_v) m_v.push_back(r);
+    std::stable_sort(s_v.begin(), s_v.end(), [](const record& l, const record& r) {return l.key < r.key;});
+    my_stl::radix_sort(m_v.begin(), m_v.end(), [](const record& r) {return r.key;});
+    for (size_t i = 0; i < s_v.size(); ++i) ASSERT_TRUE(s_v[i] == m_v[i]);
+
+    //a signed char key through a key function
+    std::vector<std::pair<signed char, int>> p_v;
+    for (int i = 0; i < 500; ++i) p_v.push_back(std::make_pair((signed char)(rand() % 256 - 128), i));
+    std::vector<std::pair<signed char, int>> sorted(p_v);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<signed char, int>& l,
+                const std::pair<signed char, int>& r) {return l.first < r.first;});
+    my_stl::radix_sort(p_v.data(), p_v.data() + p_v.size(),
+            [](const std::pair<signed char, int>& p) {return p.first;});
+    ASSERT_TRUE(sorted == p_v);
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include <memory>
+#include <thread>
+#include <vector>
+#include <cstring>
 #include "../src/m_alloc.h"
 TEST(AllocatorTest, Allocation) {
     void* vp = nullptr;
@@ -8,3 +11,156 @@ TEST(AllocatorTest, Allocation) {
     ASSERT_NE(vp, nullptr) << "Allocated pointer is still empty";
     my_stl::alloc::deallocate(vp, 4);
 }
+
+TEST(AllocatorTest, ThreadCacheReuse) {
+    //a freed object should be handed out again right away by the same thread
+    void* vp = my_stl::alloc::allocate(24);
+    my_stl::alloc::deallocate(vp, 24);
+    void* reused = my_stl::alloc::allocate(24);
+    ASSERT_EQ(vp, reused) << "thread cache did not reuse the freed object";
+    my_stl::alloc::deallocate(reused, 24);
+}
+
+TEST(AllocatorTest, ConcurrentAllocation) {
+    constexpr int n_threads = 4;
+    constexpr int n_objs = 5000;
+    std::vector<std::vector<char*>> allocated(n_threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < n_threads; ++t) {
+        workers.emplace_back([t, &allocated]() {
+            for (int i = 0; i < n_objs; ++i) {
+                size_t size = (i % 16 + 1) * 8;
+                char* p = (char*) my_stl::alloc::allocate(size);
+                memset(p, t, size);
+                allocated[t].push_back(p);
+            }
+            //give half of them back from the owning thread
+            for (int i = 0; i < n_objs; i += 2) {
+                my_stl::alloc::deallocate(allocated[t][i], (i % 16 + 1) * 8);
+                allocated[t][i] = nullptr;
+            }
+        });
+    }
+    for (auto& worker: workers)  worker.join();
+    workers.clear();
+    //no two threads should ever have been given the same memory
+    for (int t = 0; t < n_threads; ++t) {
+        for (int i = 1; i < n_objs; i += 2) {
+            size_t size = (i % 16 + 1) * 8;
+            for (size_t b = 0; b < size; ++b) {
+                ASSERT_EQ(allocated[t][i][b], (char) t) << "memory shared between threads";
+            }
+        }
+    }
+    //the other half is freed by a different thread than the one allocated it
+    for (int t = 0; t < n_threads; ++t) {
+        workers.emplace_back([t, &allocated]() {
+            auto& objs = allocated[(t + 1) % n_threads];
+            for (int i = 1; i < n_objs; i += 2) {
+                my_stl::alloc::deallocate(objs[i], (i % 16 + 1) * 8);
+            }
+        });
+    }
+    for (auto& worker: workers)  worker.join();
+}
+
+TEST(AllocatorTest, TrimReleasesFreeChunks) {
+    constexpr int n_objs = 100000;
+    std::vector<void*> objs;
+    for (int i = 0; i < n_objs; ++i) {
+        objs.push_back(my_stl::alloc::allocate(48));
+    }
+    size_t peak = my_stl::alloc::pool_size();
+    ASSERT_GE(peak, n_objs * 48) << "pool is smaller than what has been handed out";
+    for (void* p: objs) {
+        my_stl::alloc::deallocate(p, 48);
+    }
+    size_t released = my_stl::alloc::trim();
+    ASSERT_GT(released, 0) << "nothing was given back to the system";
+    ASSERT_EQ(my_stl::alloc::pool_size(), peak - released);
+    ASSERT_LT(my_stl::alloc::pool_size(), peak / 2) << "most of the pool should be released";
+    //the pool still works after trimming
+    void* p = my_stl::alloc::allocate(48);
+    my_stl::alloc::deallocate(p, 48);
+}
+
+TEST(AllocatorTest, HighWaterMarkTrim) {
+    constexpr int n_objs = 100000;
+    std::vector<void*> objs;
+    size_t old_mark = my_stl::alloc::set_high_water_mark(1 << 16);
+    for (int i = 0; i < n_objs; ++i) {
+        objs.push_back(my_stl::alloc::allocate(64));
+    }
+    size_t peak = my_stl::alloc::pool_size();
+    for (void* p: objs) {
+        my_stl::alloc::deallocate(p, 64);
+    }
+    //no explicit trim, the pool should shrink on its own
+    ASSERT_LT(my_stl::alloc::pool_size(), peak / 2) << "pool did not shrink past the high water mark";
+    my_stl::alloc::set_high_water_mark(old_mark);
+}
+
+TEST(AllocatorTest, Reallocate) {
+    //same size class, the block is kept
+    char* p = (char*) my_stl::alloc::allocate(17);
+    memset(p, 'x', 17);
+    char* q = (char*) my_stl::alloc::reallocate(p, 17, 24);
+    ASSERT_EQ(p, q) << "block of the same size class should be reused";
+    //grow into another size class and then past __MAX_BYTES, content is kept
+    q = (char*) my_stl::alloc::reallocate(q, 24, 100);
+    for (int i = 0; i < 17; ++i)    ASSERT_EQ(q[i], 'x');
+    memset(q, 'y', 100);
+    q = (char*) my_stl::alloc::reallocate(q, 100, 1000);
+    for (int i = 0; i < 100; ++i)   ASSERT_EQ(q[i], 'y');
+    memset(q, 'z', 1000);
+    q = (char*) my_stl::alloc::reallocate(q, 1000, 100000);
+    for (int i = 0; i < 1000; ++i)  ASSERT_EQ(q[i], 'z');
+    //shrink back into the pool
+    q = (char*) my_stl::alloc::reallocate(q, 100000, 8);
+    for (int i = 0; i < 8; ++i)     ASSERT_EQ(q[i], 'z');
+    my_stl::alloc::deallocate(q, 8);
+
+    //typed interface
+    using int_alloc = my_stl::my_simple_alloc<int>;
+    int* ip = int_alloc::allocate(10);
+    for (int i = 0; i < 10; ++i)    ip[i] = i;
+    ip = int_alloc::reallocate(ip, 10, 1000);
+    for (int i = 0; i < 10; ++i)    ASSERT_EQ(ip[i], i);
+    int_alloc::deallocate(ip, 1000);
+}
+
+TEST(AllocatorTest, NodePool) {
+    //the freed objects are handed out again, the pool grows by slabs of N objects
+    my_stl::node_pool<my_stl::__malloc_alloc<0>, 8> pool;
+    ASSERT_EQ(pool.capacity(), 0);
+    std::vector<void*> objs;
+    for (int i = 0; i < 20; ++i) {
+        objs.push_back(pool.allocate(24));
+        std::memset(objs.back(), i, 24);
+    }
+    ASSERT_EQ(pool.capacity(), 24);
+    pool.deallocate(objs[5], 24);
+    ASSERT_EQ(pool.allocate(24), objs[5]);
+
+    //only the slabs with no object in use are released
+    for (int i = 0; i < 16; ++i) pool.deallocate(objs[i], 24);
+    ASSERT_EQ(pool.shrink_to_fit(), 2);
+    ASSERT_EQ(pool.capacity(), 8);
+    for (int i = 16; i < 20; ++i) pool.deallocate(objs[i], 24);
+    ASSERT_EQ(pool.shrink_to_fit(), 1);
+    ASSERT_EQ(pool.capacity(), 0);
+
+    //copies share the pool, after a join objects can be freed through either pool
+    my_stl::node_pool<my_stl::__malloc_alloc<0>, 8> copy(pool), other;
+    ASSERT_TRUE(copy == pool);
+    void* p = other.allocate(24);
+    void* q = pool.allocate(24);
+    ASSERT_TRUE(other != pool);
+    other.join(pool);
+    ASSERT_TRUE(other == pool);
+    ASSERT_TRUE(copy == pool);
+    pool.deallocate(p, 24);
+    other.deallocate(q, 24);
+    ASSERT_EQ(copy.capacity(), 16);
+    ASSERT_EQ(copy.shrink_to_fit(), 2);
+}
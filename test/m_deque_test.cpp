@@ -0,0 +1,353 @@
+#include "../src/m_deque.h"
+#include "../src/m_algorithm.h"
+#include <deque>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include "test_objects.h"
+
+
+//small blocks, so that the tests cross a lot of block boundaries and grow the map often
+template <typename T>
+using small_deque = my_stl::deque<T, 4>;
+
+template <typename T, typename Deque>
+inline void assertDequeEqual(const std::deque<T>& std_deque, const Deque& my_deque) {
+    ASSERT_EQ(std_deque.size(), my_deque.size());
+    auto m_it = my_deque.cbegin();
+    for (auto s_it = std_deque.cbegin(); s_it != std_deque.cend(); ++s_it, ++m_it) {
+        ASSERT_TRUE(*s_it == *m_it);
+    }
+    ASSERT_TRUE(m_it == my_deque.cend());
+    //and backwards, and by index
+    auto m_rit = my_deque.crbegin();
+    for (auto s_rit = std_deque.crbegin(); s_rit != std_deque.crend(); ++s_rit, ++m_rit) {
+        ASSERT_TRUE(*s_rit == *m_rit);
+    }
+    for (size_t i = 0; i < std_deque.size(); ++i) {
+        ASSERT_TRUE(std_deque[i] == my_deque[i]);
+    }
+}
+
+TEST(DequeTest, TestPushAndPop) {
+    std::deque<int> s_d;
+    small_deque<int> m_d;
+    ASSERT_TRUE(m_d.empty());
+    ASSERT_TRUE(m_d.begin() == m_d.end());
+    for (int i = 0; i < 1000; ++i) {
+        s_d.push_back(i);
+        m_d.push_back(i);
+        s_d.push_front(-i);
+        m_d.emplace_front(-i);
+    }
+    assertDequeEqual(s_d, m_d);
+    ASSERT_EQ(m_d.front(), s_d.front());
+    ASSERT_EQ(m_d.back(), s_d.back());
+    for (int i = 0; i < 700; ++i) {
+        s_d.pop_back();
+        m_d.pop_back();
+        s_d.pop_front();
+        m_d.pop_front();
+    }
+    assertDequeEqual(s_d, m_d);
+    //all from one end, then all from the other
+    while (!s_d.empty()) {
+        s_d.pop_front();
+        m_d.pop_front();
+    }
+    ASSERT_TRUE(m_d.empty());
+    for (int i = 0; i < 50; ++i) {
+        s_d.push_front(i);
+        m_d.push_front(i);
+    }
+    while (!s_d.empty()) {
+        ASSERT_EQ(m_d.back(), s_d.back());
+        s_d.pop_back();
+        m_d.pop_back();
+    }
+    ASSERT_TRUE(m_d.empty());
+
+    //the value may be one of the elements
+    m_d.push_back(7);
+    for (int i = 0; i < 20; ++i) {
+        m_d.push_back(m_d.front());
+        m_d.push_front(m_d.back());
+    }
+    for (int x: m_d) ASSERT_EQ(x, 7);
+
+    //the default block size
+    my_stl::deque<int> m_big(1000, 3);
+    ASSERT_EQ(m_big.size(), 1000);
+    for (int x: m_big) ASSERT_EQ(x, 3);
+    my_stl::deque<std::string> m_str(10);
+    ASSERT_EQ(m_str.size(), 10);
+    ASSERT_EQ(m_str.back(), "");
+}
+
+TEST(DequeTest, TestRandomAccess) {
+    small_deque<int> m_d;
+    for (int i = 0; i < 100; ++i) m_d.push_back(i);
+    for (int i = 1; i <= 30; ++i) m_d.push_front(-i);
+    //iterator arithmetic across blocks, in both directions
+    auto first = m_d.begin();
+    for (int i = 0; i < 130; ++i) {
+        for (int j = 0; j < 130; j += 7) {
+            auto it = first + i;
+            ASSERT_EQ(*(it + (j - i)), j - 30);
+            ASSERT_EQ(it[j - i], j - 30);
+            ASSERT_EQ((first + j) - it, j - i);
+            ASSERT_EQ(it < first + j, i < j);
+        }
+    }
+    ASSERT_EQ(m_d.end() - m_d.begin(), 130);
+    ASSERT_TRUE(m_d.cend() == m_d.end());
+    ASSERT_EQ(m_d[0], -30);
+    ASSERT_EQ(m_d.at(129), 99);
+    ASSERT_THROW(m_d.at(130), std::out_of_range);
+    const small_deque<int>& c_d = m_d;
+    ASSERT_EQ(c_d[30], 0);
+    ASSERT_THROW(c_d.at(1000), std::out_of_range);
+
+    //the algorithms take the iterators as they are
+    static_assert(std::is_same<my_stl::iterator_traits<small_deque<int>::iterator>::iterator_category,
+            my_stl::random_access_iterator_tag>::value, "deque iterator is random access");
+    srand(3);
+    std::deque<int> s_d;
+    for (auto& x: m_d) {
+        x = rand() % 1000;
+        s_d.push_back(x);
+    }
+    my_stl::sort(m_d.begin(), m_d.end());
+    std::sort(s_d.begin(), s_d.end());
+    assertDequeEqual(s_d, m_d);
+}
+
+TEST(DequeTest, TestRandomInsertAndErase) {
+    std::deque<std::string> s_d;
+    small_deque<std::string> m_d;
+    srand(7);
+    //never an empty insert, libstdc++ mangles the elements on one side of it. Those are
+    //checked against a copy below
+    for (int round = 0; round < 3000; ++round) {
+        const int pos = s_d.empty() ? 0 : rand() % (s_d.size() + 1);
+        const std::string value = std::to_string(round);
+        switch (rand() % 6) {
+            case 0: {
+                auto it = m_d.insert(m_d.cbegin() + pos, value);
+                s_d.insert(s_d.begin() + pos, value);
+                ASSERT_EQ(it - m_d.begin(), pos);
+                break;
+            }
+            case 1: {
+                const int n = rand() % 9 + 1;
+                auto it = m_d.insert(m_d.cbegin() + pos, n, value);
+                s_d.insert(s_d.begin() + pos, n, value);
+                ASSERT_EQ(it - m_d.begin(), pos);
+                break;
+            }
+            case 2: {
+                std::string range[] = {value, value + "a", value + "b", value + "c", value + "d"};
+                const int n = rand() % 5 + 1;
+                auto it = m_d.insert(m_d.cbegin() + pos, range, range + n);
+                s_d.insert(s_d.begin() + pos, range, range + n);
+                ASSERT_EQ(it - m_d.begin(), pos);
+                break;
+            }
+            case 3:
+            case 4: {
+                if (pos == int(s_d.size())) break;
+                auto it = m_d.erase(m_d.cbegin() + pos);
+                s_d.erase(s_d.begin() + pos);
+                ASSERT_EQ(it - m_d.begin(), pos);
+                break;
+            }
+            default: {
+                const int n = rand() % 12;
+                if (pos + n > int(s_d.size())) break;
+                auto it = m_d.erase(m_d.cbegin() + pos, m_d.cbegin() + pos + n);
+                s_d.erase(s_d.begin() + pos, s_d.begin() + pos + n);
+                ASSERT_EQ(it - m_d.begin(), pos);
+                break;
+            }
+        }
+        if (round % 100 == 0)   assertDequeEqual(s_d, m_d);
+    }
+    assertDequeEqual(s_d, m_d);
+
+    //an empty range anywhere changes nothing
+    small_deque<std::string> m_copy(m_d);
+    std::string* none = nullptr;
+    for (size_t pos : {size_t(0), m_d.size() / 3, m_d.size() * 2 / 3, m_d.size()}) {
+        m_d.insert(m_d.cbegin() + pos, none, none);
+        m_d.insert(m_d.cbegin() + pos, 0, std::string("x"));
+    }
+    ASSERT_TRUE(m_copy == m_d);
+
+    //two integers are count and value
+    small_deque<int> m_i;
+    m_i.insert(m_i.cbegin(), 5, 2);
+    ASSERT_EQ(m_i.size(), 5);
+    m_i.resize(12, 4);
+    ASSERT_EQ(m_i[11], 4);
+    m_i.resize(3);
+    ASSERT_EQ(m_i.size(), 3);
+    m_i.assign({1, 2, 3, 4, 5, 6});
+    ASSERT_EQ(m_i.back(), 6);
+    m_i.clear();
+    ASSERT_TRUE(m_i.empty());
+}
+
+TEST(DequeTest, TestCopyMoveAndSwap) {
+    small_deque<Test_FOO_Heap> m_d;
+    for (int i = 0; i < 37; ++i) {
+        m_d.push_back(Test_FOO_Heap(i));
+        m_d.push_front(Test_FOO_Heap(-i));
+    }
+    small_deque<Test_FOO_Heap> copy(m_d);
+    ASSERT_TRUE(copy == m_d);
+    small_deque<Test_FOO_Heap> moved(std::move(copy));
+    ASSERT_TRUE(moved == m_d);
+    ASSERT_TRUE(copy.empty());
+    copy = m_d;
+    ASSERT_TRUE(copy == m_d);
+    copy.pop_back();
+    ASSERT_TRUE(copy != m_d);
+
+    small_deque<Test_FOO_Heap> other = {Test_FOO_Heap(1), Test_FOO_Heap(2)};
+    other.swap(moved);
+    ASSERT_TRUE(other == m_d);
+    ASSERT_EQ(moved.size(), 2);
+    moved = std::move(other);
+    ASSERT_TRUE(moved == m_d);
+
+    //a moved from deque is empty and takes new elements, as a work queue handed off
+    small_deque<int> queue;
+    for (int round = 0; round < 3; ++round) {
+        queue.clear();
+        queue.shrink_to_fit();
+        for (int i = 0; i < 10; ++i) {
+            queue.push_back(i);
+            queue.push_front(-i);
+        }
+        small_deque<int> taken(std::move(queue));
+        ASSERT_EQ(taken.size(), 20);
+        ASSERT_TRUE(queue.empty());
+        ASSERT_TRUE(queue.begin() == queue.end());
+        queue.clear();
+        queue.emplace_back(1);
+        queue.pop_back();
+        queue.emplace_front(2);
+        queue.pop_front();
+        queue.insert(queue.cend(), 3, 4);
+        ASSERT_EQ(queue.size(), 3);
+        taken = std::move(queue);
+        ASSERT_EQ(taken.size(), 3);
+        ASSERT_TRUE(queue.empty());
+        queue.insert(queue.cbegin(), {5, 6});
+        ASSERT_EQ(queue.front(), 5);
+        ASSERT_EQ(queue.back(), 6);
+        small_deque<int> assigned;
+        assigned = std::move(queue);
+        queue.push_front(7);
+        ASSERT_EQ(queue.size(), 1);
+        ASSERT_EQ(queue[0], 7);
+    }
+    small_deque<int> empty_moved(std::move(queue));
+    small_deque<int> from_empty(queue);
+    ASSERT_TRUE(from_empty.empty());
+    queue.erase(queue.cbegin(), queue.cend());
+    queue.resize(5, 1);
+    ASSERT_EQ(queue.size(), 5);
+
+    std::deque<int> s_src = {5, 4, 3, 2, 1};
+    small_deque<int> from_range(s_src.begin(), s_src.end());
+    assertDequeEqual(s_src, from_range);
+}
+
+//an allocator counting the blocks out and the calls made
+struct BlockCounter {
+    size_t* live;
+    size_t* calls;
+    BlockCounter(size_t* __live, size_t* __calls): live(__live), calls(__calls) {}
+
+    void* allocate(size_t n) {
+        ++*live;
+        ++*calls;
+        return malloc(n);
+    }
+
+    void deallocate(void* p, size_t) {
+        --*live;
+        free(p);
+    }
+};
+
+TEST(DequeTest, TestBlockRecycling) {
+    size_t live = 0, calls = 0;
+    {
+        my_stl::deque<int, 4, BlockCounter> queue((BlockCounter(&live, &calls)));
+        ASSERT_EQ(live, 1);
+        //a FIFO queue of about 20 elements, the blocks emptied at the front are reused at
+        //the back, no allocation after the first rounds
+        for (int i = 0; i < 20; ++i) queue.push_back(i);
+        const size_t warm = calls;
+        for (int i = 20; i < 100000; ++i) {
+            ASSERT_EQ(queue.front(), i - 20);
+            queue.pop_front();
+            queue.push_back(i);
+        }
+        ASSERT_LE(calls, warm + 2);
+        ASSERT_LE(live, 20 / 4 + 1 + 2);
+
+        //draining keeps at most two spares
+        while (!queue.empty())  queue.pop_back();
+        ASSERT_LE(live, 3);
+        queue.shrink_to_fit();
+        ASSERT_EQ(live, 1);
+        for (int i = 0; i < 100; ++i) queue.push_front(i);
+        queue.erase(queue.cbegin() + 2, queue.cend() - 2);
+        ASSERT_EQ(queue.size(), 4);
+        ASSERT_LE(live, 2 + 2);
+    }
+    ASSERT_EQ(live, 0);
+
+    //the blocks through a node pool
+    my_stl::deque<Test_FOO_Heap, 8, my_stl::node_pool<>> pooled;
+    for (int i = 0; i < 1000; ++i) {
+        pooled.push_back(Test_FOO_Heap(i));
+        if (i % 3 == 0) pooled.pop_front();
+    }
+    ASSERT_EQ(pooled.size(), 666);
+    ASSERT_TRUE(pooled.back() == Test_FOO_Heap(999));
+}
+
+//the copy ctor may throw after a few copies
+struct DequeThrowingCopy {
+    static int copies_before_throw;
+    int value;
+    DequeThrowingCopy(int v): value(v) {}
+    DequeThrowingCopy(const DequeThrowingCopy& rhs): value(rhs.value) {
+        if (copies_before_throw == 0)   throw std::runtime_error("copy failed");
+        --copies_before_throw;
+    }
+    DequeThrowingCopy& operator=(const DequeThrowingCopy&) = default;
+};
+int DequeThrowingCopy::copies_before_throw = -1;
+
+TEST(DequeTest, TestInsertExceptions) {
+    small_deque<DequeThrowingCopy> m_d;
+    for (int i = 0; i < 20; ++i) m_d.push_back(DequeThrowingCopy(i));
+    //a failed insert takes back what it added on either side
+    for (int at : {2, 18}) {
+        DequeThrowingCopy::copies_before_throw = 4;
+        ASSERT_THROW(m_d.insert(m_d.cbegin() + at, 10, DequeThrowingCopy(-1)), std::runtime_error);
+        DequeThrowingCopy::copies_before_throw = -1;
+        ASSERT_EQ(m_d.size(), 20);
+        for (int i = 0; i < 20; ++i) ASSERT_EQ(m_d[i].value, i);
+    }
+    DequeThrowingCopy::copies_before_throw = 5;
+    ASSERT_THROW(small_deque<DequeThrowingCopy> copy(m_d), std::runtime_error);
+    DequeThrowingCopy::copies_before_throw = -1;
+}
@@ -0,0 +1,175 @@
+#include "../src/m_execution.h"
+#include "../src/m_vector.h"
+#include "../src/m_list.h"
+#include <gtest/gtest.h>
+#include "test_objects.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <atomic>
+
+
+//the machine running the tests may have a single core, this pool has threads anyway
+static my_stl::thread_pool& test_pool() {
+    static my_stl::thread_pool pool(3);
+    return pool;
+}
+
+TEST(ExecutionTest, TestParallelAlgorithms) {
+    my_stl::thread_pool& pool = test_pool();
+    srand(23);
+    for (size_t n : {0, 1, 1000, 40000, 200000, 1000003}) {
+        std::vector<int> src(n);
+        for (auto& x : src) x = rand() - RAND_MAX / 2;
+
+        std::vector<int> dst(n, 0);
+        my_stl::__parallel_fill(pool, dst.data(), dst.data() + n, 7);
+        ASSERT_TRUE(std::count(dst.begin(), dst.end(), 7) == (long)n);
+
+        ASSERT_EQ(my_stl::__parallel_copy(pool, src.data(), src.data() + n, dst.data()), dst.data() + n);
+        ASSERT_TRUE(dst == src);
+
+        auto twice = [](int& x) {x *= 2;};
+        my_stl::__parallel_for_each(pool, dst.data(), dst.data() + n, twice);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(dst[i], src[i] * 2);
+
+        auto neg = [](int x) {return -x;};
+        my_stl::__parallel_transform(pool, src.data(), src.data() + n, dst.data(), neg);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(dst[i], -src[i]);
+        auto sub = [](int x, int y) {return x - y;};
+        my_stl::__parallel_transform(pool, src.data(), src.data() + n, dst.data(), dst.data(), sub);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(dst[i], src[i] * 2);
+
+        auto add = [](long long x, long long y) {return x + y;};
+        ASSERT_EQ(my_stl::__parallel_reduce(pool, src.data(), src.data() + n, 5LL, add),
+                std::accumulate(src.data(), src.data() + n, 5LL));
+
+        std::vector<int> sorted(src);
+        std::sort(sorted.begin(), sorted.end());
+        dst = src;
+        my_stl::less<int> less;
+        my_stl::__parallel_sort(pool, dst.data(), dst.data() + n, less);
+        ASSERT_TRUE(dst == sorted) << "size " << n;
+        //sorted, reversed and few keys
+        my_stl::__parallel_sort(pool, dst.data(), dst.data() + n, less);
+        ASSERT_TRUE(dst == sorted);
+        std::reverse(dst.begin(), dst.end());
+        my_stl::__parallel_sort(pool, dst.data(), dst.data() + n, less);
+        ASSERT_TRUE(dst == sorted);
+        for (auto& x : dst) x = rand() % 4;
+        std::vector<int> few(dst);
+        std::sort(few.begin(), few.end());
+        my_stl::__parallel_sort(pool, dst.data(), dst.data() + n, less);
+        ASSERT_TRUE(dst == few);
+    }
+
+    //strings through the object paths
+    std::vector<std::string> s_v;
+    for (int i = 0; i < 100000; ++i) s_v.push_back(std::to_string(rand() % 5000));
+    std::vector<std::string> m_v(s_v);
+    std::sort(s_v.begin(), s_v.end(), std::greater<std::string>());
+    my_stl::greater<std::string> greater;
+    my_stl::__parallel_sort(pool, m_v.data(), m_v.data() + m_v.size(), greater);
+    ASSERT_TRUE(s_v == m_v);
+    auto concat_len = [](size_t acc, size_t len) {return acc + len;};
+    std::vector<size_t> lens(s_v.size());
+    auto len = [](const std::string& s) {return s.size();};
+    my_stl::__parallel_transform(pool, s_v.data(), s_v.data() + s_v.size(), lens.data(), len);
+    size_t total = 0;
+    for (const auto& s : s_v) total += s.size();
+    ASSERT_EQ(my_stl::__parallel_reduce(pool, lens.data(), lens.data() + lens.size(), size_t(0), concat_len),
+            total);
+}
+
+TEST(ExecutionTest, TestParallelUninitialized) {
+    my_stl::thread_pool& pool = test_pool();
+    typedef my_stl::my_simple_alloc<Test_FOO_Heap, my_stl::alloc> heap_alloc;
+    const size_t n = 100000;
+    Test_FOO_Heap* raw = heap_alloc::allocate(n);
+    my_stl::__parallel_uninitialized_fill(pool, raw, raw + n, Test_FOO_Heap(3));
+    for (size_t i = 0; i < n; ++i) ASSERT_TRUE(raw[i] == Test_FOO_Heap(3));
+
+    Test_FOO_Heap* copy = heap_alloc::allocate(n);
+    ASSERT_EQ(my_stl::__parallel_uninitialized_copy(pool, raw, raw + n, copy), copy + n);
+    for (size_t i = 0; i < n; ++i) ASSERT_TRUE(copy[i] == raw[i]);
+    my_stl::destroy(copy, copy + n);
+
+    int* ints = my_stl::my_simple_alloc<int, my_stl::alloc>::allocate(n);
+    my_stl::__parallel_uninitialized_fill(pool, ints, ints + n, 9);
+    ASSERT_TRUE(std::count(ints, ints + n, 9) == (long)n);
+    my_stl::my_simple_alloc<int, my_stl::alloc>::deallocate(ints, n);
+
+    //a copy throwing in one chunk: nothing is left constructed (asan finds the leaks)
+    struct throwing_copy {
+        Test_FOO_Heap val;
+        static std::atomic<int>& copies() {static std::atomic<int> c(0); return c;}
+        throwing_copy(): val(1) {}
+        throwing_copy(const throwing_copy& rhs): val(rhs.val) {
+            if (++copies() == 60000)    throw std::runtime_error("copy");
+        }
+    };
+    std::vector<throwing_copy> objs(n);
+    typedef my_stl::my_simple_alloc<throwing_copy, my_stl::alloc> obj_alloc;
+    throwing_copy* objs_copy = obj_alloc::allocate(n);
+    ASSERT_THROW(my_stl::__parallel_uninitialized_copy(pool, objs.data(), objs.data() + n, objs_copy),
+            std::runtime_error);
+    throwing_copy::copies() = 0;
+    ASSERT_THROW(my_stl::__parallel_uninitialized_fill(pool, objs_copy, objs_copy + n, objs[0]),
+            std::runtime_error);
+    obj_alloc::deallocate(objs_copy, n);
+
+    my_stl::destroy(raw, raw + n);
+    heap_alloc::deallocate(raw, n);
+    heap_alloc::deallocate(copy, n);
+}
+
+//the policy overloads on the shared pool, with random access and other iterators
+TEST(ExecutionTest, TestPolicies) {
+    static_assert(my_stl::is_execution_policy<my_stl::execution::parallel_policy>::value, "");
+    static_assert(!my_stl::is_execution_policy<int>::value, "");
+    srand(29);
+    const size_t n = 300000;
+    my_stl::vector<int> src;
+    for (size_t i = 0; i < n; ++i) src.push_back(rand() % 1000);
+    std::vector<int> sorted(src.begin(), src.end());
+    std::sort(sorted.begin(), sorted.end());
+    const long long sum = std::accumulate(sorted.begin(), sorted.end(), 0LL);
+
+    auto check = [&](const auto& policy) {
+        my_stl::vector<int> v(n, 0);
+        my_stl::fill(policy, v.begin(), v.end(), 5);
+        ASSERT_TRUE(std::count(v.begin(), v.end(), 5) == (long)n);
+        ASSERT_EQ(my_stl::copy(policy, src.begin(), src.end(), v.begin()), v.end());
+        ASSERT_TRUE(v == src);
+        my_stl::for_each(policy, v.begin(), v.end(), [](int& x) {++x;});
+        my_stl::transform(policy, v.begin(), v.end(), v.begin(), [](int x) {return x - 1;});
+        ASSERT_TRUE(v == src);
+        my_stl::transform(policy, v.begin(), v.end(), src.begin(), v.begin(), [](int x, int y) {return x + y;});
+        ASSERT_EQ(my_stl::reduce(policy, v.begin(), v.end()), 2 * sum);
+        ASSERT_EQ(my_stl::reduce(policy, src.begin(), src.end(), 1LL), sum + 1);
+        my_stl::sort(policy, v.begin(), v.end());
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(v[i], 2 * sorted[i]);
+        my_stl::sort(policy, v.begin(), v.end(), my_stl::greater<int>());
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(v[n - 1 - i], 2 * sorted[i]);
+
+        int* raw = my_stl::my_simple_alloc<int, my_stl::alloc>::allocate(n);
+        my_stl::uninitialized_fill(policy, raw, raw + n, 3);
+        ASSERT_TRUE(std::count(raw, raw + n, 3) == (long)n);
+        ASSERT_EQ(my_stl::uninitialized_copy(policy, src.begin(), src.end(), raw), raw + n);
+        ASSERT_TRUE(std::equal(raw, raw + n, src.begin()));
+        my_stl::my_simple_alloc<int, my_stl::alloc>::deallocate(raw, n);
+
+        //a list is not split
+        my_stl::list<int> l;
+        for (int i = 0; i < 1000; ++i) l.push_back(i);
+        my_stl::for_each(policy, l.begin(), l.end(), [](int& x) {x *= 3;});
+        ASSERT_EQ(my_stl::reduce(policy, l.begin(), l.end(), 0), 3 * 999 * 1000 / 2);
+        my_stl::fill(policy, l.begin(), l.end(), 1);
+        ASSERT_EQ(my_stl::reduce(policy, l.begin(), l.end()), 1000);
+    };
+    check(my_stl::execution::seq);
+    check(my_stl::execution::par);
+    check(my_stl::execution::par_unseq);
+}
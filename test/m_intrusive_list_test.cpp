@@ -0,0 +1,153 @@
+#include "../src/m_intrusive_list.h"
+#include <list>
+#include <vector>
+#include <algorithm>   //for std::stable_sort
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+
+//an object in two lists at a time, the payload tells whether the sort is stable
+struct timer {
+    int deadline;
+    int id;
+    my_stl::intrusive_list_hook by_deadline;
+    my_stl::intrusive_list_hook by_owner;
+
+    timer(int d, int i): deadline(d), id(i) {}
+    bool operator<(const timer& rhs) const {
+        return deadline < rhs.deadline;
+    }
+};
+
+using deadline_list = my_stl::intrusive_list<timer, &timer::by_deadline>;
+using owner_list = my_stl::intrusive_list<timer, &timer::by_owner>;
+
+inline std::vector<int> ids(const deadline_list& l) {
+    std::vector<int> res;
+    for (const timer& t: l) res.push_back(t.id);
+    return res;
+}
+
+TEST(IntrusiveListTest, TestInsertAndErase) {
+    std::vector<timer> timers;
+    for (int i = 0; i < 10; ++i) timers.emplace_back(i, i);
+    deadline_list l;
+    owner_list o;
+    ASSERT_TRUE(l.empty());
+    for (timer& t: timers) {
+        l.push_back(t);
+        o.push_front(t);
+    }
+    ASSERT_EQ(l.size(), 10);
+    ASSERT_EQ(l.front().id, 0);
+    ASSERT_EQ(l.back().id, 9);
+    ASSERT_EQ(o.front().id, 9);
+    ASSERT_EQ(o.crbegin() -> id, 0);
+
+    //erase through the object, the other list does not change
+    auto it = l.erase(l.iterator_to(timers[4]));
+    ASSERT_EQ(it -> id, 5);
+    ASSERT_FALSE(timers[4].by_deadline.is_linked());
+    ASSERT_TRUE(timers[4].by_owner.is_linked());
+    ASSERT_EQ(l.size(), 9);
+    ASSERT_EQ(o.size(), 10);
+    l.insert(l.iterator_to(timers[2]), timers[4]);
+    ASSERT_EQ(ids(l), std::vector<int>({0, 1, 4, 2, 3, 5, 6, 7, 8, 9}));
+    l.pop_front();
+    l.pop_back();
+    l.erase(l.iterator_to(timers[3]), l.iterator_to(timers[7]));
+    ASSERT_EQ(ids(l), std::vector<int>({1, 4, 2, 7, 8}));
+    ASSERT_FALSE(timers[5].by_deadline.is_linked());
+
+    //a copy of an object is in no list
+    timer copy(timers[1]);
+    ASSERT_FALSE(copy.by_deadline.is_linked());
+
+    l.clear();
+    ASSERT_TRUE(l.empty());
+    for (timer& t: timers) ASSERT_FALSE(t.by_deadline.is_linked());
+}
+
+TEST(IntrusiveListTest, TestSpliceAndMove) {
+    std::vector<timer> timers;
+    for (int i = 0; i < 10; ++i) timers.emplace_back(i, i);
+    deadline_list l1, l2;
+    for (int i = 0; i < 5; ++i) {
+        l1.push_back(timers[i]);
+        l2.push_back(timers[5 + i]);
+    }
+    l1.splice(l1.iterator_to(timers[2]), l2, l2.iterator_to(timers[6]), l2.iterator_to(timers[8]));
+    ASSERT_EQ(ids(l1), std::vector<int>({0, 1, 6, 7, 2, 3, 4}));
+    ASSERT_EQ(l1.size(), 7);
+    ASSERT_EQ(l2.size(), 3);
+    l1.splice(l1.cbegin(), l2, l2.iterator_to(timers[9]));
+    l1.splice(l1.cend(), l1, l1.cbegin());
+    ASSERT_EQ(ids(l1), std::vector<int>({0, 1, 6, 7, 2, 3, 4, 9}));
+    l2.splice(l2.cend(), l1);
+    ASSERT_TRUE(l1.empty());
+    ASSERT_EQ(l2.size(), 10);
+
+    //the end node moves with the list
+    deadline_list l3(std::move(l2));
+    ASSERT_TRUE(l2.empty());
+    ASSERT_EQ(l3.size(), 10);
+    ASSERT_EQ(ids(l3), std::vector<int>({5, 8, 0, 1, 6, 7, 2, 3, 4, 9}));
+    timer extra(20, 20);
+    l1.push_back(extra);
+    l1.swap(l3);
+    ASSERT_EQ(l1.size(), 10);
+    ASSERT_EQ(l3.size(), 1);
+    ASSERT_EQ(l1.back().id, 9);
+    ASSERT_EQ((--l1.end()) -> id, 9);
+    ASSERT_EQ(l3.front().id, 20);
+    l3 = std::move(l1);
+    ASSERT_FALSE(extra.by_deadline.is_linked());
+    ASSERT_EQ(l3.size(), 10);
+    ASSERT_EQ(ids(l3).front(), 5);
+}
+
+TEST(IntrusiveListTest, TestMergeAndSort) {
+    std::vector<timer> timers;
+    srand(5);
+    for (int i = 0; i < 1000; ++i) timers.emplace_back(rand() % 50, i);
+    deadline_list l1, l2;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3)  l1.push_back(timers[i]);
+        else    l2.push_back(timers[i]);
+    }
+    l1.sort();
+    l2.sort();
+    l1.merge(l2);
+    ASSERT_TRUE(l2.empty());
+    ASSERT_EQ(l1.size(), 1000);
+    //for equal deadlines, the ones from l1 come first, in their order
+    for (auto prev = l1.begin(), it = ++l1.begin(); it != l1.end(); ++prev, ++it) {
+        ASSERT_LE(prev -> deadline, it -> deadline);
+        if (prev -> deadline == it -> deadline) {
+            bool prev_l1 = prev -> id % 3 != 0, it_l1 = it -> id % 3 != 0;
+            ASSERT_TRUE(prev_l1 >= it_l1);
+            if (prev_l1 == it_l1) {
+                ASSERT_LT(prev -> id, it -> id);
+            }
+        }
+    }
+    l1.clear();
+    for (timer& t: timers) l1.push_back(t);
+
+    //the same as a stable sort by deadline
+    std::vector<timer*> expected;
+    for (timer& t: timers) expected.push_back(&t);
+    std::stable_sort(expected.begin(), expected.end(),
+            [](const timer* a, const timer* b) {return a -> deadline < b -> deadline;});
+    l1.sort();
+    auto it = l1.begin();
+    for (timer* t: expected) {
+        ASSERT_EQ(&*it, t);
+        ++it;
+    }
+    //backwards
+    auto rit = l1.rbegin();
+    for (auto e = expected.rbegin(); e != expected.rend(); ++e, ++rit) {
+        ASSERT_EQ(&*rit, *e);
+    }
+}
@@ -1,8 +1,13 @@
-#include "../src/m_list.h"
+#include "../src/m_list_parallel.h"
 #include <list>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <algorithm>   //for std::sort
+#include <vector>
+#include <stdexcept>
+#include <atomic>
+#include <array>
+#include <new>          //for bad_alloc
 #include "test_objects.h"
 
 
@@ -510,3 +515,303 @@ TEST(ListTest, ListEmplaceTest) {
     }
     assertListEqual(s_ls, m_ls);
 }
+
+//the iterator n steps after it
+template <typename Iterator>
+inline Iterator nth(Iterator it, int n) {
+    for (; n > 0; --n) ++it;
+    return it;
+}
+
+TEST(ListTest, ListSizeTest) {
+    std::list<int> s_l1, s_l2;
+    my_stl::list<int> m_l1, m_l2;
+    for (int i = 0; i < 100; ++i) {
+        s_l1.push_back(i);
+        m_l1.push_back(i);
+        s_l2.emplace_front(-i);
+        m_l2.emplace_front(-i);
+    }
+    m_l1.emplace_back(1000);
+    s_l1.emplace_back(1000);
+    assertListSize(s_l1, m_l1);
+    assertListSize(s_l2, m_l2);
+
+    //insert and erase
+    s_l1.insert(nth(s_l1.begin(), 10), 20, 5);
+    m_l1.insert(nth(m_l1.cbegin(), 10), 20, 5);
+    s_l1.erase(nth(s_l1.begin(), 5), nth(s_l1.begin(), 15));
+    m_l1.erase(nth(m_l1.cbegin(), 5), nth(m_l1.cbegin(), 15));
+    s_l1.pop_front();
+    m_l1.pop_front();
+    assertListEqual(s_l1, m_l1);
+
+    //splice a range from the other list, a single element and a range of the list itself
+    s_l1.splice(s_l1.begin(), s_l2, nth(s_l2.begin(), 3), nth(s_l2.begin(), 40));
+    m_l1.splice(m_l1.cbegin(), m_l2, nth(m_l2.cbegin(), 3), nth(m_l2.cbegin(), 40));
+    assertListEqual(s_l1, m_l1);
+    assertListEqual(s_l2, m_l2);
+    s_l1.splice(s_l1.end(), s_l2, s_l2.begin());
+    m_l1.splice(m_l1.cend(), m_l2, m_l2.cbegin());
+    s_l1.splice(s_l1.end(), s_l1, s_l1.begin(), nth(s_l1.begin(), 7));
+    m_l1.splice(m_l1.cend(), m_l1, m_l1.cbegin(), nth(m_l1.cbegin(), 7));
+    assertListEqual(s_l1, m_l1);
+    assertListEqual(s_l2, m_l2);
+
+    //remove, unique, sort and merge
+    s_l1.remove(5);
+    m_l1.remove(5);
+    s_l1.sort();
+    m_l1.sort();
+    s_l2.sort();
+    m_l2.sort();
+    s_l1.merge(s_l2);
+    m_l1.merge(m_l2);
+    assertListEqual(s_l1, m_l1);
+    assertListEqual(s_l2, m_l2);
+    s_l1.unique();
+    m_l1.unique();
+    assertListEqual(s_l1, m_l1);
+
+    //whole list splice, swap, assign and move
+    s_l2.assign(30, 2);
+    m_l2.assign(30, 2);
+    s_l2.assign(10, 3);
+    m_l2.assign(10, 3);
+    assertListEqual(s_l2, m_l2);
+    s_l1.swap(s_l2);
+    m_l1.swap(m_l2);
+    assertListEqual(s_l1, m_l1);
+    s_l1.splice(s_l1.begin(), s_l2);
+    m_l1.splice(m_l1.cbegin(), m_l2);
+    assertListEqual(s_l1, m_l1);
+    assertListSize(s_l2, m_l2);
+    my_stl::list<int> m_l3(std::move(m_l1));
+    ASSERT_EQ(m_l3.size(), s_l1.size());
+    m_l2 = std::move(m_l3);
+    assertListEqual(s_l1, m_l2);
+    m_l2.clear();
+    ASSERT_EQ(m_l2.size(), 0);
+}
+
+TEST(ListTest, ListNodePoolTest) {
+    using pool_type = my_stl::node_pool<my_stl::__malloc_alloc<0>, 16>;
+    using pool_list = my_stl::list<std::string, pool_type>;
+    std::list<std::string> s_l1, s_l2;
+    pool_list m_l1, m_l2;
+    for (int i = 0; i < 100; ++i) {
+        s_l1.push_back(std::to_string(i * 7 % 100));
+        m_l1.push_back(std::to_string(i * 7 % 100));
+        s_l2.push_front(std::to_string(i));
+        m_l2.push_front(std::to_string(i));
+    }
+    ASSERT_TRUE(m_l1.get_allocator() != m_l2.get_allocator());
+    //the erased nodes are reused
+    size_t cap = m_l1.get_allocator().capacity();
+    for (int i = 0; i < 50; ++i) {
+        m_l1.pop_front();
+        m_l1.push_back("x");
+    }
+    ASSERT_EQ(m_l1.get_allocator().capacity(), cap);
+
+    //sorting does not set up pools of its own
+    m_l1.sort();
+    m_l2.sort();
+    ASSERT_EQ(m_l1.get_allocator().capacity(), cap);
+
+    //nodes moving across lists join the pools, the source can go away afterwards
+    {
+        pool_list m_l3;
+        m_l3.push_back("a");
+        m_l3.push_back("b");
+        m_l2.splice(m_l2.cbegin(), m_l3, m_l3.cbegin());
+        m_l1.merge(m_l3);
+    }
+    ASSERT_TRUE(m_l1.get_allocator() == m_l2.get_allocator());
+    ASSERT_EQ(m_l1.size(), 101);
+    ASSERT_EQ(m_l2.size(), 101);
+    m_l1.clear();
+    {
+        pool_list m_l4(std::move(m_l2));
+    }
+    m_l1.shrink_to_fit();
+    //only the slab holding the end node of m_l1 is left
+    ASSERT_EQ(m_l1.get_allocator().capacity(), 16);
+
+    //a list can be told which pool to use
+    pool_type pool;
+    pool_list m_l5(pool), m_l6(pool);
+    m_l5.assign(s_l1.begin(), s_l1.end());
+    m_l6 = m_l5;
+    ASSERT_TRUE(m_l5.get_allocator() == pool);
+    ASSERT_TRUE(m_l6.get_allocator() != pool);
+    m_l5.sort();
+    s_l1.sort();
+    ASSERT_TRUE(std::equal(s_l1.begin(), s_l1.end(), m_l5.begin()));
+
+    //joining the pools may fail, so moving a whole list in is noexcept only without them
+    static_assert(std::is_nothrow_move_assignable<my_stl::list<std::string>>::value,
+            "a list with a stateless allocator moves without throwing");
+    static_assert(!std::is_nothrow_move_assignable<pool_list>::value,
+            "a list with a node pool may throw joining the pools");
+    static_assert(!noexcept(m_l5.splice(m_l5.cend(), m_l6)), "splice joins the pools");
+    //a pool already used for bigger nodes can not be joined, the target is left as it was
+    pool_type big_pool;
+    my_stl::list<std::array<char, 256>, pool_type> m_big(big_pool);
+    m_big.push_back(std::array<char, 256>());
+    pool_list m_l7(big_pool), m_l8;
+    m_l7.push_back("from a big pool");
+    m_l8.push_back("kept");
+    ASSERT_THROW(m_l8 = std::move(m_l7), std::bad_alloc);
+    ASSERT_EQ(m_l8.size(), 1);
+    ASSERT_EQ(m_l8.front(), "kept");
+    ASSERT_EQ(m_l7.size(), 1);
+}
+
+//sort by the key only, the payload tells whether the equal keys kept their order
+struct key_less {
+    bool operator()(const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) const {
+        return lhs.first < rhs.first;
+    }
+};
+
+TEST(ListTest, ListStableSortTest) {
+    std::list<std::pair<int, int>> s_l;
+    my_stl::list<std::pair<int, int>> m_l;
+    srand(9);
+    for (int i = 0; i < 2000; ++i) {
+        std::pair<int, int> p(rand() % 30, i);
+        s_l.push_back(p);
+        m_l.push_back(p);
+    }
+    s_l.sort(key_less());
+    m_l.sort(key_less());
+    ASSERT_TRUE(std::equal(s_l.begin(), s_l.end(), m_l.begin()));
+}
+
+//sort lists of the shapes the run detection and the galloping care about
+TEST(ListTest, ListNaturalSortTest) {
+    srand(11);
+    std::vector<std::vector<int>> shapes;
+    for (int n : {0, 1, 2, 15, 16, 17, 100, 3000}) {
+        std::vector<int> v(n);
+        //sorted, reversed, sawtooth, organ pipe, few keys, mostly sorted, random
+        for (int i = 0; i < n; ++i) v[i] = i;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = (n - i) / 3;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = i % 50;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = i < n / 2 ? i : n - i;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = rand() % 3;
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = i;
+        for (int i = 0; i < n / 100; ++i) std::swap(v[rand() % n], v[rand() % n]);
+        shapes.push_back(v);
+        for (int i = 0; i < n; ++i) v[i] = rand() % 1000;
+        shapes.push_back(v);
+    }
+    for (const auto& v : shapes) {
+        std::list<std::pair<int, int>> s_l;
+        my_stl::list<std::pair<int, int>> m_l;
+        for (size_t i = 0; i < v.size(); ++i) {
+            s_l.push_back(std::make_pair(v[i], i));
+            m_l.push_back(std::make_pair(v[i], i));
+        }
+        s_l.sort(key_less());
+        m_l.sort(key_less());
+        ASSERT_EQ(m_l.size(), s_l.size());
+        ASSERT_TRUE(std::equal(s_l.begin(), s_l.end(), m_l.begin()));
+        //the prev links are right too
+        ASSERT_TRUE(std::equal(s_l.rbegin(), s_l.rend(), m_l.rbegin()));
+    }
+
+    //a sorted or reversed list is one run
+    size_t count = 0;
+    auto counting_less = [&count](int lhs, int rhs) {++count; return lhs < rhs;};
+    my_stl::list<int> m_l;
+    for (int i = 0; i < 1000; ++i) m_l.push_front(i);
+    m_l.sort(counting_less);
+    ASSERT_EQ(count, 999);
+    count = 0;
+    m_l.sort(counting_less);
+    ASSERT_EQ(count, 999);
+
+    //a throwing comparison leaves all the elements in the list
+    m_l.clear();
+    for (int i = 0; i < 1000; ++i) m_l.push_back(rand() % 100);
+    std::vector<int> before, after, after_back;
+    for (int x : m_l)   before.push_back(x);
+    count = 0;
+    auto throwing_less = [&count](int lhs, int rhs) {
+        if (++count == 5000)    throw std::runtime_error("comparison");
+        return lhs < rhs;
+    };
+    ASSERT_THROW(m_l.sort(throwing_less), std::runtime_error);
+    ASSERT_EQ(m_l.size(), 1000);
+    for (int x : m_l)   after.push_back(x);
+    for (auto it = m_l.rbegin(); it != m_l.rend(); ++it)    after_back.push_back(*it);
+    ASSERT_TRUE(std::equal(after.rbegin(), after.rend(), after_back.begin()));
+    std::sort(before.begin(), before.end());
+    std::sort(after.begin(), after.end());
+    ASSERT_TRUE(before == after);
+}
+
+TEST(ListTest, ListParallelSortTest) {
+    srand(13);
+    //short lists are sorted on this thread, long ones are cut up to 3 and 4 ways
+    for (int n : {0, 1, 1000, 100000, 200000}) {
+        for (size_t threads : {3, 4}) {
+            std::list<std::pair<int, int>> s_l;
+            my_stl::list<std::pair<int, int>> m_l;
+            for (int i = 0; i < n; ++i) {
+                std::pair<int, int> p(rand() % 1000, i);
+                s_l.push_back(p);
+                m_l.push_back(p);
+            }
+            s_l.sort(key_less());
+            my_stl::parallel_sort(m_l, key_less(), threads);
+            ASSERT_EQ(m_l.size(), s_l.size());
+            ASSERT_TRUE(std::equal(s_l.begin(), s_l.end(), m_l.begin()));
+            ASSERT_TRUE(std::equal(s_l.rbegin(), s_l.rend(), m_l.rbegin()));
+        }
+    }
+    my_stl::list<int> m_l;
+    for (int i = 0; i < 100000; ++i) m_l.push_back(100000 - i);
+    my_stl::parallel_sort(m_l);
+    ASSERT_TRUE(std::is_sorted(m_l.begin(), m_l.end()));
+
+    //a comparison throwing on one of the threads leaves all the elements in the list
+    std::atomic<int> count(0);
+    auto throwing_less = [&count](int lhs, int rhs) {
+        if (++count == 150000)  throw std::runtime_error("comparison");
+        return lhs < rhs;
+    };
+    m_l.clear();
+    long long sum = 0;
+    for (int i = 0; i < 100000; ++i) {
+        m_l.push_back(rand());
+        sum += m_l.back();
+    }
+    ASSERT_THROW(my_stl::parallel_sort(m_l, throwing_less, 4), std::runtime_error);
+    ASSERT_EQ(m_l.size(), 100000);
+    size_t backward = 0;
+    for (auto it = m_l.rbegin(); it != m_l.rend(); ++it)    ++backward;
+    ASSERT_EQ(backward, 100000);
+    for (int x : m_l)   sum -= x;
+    ASSERT_EQ(sum, 0);
+
+    //the quarters are sorted already, so this time it throws in a merge
+    m_l.clear();
+    for (int i = 0; i < 100000; ++i) m_l.push_back(i % 25000);
+    count = -20000;
+    ASSERT_THROW(my_stl::parallel_sort(m_l, throwing_less, 4), std::runtime_error);
+    ASSERT_EQ(m_l.size(), 100000);
+    backward = 0;
+    for (auto it = m_l.rbegin(); it != m_l.rend(); ++it)    ++backward;
+    ASSERT_EQ(backward, 100000);
+    sum = 0;
+    for (int x : m_l)   sum += x;
+    ASSERT_EQ(sum, 4LL * 24999 * 25000 / 2);
+}
@@ -0,0 +1,214 @@
+#include "../src/m_small_vector.h"
+#include "../src/m_vector.h"
+#include <gtest/gtest.h>
+#include "test_objects.h"
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+
+//whether the elements live inside the object
+template <typename V>
+static bool isInline(V& v) {
+    const char* p = (const char*)v.begin();
+    return p >= (const char*)&v && p < (const char*)(&v + 1);
+}
+
+//the elements of mv against the ones of sv
+template <typename T, typename V>
+static void assertSame(const std::vector<T>& sv, V& mv) {
+    ASSERT_EQ(sv.size(), mv.size());
+    for (size_t i = 0; i < sv.size(); ++i) {
+        ASSERT_TRUE(sv[i] == mv[i]) << "the " << i << "th element";
+    }
+}
+
+TEST(SmallVectorTest, TestInlineUntilFull) {
+    my_stl::small_vector<int, 8> v;
+    ASSERT_TRUE(v.empty());
+    ASSERT_EQ(v.capacity(), 8);
+    ASSERT_TRUE(isInline(v));
+    std::vector<int> s;
+    for (int i = 0; i < 8; ++i) {
+        v.push_back(i);
+        s.push_back(i);
+        ASSERT_TRUE(isInline(v));
+    }
+    assertSame(s, v);
+    //the ninth goes to the heap, twice the size
+    v.push_back(8);
+    s.push_back(8);
+    ASSERT_FALSE(isInline(v));
+    ASSERT_EQ(v.capacity(), 16);
+    assertSame(s, v);
+    for (int i = 9; i < 1000; ++i) {
+        v.emplace_back(i);
+        s.push_back(i);
+    }
+    assertSame(s, v);
+    //clear keeps the heap storage
+    v.clear();
+    ASSERT_TRUE(v.empty());
+    ASSERT_FALSE(isInline(v));
+
+    //a zero sized buffer is a plain vector
+    my_stl::small_vector<std::string, 0> z;
+    z.push_back("a");
+    ASSERT_FALSE(isInline(z));
+    ASSERT_EQ(z[0], "a");
+}
+
+TEST(SmallVectorTest, TestConstruction) {
+    my_stl::small_vector<std::string, 4> a(3, std::string("three"));
+    ASSERT_TRUE(isInline(a));
+    assertSame(std::vector<std::string>(3, "three"), a);
+    my_stl::small_vector<std::string, 4> b(10, std::string("ten"));
+    ASSERT_FALSE(isInline(b));
+    ASSERT_EQ(b.capacity(), 10);
+    assertSame(std::vector<std::string>(10, "ten"), b);
+
+    my_stl::small_vector<int, 4> il = {1, 2, 3};
+    assertSame(std::vector<int>({1, 2, 3}), il);
+    my_stl::small_vector<int, 4> n(6);
+    assertSame(std::vector<int>(6), n);
+
+    std::vector<Test_FOO_Heap> s;
+    for (int i = 0; i < 20; ++i) s.push_back(Test_FOO_Heap(i));
+    for (size_t len : {0, 2, 5, 20}) {
+        my_stl::small_vector<Test_FOO_Heap, 5> r(s.data(), s.data() + len);
+        ASSERT_EQ(isInline(r), len <= 5);
+        assertSame(std::vector<Test_FOO_Heap>(s.begin(), s.begin() + len), r);
+
+        //copies, moves and swaps between inline and heap ones
+        my_stl::small_vector<Test_FOO_Heap, 5> c(r);
+        ASSERT_TRUE(c == r);
+        my_stl::small_vector<Test_FOO_Heap, 5> m(std::move(c));
+        ASSERT_TRUE(m == r);
+        ASSERT_TRUE(c.empty());
+        for (size_t other : {0, 3, 12}) {
+            my_stl::small_vector<Test_FOO_Heap, 5> o(s.data(), s.data() + other);
+            my_stl::small_vector<Test_FOO_Heap, 5> o_copy(o), m_copy(m);
+            o.swap(m);
+            ASSERT_TRUE(o == m_copy);
+            ASSERT_TRUE(m == o_copy);
+            o = m;
+            ASSERT_TRUE(o == o_copy);
+            o = std::move(m);
+            ASSERT_TRUE(o == o_copy);
+            ASSERT_TRUE(m.empty());
+            m = std::move(o);
+        }
+    }
+}
+
+TEST(SmallVectorTest, TestModifiers) {
+    std::vector<std::string> s;
+    my_stl::small_vector<std::string, 6> v;
+    for (int i = 0; i < 4; ++i) {
+        s.push_back(std::to_string(i));
+        v.push_back(std::to_string(i));
+    }
+    //in place while it fits, then to the heap
+    s.insert(s.begin() + 1, 2, "x");
+    v.insert(v.begin() + 1, 2, std::string("x"));
+    ASSERT_TRUE(isInline(v));
+    assertSame(s, v);
+    s.insert(s.begin() + 3, 5, "y");
+    v.insert(v.begin() + 3, 5, std::string("y"));
+    ASSERT_FALSE(isInline(v));
+    assertSame(s, v);
+    //the value may be one of the elements
+    s.insert(s.begin(), 20, s[4]);
+    v.insert(v.begin(), 20, v[4]);
+    assertSame(s, v);
+
+    s.erase(s.begin() + 2, s.begin() + 10);
+    v.erase(v.begin() + 2, v.begin() + 10);
+    assertSame(s, v);
+    s.erase(s.begin());
+    v.erase(v.begin());
+    assertSame(s, v);
+    s.pop_back();
+    v.pop_back();
+    assertSame(s, v);
+
+    s.resize(40, "z");
+    v.resize(40, std::string("z"));
+    assertSame(s, v);
+    s.resize(3);
+    v.resize(3);
+    assertSame(s, v);
+    ASSERT_EQ(v.front(), s.front());
+    ASSERT_EQ(v.back(), s.back());
+
+    my_stl::small_vector<int, 16> r;
+    r.reserve(8);
+    ASSERT_TRUE(isInline(r));
+    r.reserve(100);
+    ASSERT_FALSE(isInline(r));
+    ASSERT_EQ(r.capacity(), 100);
+}
+
+//the elements are small vectors, moving them on growth moves the inline ones one by one
+TEST(SmallVectorTest, TestNested) {
+    my_stl::vector<my_stl::small_vector<std::string, 2>> vv;
+    for (int i = 0; i < 100; ++i) {
+        my_stl::small_vector<std::string, 2> inner;
+        for (int j = 0; j < i % 4; ++j) inner.push_back(std::to_string(i * 10 + j));
+        vv.push_back(std::move(inner));
+    }
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(vv[i].size(), size_t(i % 4));
+        ASSERT_EQ(isInline(vv[i]), i % 4 <= 2);
+        for (int j = 0; j < i % 4; ++j) ASSERT_EQ(vv[i][j], std::to_string(i * 10 + j));
+    }
+}
+
+//same as in vector, the copy ctor may throw after a few copies
+struct ThrowingCopy {
+    static int copies_before_throw;
+    int value;
+    ThrowingCopy(int v): value(v) {}
+    ThrowingCopy(const ThrowingCopy& rhs): value(rhs.value) {
+        if (copies_before_throw == 0)   throw std::runtime_error("copy failed");
+        --copies_before_throw;
+    }
+    ThrowingCopy(ThrowingCopy&& rhs): value(rhs.value) {}
+};
+int ThrowingCopy::copies_before_throw = -1;
+
+TEST(SmallVectorTest, TestStrongExceptionSafety) {
+    my_stl::small_vector<ThrowingCopy, 4> v;
+    for (int i = 0; i < 4; ++i) v.push_back(ThrowingCopy(i));
+    //the move ctor may throw, so the spill copies, and the third copy fails
+    ThrowingCopy::copies_before_throw = 2;
+    ASSERT_THROW(v.push_back(ThrowingCopy(4)), std::runtime_error);
+    ThrowingCopy::copies_before_throw = -1;
+    ASSERT_TRUE(isInline(v));
+    ASSERT_EQ(v.size(), 4);
+    for (int i = 0; i < 4; ++i) ASSERT_EQ(v[i].value, i);
+
+    std::vector<ThrowingCopy> source(10, ThrowingCopy(1));
+    for (int len : {3, 10}) {
+        ThrowingCopy::copies_before_throw = 2;
+        ASSERT_THROW((my_stl::small_vector<ThrowingCopy, 4>(source.data(), source.data() + len)),
+                std::runtime_error);
+    }
+    ThrowingCopy::copies_before_throw = -1;
+}
+
+TEST(SmallVectorTest, TestElementAccess) {
+    my_stl::small_vector<int, 4> v;
+    ASSERT_TRUE(isInline(v));
+    ASSERT_EQ(v.data(), v.begin());
+    ASSERT_THROW(v.at(0), std::out_of_range);
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(i);
+        ASSERT_EQ(v.data(), &v[0]);
+        ASSERT_EQ(v.at(i), i);
+    }
+    const my_stl::small_vector<int, 4>& cv = v;
+    ASSERT_EQ(cv.data(), v.data());
+    ASSERT_EQ(cv.at(9), 9);
+    ASSERT_THROW(cv.at(10), std::out_of_range);
+}
@@ -0,0 +1,125 @@
+#include "../src/m_thread_pool.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+
+
+//the machine running the tests may have a single core, these pools have threads anyway
+TEST(ThreadPoolTest, TestForkJoin) {
+    my_stl::thread_pool pool(3);
+    ASSERT_EQ(pool.size(), 3u);
+    ASSERT_EQ(pool.concurrency(), 4u);
+
+    std::vector<std::atomic<int>> hits(10000);
+    my_stl::task_group group(pool);
+    for (size_t i = 0; i < hits.size(); ++i) {
+        group.fork([&hits, i] {++hits[i];});
+    }
+    group.join();
+    for (auto& h : hits) ASSERT_EQ(h.load(), 1);
+
+    //the group can be used again after join
+    for (size_t i = 0; i < hits.size(); ++i) {
+        group.fork([&hits, i] {++hits[i];});
+    }
+    group.join();
+    for (auto& h : hits) ASSERT_EQ(h.load(), 2);
+
+    //a pool without workers runs everything in join
+    my_stl::thread_pool empty(0);
+    my_stl::task_group alone(empty);
+    int count = 0;
+    for (int i = 0; i < 100; ++i) alone.fork([&count] {++count;});
+    alone.join();
+    ASSERT_EQ(count, 100);
+}
+
+//fib by forking both halves, thousands of nested groups waiting on each other
+static long long fib(my_stl::thread_pool& pool, int n) {
+    if (n < 12) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    long long a = 0, b = 0;
+    my_stl::task_group group(pool);
+    group.fork([&pool, &a, n] {a = fib(pool, n - 1);});
+    group.fork([&pool, &b, n] {b = fib(pool, n - 2);});
+    group.join();
+    return a + b;
+}
+
+TEST(ThreadPoolTest, TestNestedGroups) {
+    my_stl::thread_pool pool(3);
+    ASSERT_EQ(fib(pool, 27), 196418);
+
+    //several threads forking into the same pool at once
+    std::atomic<long long> total(0);
+    auto work = [&pool, &total] {
+        for (int i = 0; i < 20; ++i) total += fib(pool, 18);
+    };
+    std::thread t1(work), t2(work);
+    work();
+    t1.join();
+    t2.join();
+    ASSERT_EQ(total.load(), 60 * 2584);
+}
+
+TEST(ThreadPoolTest, TestExceptions) {
+    my_stl::thread_pool pool(3);
+    my_stl::task_group group(pool);
+    std::atomic<int> ran(0);
+    for (int i = 0; i < 10000; ++i) {
+        group.fork([&ran, i] {
+            ++ran;
+            if (i == 100)   throw std::runtime_error("task");
+        });
+    }
+    ASSERT_THROW(group.join(), std::runtime_error);
+    ASSERT_LE(ran.load(), 10000);
+    //the error is gone after join
+    group.fork([&ran] {++ran;});
+    group.join();
+
+    //the destructor waits and drops the exception
+    {
+        my_stl::task_group dropped(pool);
+        dropped.fork([] {throw std::runtime_error("dropped");});
+    }
+}
+
+TEST(ThreadPoolTest, TestParallelFor) {
+    my_stl::thread_pool pool(3);
+    for (size_t n : {0, 1, 7, 1000, 100000}) {
+        for (size_t grain : {0, 1, 16, 5000}) {
+            std::vector<std::atomic<int>> hits(n);
+            std::atomic<size_t> pieces(0);
+            my_stl::parallel_for(pool, size_t(0), n, grain, [&](size_t b, size_t e) {
+                ASSERT_TRUE(b < e);
+                ASSERT_TRUE(e - b <= (grain ? grain : 1));
+                for (size_t i = b; i < e; ++i) ++hits[i];
+                ++pieces;
+            });
+            for (auto& h : hits) ASSERT_EQ(h.load(), 1);
+        }
+    }
+
+    //iterators work too
+    std::vector<int> v(50000, 1);
+    my_stl::parallel_for(pool, v.data(), v.data() + v.size(), 100, [](int* b, int* e) {
+        for (; b != e; ++b) *b *= 3;
+    });
+    for (int x : v) ASSERT_EQ(x, 3);
+
+    //a throwing piece comes out of parallel_for
+    ASSERT_THROW(my_stl::parallel_for(pool, 0, 100000, 10, [](int b, int) {
+                if (b >= 50000) throw std::runtime_error("piece");
+            }), std::runtime_error);
+
+    //the shared pool
+    std::atomic<long long> sum(0);
+    my_stl::parallel_for(0, 100000, 1000, [&sum](int b, int e) {
+        long long s = 0;
+        for (int i = b; i < e; ++i) s += i;
+        sum += s;
+    });
+    ASSERT_EQ(sum.load(), 99999LL * 100000 / 2);
+}
@@ -186,3 +186,62 @@ TEST(TypeTraitsTest, TestAddReference) {
 
 
 
+
+struct not_relocatable {
+    not_relocatable* self;
+    not_relocatable(): self(this) {}
+    not_relocatable(const not_relocatable&): self(this) {}
+};
+
+struct opt_in_relocatable {
+    int* p;
+    opt_in_relocatable(const opt_in_relocatable& rhs): p(new int(*rhs.p)) {}
+    ~opt_in_relocatable() {delete p;}
+};
+
+namespace my_stl {
+    template <>
+    struct is_trivially_relocatable<opt_in_relocatable>: true_type {};
+}
+
+TEST(TypeTraitsTest, TestIsTriviallyRelocatable) {
+    static_assert(is_trivially_relocatable_v<int>, "relocatable traits failed");
+    static_assert(is_trivially_relocatable_v<const double>, "relocatable traits failed");
+    static_assert(is_trivially_relocatable_v<Test_FOO_Heap*>, "relocatable traits failed");
+    static_assert(!is_trivially_relocatable_v<not_relocatable>, "relocatable traits failed");
+    static_assert(is_trivially_relocatable_v<opt_in_relocatable>, "relocatable traits failed");
+}
+
+TEST(TypeTraitsTest, TestIsConstructible) {
+    static_assert(is_constructible_v<int, int>, "is_constructible traits failed");
+    static_assert(!is_constructible_v<int*, int>, "is_constructible traits failed");
+    static_assert(is_copy_constructible_v<not_relocatable>, "is_constructible traits failed");
+    static_assert(!is_nothrow_move_constructible_v<not_relocatable>, "is_constructible traits failed");
+    static_assert(is_nothrow_move_constructible_v<Test_FOO_Heap>, "is_constructible traits failed");
+}
+
+struct pod_record {
+    int i;
+    double d;
+    char c[4];
+};
+
+TEST(TypeTraitsTest, TestTriviality) {
+    static_assert(is_pod_v<pod_record>, "is_pod traits failed");
+    static_assert(is_trivial_v<int*>, "is_trivial traits failed");
+    static_assert(!is_trivial_v<Test_FOO_Simple>, "is_trivial traits failed");
+    static_assert(is_trivially_copyable_v<Test_FOO_Simple>, "is_trivially_copyable traits failed");
+    static_assert(!is_trivially_copyable_v<Test_FOO_Heap>, "is_trivially_copyable traits failed");
+    static_assert(is_trivially_destructible_v<Test_FOO_Array>, "is_trivially_destructible traits failed");
+    static_assert(!is_trivially_destructible_v<opt_in_relocatable>, "is_trivially_destructible traits failed");
+
+    //the SGI traits now come from the compiler, user classes get the fast path as well
+    static_assert(__type_traits<pod_record>::is_POD_type::value, "__type_traits failed");
+    static_assert(__type_traits<Test_FOO_Simple>::has_trivial_copy_ctor::value, "__type_traits failed");
+    static_assert(__type_traits<Test_FOO_Simple>::has_trivial_assignment_operator::value, "__type_traits failed");
+    static_assert(__type_traits<Test_FOO_Simple>::has_trivial_dtor::value, "__type_traits failed");
+    static_assert(!__type_traits<Test_FOO_Simple>::has_trivial_ctor::value, "__type_traits failed");
+    static_assert(!__type_traits<Test_FOO_Heap>::has_trivial_dtor::value, "__type_traits failed");
+    static_assert(!__type_traits<const int>::has_trivial_assignment_operator::value, "__type_traits failed");
+    static_assert(__type_traits<long double>::is_POD_type::value, "__type_traits failed");
+}
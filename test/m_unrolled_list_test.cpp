@@ -0,0 +1,427 @@
+#include "../src/m_unrolled_list.h"
+#include <list>
+#include <string>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include "test_objects.h"
+
+
+//small nodes, so that the tests go through a lot of splits and merges of nodes
+template <typename T>
+using small_list = my_stl::unrolled_list<T, 4>;
+
+template <typename T, typename List>
+inline void assertUnrolledEqual(const std::list<T>& std_list, const List& my_list) {
+    ASSERT_EQ(std_list.size(), my_list.size());
+    auto m_it = my_list.cbegin();
+    for (auto s_it = std_list.cbegin(); s_it != std_list.cend(); ++s_it, ++m_it) {
+        ASSERT_TRUE(*s_it == *m_it);
+    }
+    ASSERT_TRUE(m_it == my_list.cend());
+    //and backwards
+    auto m_rit = my_list.crbegin();
+    for (auto s_rit = std_list.crbegin(); s_rit != std_list.crend(); ++s_rit, ++m_rit) {
+        ASSERT_TRUE(*s_rit == *m_rit);
+    }
+    ASSERT_TRUE(m_rit == my_list.crend());
+}
+
+template <typename Iterator>
+inline Iterator nth(Iterator it, int n) {
+    for (; n > 0; --n) ++it;
+    return it;
+}
+
+TEST(UnrolledListTest, TestPushAndPop) {
+    std::list<int> s_l;
+    small_list<int> m_l;
+    ASSERT_TRUE(m_l.empty());
+    for (int i = 0; i < 100; ++i) {
+        s_l.push_back(i);
+        m_l.push_back(i);
+        s_l.push_front(-i);
+        m_l.push_front(-i);
+    }
+    assertUnrolledEqual(s_l, m_l);
+    ASSERT_EQ(m_l.front(), s_l.front());
+    ASSERT_EQ(m_l.back(), s_l.back());
+    for (int i = 0; i < 30; ++i) {
+        s_l.pop_back();
+        m_l.pop_back();
+        s_l.pop_front();
+        m_l.pop_front();
+    }
+    assertUnrolledEqual(s_l, m_l);
+    m_l.clear();
+    ASSERT_TRUE(m_l.empty());
+    ASSERT_TRUE(m_l.begin() == m_l.end());
+
+    //the default node size
+    my_stl::unrolled_list<int> m_big(1000, 3);
+    ASSERT_EQ(m_big.size(), 1000);
+    for (int x: m_big) ASSERT_EQ(x, 3);
+}
+
+TEST(UnrolledListTest, TestMovedFrom) {
+    //a moved from list has no end node until it takes an element again
+    small_list<int> m_a{1, 2}, m_b{3};
+    std::swap(m_a, m_b);
+    assertUnrolledEqual(std::list<int>{3}, m_a);
+    assertUnrolledEqual(std::list<int>{1, 2}, m_b);
+
+    small_list<int> m_l{1, 2, 3};
+    small_list<int> m_l2(std::move(m_l));
+    ASSERT_TRUE(m_l.empty());
+    ASSERT_TRUE(m_l.begin() == m_l.end());
+    for (int x: m_l) FAIL() << x;
+    ASSERT_TRUE(m_l == small_list<int>());
+    small_list<int> m_copy(m_l);
+    ASSERT_TRUE(m_copy.empty());
+    m_l.clear();
+    m_l.remove(1);
+    m_l.unique();
+    m_l.sort();
+    m_l.push_back(4);
+    m_l.push_front(5);
+    assertUnrolledEqual(std::list<int>{5, 4}, m_l);
+
+    small_list<int> m_l3(std::move(m_l));
+    m_l.push_front(6);
+    m_l.emplace_front(7);
+    assertUnrolledEqual(std::list<int>{7, 6}, m_l);
+    m_l3 = std::move(m_l);
+    m_l.insert(m_l.cend(), {1, 2, 3, 4, 5});
+    assertUnrolledEqual(std::list<int>{1, 2, 3, 4, 5}, m_l);
+    m_l3 = std::move(m_l);
+    m_l.assign(3, 8);
+    assertUnrolledEqual(std::list<int>{8, 8, 8}, m_l);
+
+    //moved into and out of while empty
+    m_l3 = std::move(m_l);
+    small_list<int> m_l4(std::move(m_l));
+    ASSERT_TRUE(m_l4.empty());
+    m_l = std::move(m_l4);
+    ASSERT_TRUE(m_l.empty());
+    m_l = std::move(m_l3);
+    assertUnrolledEqual(std::list<int>{8, 8, 8}, m_l);
+    m_l3.emplace(m_l3.cend(), 9);
+    assertUnrolledEqual(std::list<int>{9}, m_l3);
+
+    //spliced into
+    m_l3 = std::move(m_l);
+    m_l.splice(m_l.cend(), m_l3);
+    assertUnrolledEqual(std::list<int>{8, 8, 8}, m_l);
+    ASSERT_TRUE(m_l3.empty());
+    m_l3 = std::move(m_l);
+    m_l.splice(m_l.cend(), m_l3, m_l3.cbegin());
+    m_l.splice(m_l.cend(), m_l3, m_l3.cbegin(), m_l3.cend());
+    assertUnrolledEqual(std::list<int>{8, 8, 8}, m_l);
+    m_l3 = std::move(m_l);
+    m_l.merge(m_l3);
+    assertUnrolledEqual(std::list<int>{8, 8, 8}, m_l);
+
+    //with a node pool the end node comes from the pool of the list moved in
+    using pool_list = my_stl::unrolled_list<int, 4, my_stl::node_pool<>>;
+    pool_list m_p1{1, 2, 3}, m_p2{4};
+    std::swap(m_p1, m_p2);
+    pool_list m_p3(std::move(m_p1));
+    m_p1.push_back(5);
+    m_p1 = std::move(m_p2);
+    m_p2 = std::move(m_p3);
+    assertUnrolledEqual(std::list<int>{1, 2, 3}, m_p1);
+    assertUnrolledEqual(std::list<int>{4}, m_p2);
+}
+
+TEST(UnrolledListTest, TestRandomInsertAndErase) {
+    std::list<std::string> s_l;
+    small_list<std::string> m_l;
+    srand(7);
+    for (int round = 0; round < 2000; ++round) {
+        int pos = s_l.empty() ? 0 : rand() % (s_l.size() + 1);
+        int op = rand() % 5;
+        if (op < 3 || s_l.empty()) {
+            std::string val = std::to_string(round);
+            auto s_it = s_l.insert(nth(s_l.begin(), pos), val);
+            auto m_it = m_l.insert(nth(m_l.cbegin(), pos), val);
+            ASSERT_EQ(*s_it, *m_it);
+        }
+        else if (op == 2 && pos < (int) s_l.size()) {
+            auto s_it = s_l.erase(nth(s_l.begin(), pos));
+            auto m_it = m_l.erase(nth(m_l.cbegin(), pos));
+            ASSERT_EQ(s_it == s_l.end(), m_it == m_l.end());
+            if (s_it != s_l.end()) {
+                ASSERT_EQ(*s_it, *m_it);
+            }
+        }
+        else {
+            int len = rand() % 3;
+            if (pos + len > (int) s_l.size())   len = s_l.size() - pos;
+            auto s_it = s_l.erase(nth(s_l.begin(), pos), nth(s_l.begin(), pos + len));
+            auto m_it = m_l.erase(nth(m_l.cbegin(), pos), nth(m_l.cbegin(), pos + len));
+            ASSERT_EQ(s_it == s_l.end(), m_it == m_l.end());
+            if (s_it != s_l.end()) {
+                ASSERT_EQ(*s_it, *m_it);
+            }
+        }
+    }
+    ASSERT_GT(s_l.size(), 20);
+    assertUnrolledEqual(s_l, m_l);
+    //a range over several nodes
+    s_l.erase(nth(s_l.begin(), 3), nth(s_l.begin(), 17));
+    m_l.erase(nth(m_l.cbegin(), 3), nth(m_l.cbegin(), 17));
+    assertUnrolledEqual(s_l, m_l);
+
+    //fill and range insert in the middle of a node
+    std::string arr[] = {"a", "b", "c", "d", "e", "f"};
+    auto s_it = s_l.insert(nth(s_l.begin(), 5), arr, arr + 6);
+    auto m_it = m_l.insert(nth(m_l.cbegin(), 5), arr, arr + 6);
+    ASSERT_EQ(*s_it, *m_it);
+    s_it = s_l.insert(nth(s_l.begin(), 7), 9, "x");
+    m_it = m_l.insert(nth(m_l.cbegin(), 7), 9, "x");
+    ASSERT_EQ(*s_it, *m_it);
+    //an element of the list as the value
+    s_l.insert(nth(s_l.begin(), 1), 5, *nth(s_l.begin(), 3));
+    m_l.insert(nth(m_l.cbegin(), 1), 5, *nth(m_l.cbegin(), 3));
+    assertUnrolledEqual(s_l, m_l);
+
+    //copy and compare
+    small_list<std::string> m_copy(m_l);
+    ASSERT_TRUE(m_copy == m_l);
+    m_copy.pop_front();
+    ASSERT_TRUE(m_copy != m_l);
+}
+
+TEST(UnrolledListTest, TestSplice) {
+    std::list<int> s_l1, s_l2;
+    small_list<int> m_l1, m_l2;
+    for (int i = 0; i < 50; ++i) {
+        s_l1.push_back(i);
+        m_l1.push_back(i);
+        s_l2.push_back(100 + i);
+        m_l2.push_back(100 + i);
+    }
+    //ranges cutting through nodes
+    s_l1.splice(nth(s_l1.begin(), 9), s_l2, nth(s_l2.begin(), 3), nth(s_l2.begin(), 22));
+    m_l1.splice(nth(m_l1.cbegin(), 9), m_l2, nth(m_l2.cbegin(), 3), nth(m_l2.cbegin(), 22));
+    assertUnrolledEqual(s_l1, m_l1);
+    assertUnrolledEqual(s_l2, m_l2);
+    //inside the same list, in the same node
+    s_l1.splice(nth(s_l1.begin(), 1), s_l1, nth(s_l1.begin(), 2), nth(s_l1.begin(), 3));
+    m_l1.splice(nth(m_l1.cbegin(), 1), m_l1, nth(m_l1.cbegin(), 2), nth(m_l1.cbegin(), 3));
+    assertUnrolledEqual(s_l1, m_l1);
+    s_l1.splice(s_l1.end(), s_l1, nth(s_l1.begin(), 5), nth(s_l1.begin(), 30));
+    m_l1.splice(m_l1.cend(), m_l1, nth(m_l1.cbegin(), 5), nth(m_l1.cbegin(), 30));
+    assertUnrolledEqual(s_l1, m_l1);
+    s_l1.splice(s_l1.begin(), s_l1, nth(s_l1.begin(), 40), s_l1.end());
+    m_l1.splice(m_l1.cbegin(), m_l1, nth(m_l1.cbegin(), 40), m_l1.cend());
+    assertUnrolledEqual(s_l1, m_l1);
+    //single elements
+    s_l2.splice(nth(s_l2.begin(), 2), s_l1, nth(s_l1.begin(), 13));
+    m_l2.splice(nth(m_l2.cbegin(), 2), m_l1, nth(m_l1.cbegin(), 13));
+    s_l1.splice(nth(s_l1.begin(), 7), s_l1, nth(s_l1.begin(), 6));
+    m_l1.splice(nth(m_l1.cbegin(), 7), m_l1, nth(m_l1.cbegin(), 6));
+    assertUnrolledEqual(s_l1, m_l1);
+    assertUnrolledEqual(s_l2, m_l2);
+    //whole list
+    s_l1.splice(nth(s_l1.begin(), 3), s_l2);
+    m_l1.splice(nth(m_l1.cbegin(), 3), m_l2);
+    assertUnrolledEqual(s_l1, m_l1);
+    assertUnrolledEqual(s_l2, m_l2);
+    //the iterators of whole nodes moved stay valid
+    small_list<int> m_l3 = {1, 2, 3, 4, 5, 6, 7, 8};
+    auto it = nth(m_l3.begin(), 5);
+    m_l2.splice(m_l2.cbegin(), m_l3);
+    ASSERT_EQ(*it, 6);
+    ASSERT_EQ(m_l2.size(), 8);
+    ASSERT_TRUE(m_l3.empty());
+}
+
+TEST(UnrolledListTest, TestRemoveUniqueMergeSort) {
+    std::list<int> s_l1, s_l2;
+    small_list<int> m_l1, m_l2;
+    srand(11);
+    for (int i = 0; i < 500; ++i) {
+        int x = rand() % 50, y = rand() % 50;
+        s_l1.push_back(x);
+        m_l1.push_back(x);
+        s_l2.push_back(y);
+        m_l2.push_back(y);
+    }
+    s_l1.remove(7);
+    m_l1.remove(7);
+    assertUnrolledEqual(s_l1, m_l1);
+    s_l1.sort();
+    m_l1.sort();
+    s_l2.sort();
+    m_l2.sort();
+    assertUnrolledEqual(s_l1, m_l1);
+    assertUnrolledEqual(s_l2, m_l2);
+    s_l1.merge(s_l2);
+    m_l1.merge(m_l2);
+    assertUnrolledEqual(s_l1, m_l1);
+    ASSERT_TRUE(m_l2.empty());
+    s_l1.unique();
+    m_l1.unique();
+    assertUnrolledEqual(s_l1, m_l1);
+    //an element of the list as the value to remove
+    s_l1.remove(*nth(s_l1.begin(), 4));
+    m_l1.remove(*nth(m_l1.begin(), 4));
+    assertUnrolledEqual(s_l1, m_l1);
+}
+
+//sort by the key only, the payload tells whether the equal keys kept their order
+struct key_less {
+    bool operator()(const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) const {
+        return lhs.first < rhs.first;
+    }
+};
+
+TEST(UnrolledListTest, TestStableSort) {
+    std::list<std::pair<int, int>> s_l;
+    my_stl::unrolled_list<std::pair<int, int>, 8> m_l;
+    srand(3);
+    for (int i = 0; i < 3000; ++i) {
+        std::pair<int, int> p(rand() % 20, i);
+        s_l.push_back(p);
+        m_l.push_back(p);
+    }
+    s_l.sort(key_less());
+    m_l.sort(key_less());
+    assertUnrolledEqual(s_l, m_l);
+}
+
+struct heap_less {
+    bool operator()(const Test_FOO_Heap& lhs, const Test_FOO_Heap& rhs) const {
+        return *lhs.getIntMember() < *rhs.getIntMember();
+    }
+};
+
+TEST(UnrolledListTest, TestNodePool) {
+    using pool_list = my_stl::unrolled_list<Test_FOO_Heap, 4, my_stl::node_pool<>>;
+    pool_list m_l1, m_l2;
+    for (int i = 0; i < 40; ++i) {
+        m_l1.push_back(Test_FOO_Heap(40 - i));
+        m_l2.push_back(Test_FOO_Heap(i));
+    }
+    m_l1.sort(heap_less());
+    m_l2.sort(heap_less());
+    m_l1.merge(m_l2, heap_less());
+    ASSERT_EQ(m_l1.size(), 80);
+    ASSERT_TRUE(m_l1.front() == Test_FOO_Heap(0));
+    ASSERT_TRUE(m_l1.back() == Test_FOO_Heap(40));
+    {
+        pool_list m_l3(std::move(m_l2));
+        m_l3.push_back(Test_FOO_Heap(5));
+        m_l1.splice(m_l1.cbegin(), m_l3);
+    }
+    ASSERT_EQ(m_l1.size(), 81);
+    ASSERT_TRUE(m_l1.front() == Test_FOO_Heap(5));
+}
+
+//counts the nodes handed out, merge and sort should live off the nodes they drain
+struct NodeCounter {
+    static size_t calls;
+    static size_t live;
+
+    static void* allocate(size_t n) {
+        ++calls;
+        ++live;
+        return malloc(n);
+    }
+
+    static void deallocate(void* p, size_t) {
+        --live;
+        free(p);
+    }
+};
+size_t NodeCounter::calls = 0;
+size_t NodeCounter::live = 0;
+
+template <typename List>
+void checkMergeSort(int rounds) {
+    for (int round = 0; round < rounds; ++round) {
+        std::list<int> s_l1, s_l2;
+        List m_l1, m_l2;
+        //pushed at the back, so the nodes are full and the merges interleave them
+        const int n1 = rand() % 120, n2 = rand() % 120;
+        for (int i = 0; i < n1; ++i) {
+            s_l1.push_back(rand() % 40);
+            m_l1.push_back(s_l1.back());
+        }
+        for (int i = 0; i < n2; ++i) {
+            s_l2.push_back(rand() % 40);
+            m_l2.push_back(s_l2.back());
+        }
+        size_t calls = NodeCounter::calls;
+        s_l1.sort();
+        m_l1.sort();
+        s_l2.sort();
+        m_l2.sort();
+        ASSERT_LE(NodeCounter::calls, calls + 4);
+        assertUnrolledEqual(s_l1, m_l1);
+        assertUnrolledEqual(s_l2, m_l2);
+        calls = NodeCounter::calls;
+        const size_t live = NodeCounter::live;
+        s_l1.merge(s_l2);
+        m_l1.merge(m_l2);
+        ASSERT_LE(NodeCounter::calls, calls + 2);
+        ASSERT_LE(NodeCounter::live, live);
+        assertUnrolledEqual(s_l1, m_l1);
+        ASSERT_TRUE(m_l2.empty());
+        ASSERT_TRUE(m_l2.begin() == m_l2.end());
+        m_l2.push_back(1);
+        ASSERT_EQ(m_l2.size(), 1);
+    }
+}
+
+TEST(UnrolledListTest, TestMergeSortNodes) {
+    srand(5);
+    checkMergeSort<my_stl::unrolled_list<int, 4, NodeCounter>>(200);
+    checkMergeSort<my_stl::unrolled_list<int, 1, NodeCounter>>(50);
+    checkMergeSort<my_stl::unrolled_list<int, 7, NodeCounter>>(50);
+    ASSERT_EQ(NodeCounter::live, 0);
+}
+
+//a comparison giving up after a number of calls
+struct ThrowingLess {
+    int* budget;
+    bool operator()(int lhs, int rhs) const {
+        if ((*budget)-- == 0)   throw std::runtime_error("compare failed");
+        return lhs < rhs;
+    }
+};
+
+TEST(UnrolledListTest, TestMergeSortExceptions) {
+    srand(9);
+    //whenever it throws, every element is still there and the list can be walked both ways
+    for (int budget_start = 0; budget_start < 400; budget_start += 13) {
+        small_list<int> m_l1, m_l2;
+        std::vector<int> all;
+        for (int i = 0; i < 60; ++i) {
+            m_l1.push_back(rand() % 100);
+            m_l2.push_back(rand() % 100);
+            all.push_back(m_l1.back());
+            all.push_back(m_l2.back());
+        }
+        int budget = budget_start;
+        try {
+            m_l2.sort(ThrowingLess{&budget});
+            m_l1.sort(ThrowingLess{&budget});
+            m_l1.merge(m_l2, ThrowingLess{&budget});
+        }
+        catch (const std::runtime_error&) {}
+        ASSERT_EQ(m_l1.size() + m_l2.size(), all.size());
+        std::vector<int> kept;
+        for (int x: m_l1)   kept.push_back(x);
+        for (int x: m_l2)   kept.push_back(x);
+        size_t backwards = 0;
+        for (auto it = m_l1.crbegin(); it != m_l1.crend(); ++it)    ++backwards;
+        ASSERT_EQ(backwards, m_l1.size());
+        std::sort(kept.begin(), kept.end());
+        std::sort(all.begin(), all.end());
+        ASSERT_TRUE(kept == all);
+    }
+}
@@ -1,8 +1,10 @@
 #include "../src/m_vector.h"
+#include "../src/m_list.h"
 #include <gtest/gtest.h>
 #include "test_objects.h"
 #include <ctime>   //for std::clock()
 #include <string>  //for std::string
+#include <stdexcept>  //for std::runtime_error
 
 
 template<typename T>
@@ -421,3 +423,439 @@ TEST(VectorTest, TestListInitialization) {
     my_stl::vector<int> mvs3 = {5, 19, 20, 43, -2, 15};
     assertSizeAndCapacity(svs3, mvs3);   
 }
+
+//an arena-like allocator with state, counts the bytes it handed out
+struct CountingAlloc {
+    size_t* bytes_in_use;
+    explicit CountingAlloc(size_t* counter): bytes_in_use(counter) {}
+
+    void* allocate(size_t n) {
+        *bytes_in_use += n;
+        return malloc(n);
+    }
+
+    void deallocate(void* p, size_t n) {
+        *bytes_in_use -= n;
+        free(p);
+    }
+};
+
+TEST(VectorTest, TestAllocator) {
+    //the library allocators are empty, they cost nothing in the vector
+    static_assert(sizeof(my_stl::vector<int>) == 3 * sizeof(int*), "allocator takes space in vector");
+    static_assert(sizeof(my_stl::vector<int, my_stl::alloc>) == 3 * sizeof(int*), "allocator takes space in vector");
+
+    //pooled storage
+    {
+        std::vector<int> sv;
+        my_stl::vector<int, my_stl::alloc> mv;
+        for (int i = 0; i < 1000; ++i) {
+            sv.push_back(i);
+            mv.push_back(i);
+            ASSERT_EQ(sv.capacity(), mv.capacity());
+        }
+        my_stl::vector<int, my_stl::alloc> copy(mv);
+        ASSERT_EQ(copy == mv, true);
+        mv.insert(mv.begin() + 3, 100, -1);
+        sv.insert(sv.begin() + 3, 100, -1);
+        for (size_t i = 0; i < sv.size(); ++i) {
+            ASSERT_EQ(sv[i], mv[i]);
+        }
+    }
+
+    //stateful allocator
+    size_t counter1 = 0, counter2 = 0;
+    {
+        my_stl::vector<Test_FOO_Heap, CountingAlloc> mv1((CountingAlloc(&counter1)));
+        for (int i = 0; i < 100; ++i) {
+            mv1.push_back(Test_FOO_Heap(i));
+        }
+        ASSERT_EQ(counter1, mv1.capacity() * sizeof(Test_FOO_Heap));
+        ASSERT_EQ(mv1.get_allocator().bytes_in_use, &counter1);
+
+        my_stl::vector<Test_FOO_Heap, CountingAlloc> mv2(10, Test_FOO_Heap(3), CountingAlloc(&counter2));
+        ASSERT_EQ(counter2, 10 * sizeof(Test_FOO_Heap));
+        //swap exchanges the allocators together with the storage
+        mv1.swap(mv2);
+        ASSERT_EQ(mv1.get_allocator().bytes_in_use, &counter2);
+        ASSERT_EQ(mv2.get_allocator().bytes_in_use, &counter1);
+        mv2.reserve(1000);
+        ASSERT_EQ(counter1, 1000 * sizeof(Test_FOO_Heap));
+
+        //the copy uses the allocator of its source, the move takes it away
+        my_stl::vector<Test_FOO_Heap, CountingAlloc> mv3(mv1);
+        ASSERT_EQ(counter2, 20 * sizeof(Test_FOO_Heap));
+        my_stl::vector<Test_FOO_Heap, CountingAlloc> mv4(std::move(mv3));
+        ASSERT_EQ(mv4.get_allocator().bytes_in_use, &counter2);
+        ASSERT_EQ(counter2, 20 * sizeof(Test_FOO_Heap));
+        mv4 = mv2;
+        ASSERT_EQ(mv4.get_allocator().bytes_in_use, &counter1);
+        ASSERT_EQ(counter2, 10 * sizeof(Test_FOO_Heap));
+    }
+    ASSERT_EQ(counter1, 0) << "memory leaked from stateful allocator";
+    ASSERT_EQ(counter2, 0) << "memory leaked from stateful allocator";
+}
+
+//counts how many times it has been copied or moved, the copy can be told to throw
+struct MoveCounter {
+    static int copies;
+    static int moves;
+    static int copies_before_throw;
+    int value;
+    MoveCounter(int v): value(v) {}
+    MoveCounter(const MoveCounter& rhs): value(rhs.value) {
+        if (copies_before_throw == 0)   throw std::runtime_error("copy failed");
+        --copies_before_throw;
+        ++copies;
+    }
+    MoveCounter(MoveCounter&& rhs) noexcept: value(rhs.value) {
+        rhs.value = -1;
+        ++moves;
+    }
+    MoveCounter& operator=(const MoveCounter& rhs) = default;
+    MoveCounter& operator=(MoveCounter&& rhs) = default;
+};
+int MoveCounter::copies = 0;
+int MoveCounter::moves = 0;
+int MoveCounter::copies_before_throw = -1;
+
+//same, but the move ctor may throw, the vector has to copy when it grows
+struct ThrowingMove {
+    static int copies_before_throw;
+    int value;
+    ThrowingMove(int v): value(v) {}
+    ThrowingMove(const ThrowingMove& rhs): value(rhs.value) {
+        if (copies_before_throw == 0)   throw std::runtime_error("copy failed");
+        --copies_before_throw;
+    }
+    ThrowingMove(ThrowingMove&& rhs): value(rhs.value) {}
+};
+int ThrowingMove::copies_before_throw = -1;
+
+TEST(VectorTest, TestMoveOnGrowth) {
+    MoveCounter::copies = MoveCounter::moves = 0;
+    my_stl::vector<MoveCounter> mv;
+    for (int i = 0; i < 1000; ++i) {
+        mv.push_back(MoveCounter(i));
+    }
+    //growing never copies a nothrow movable type
+    ASSERT_EQ(MoveCounter::copies, 0);
+    mv.reserve(5000);
+    mv.insert(mv.begin() + 10, 3, MoveCounter(-2));
+    //one copy of the value, the shifted slots are assigned
+    ASSERT_EQ(MoveCounter::copies, 1);
+    ASSERT_EQ(mv.size(), 1003);
+    ASSERT_EQ(mv[9].value, 9);
+    ASSERT_EQ(mv[12].value, -2);
+    ASSERT_EQ(mv[13].value, 10);
+    ASSERT_EQ(mv[1002].value, 999);
+
+    //emplace_back builds the element in place
+    MoveCounter::copies = MoveCounter::moves = 0;
+    my_stl::vector<MoveCounter> ev;
+    ev.reserve(10);
+    ev.emplace_back(5);
+    ASSERT_EQ(MoveCounter::copies + MoveCounter::moves, 0);
+    ASSERT_EQ(ev.back().value, 5);
+
+    //vector of move only type
+    my_stl::vector<my_stl::unique_ptr<int>> uv;
+    for (int i = 0; i < 100; ++i) {
+        uv.emplace_back(new int(i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(*uv[i], i);
+    }
+}
+
+TEST(VectorTest, TestPushBackAliasing) {
+    //the argument refers to an element of the full vector
+    my_stl::vector<std::string> mv;
+    mv.push_back("first element which is long enough to live on the heap");
+    for (int i = 0; i < 100; ++i) {
+        mv.push_back(mv[0]);
+    }
+    for (size_t i = 0; i < mv.size(); ++i) {
+        ASSERT_EQ(mv[i], mv[0]);
+    }
+    my_stl::vector<int> iv = {1, 2, 3};
+    iv.insert(iv.begin(), 10, iv[2]);
+    iv.insert(iv.begin(), 2, iv[12]);
+    ASSERT_EQ(iv.size(), 15);
+    for (size_t i = 0; i < 12; ++i) {
+        ASSERT_EQ(iv[i], 3);
+    }
+    iv.resize(100, iv[12]);
+    ASSERT_EQ(iv[99], 1);
+}
+
+TEST(VectorTest, TestStrongExceptionSafety) {
+    my_stl::vector<ThrowingMove> mv;
+    mv.reserve(8);
+    for (int i = 0; i < 8; ++i) {
+        mv.push_back(ThrowingMove(i));
+    }
+    //the move ctor may throw, so the growth copies, and the third copy fails
+    ThrowingMove::copies_before_throw = 3;
+    ASSERT_THROW(mv.push_back(ThrowingMove(8)), std::runtime_error);
+    ThrowingMove::copies_before_throw = -1;
+    ASSERT_EQ(mv.size(), 8);
+    ASSERT_EQ(mv.capacity(), 8);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(mv[i].value, i);
+    }
+
+    //same for reserve
+    ThrowingMove::copies_before_throw = 5;
+    ASSERT_THROW(mv.reserve(100), std::runtime_error);
+    ThrowingMove::copies_before_throw = -1;
+    ASSERT_EQ(mv.capacity(), 8);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(mv[i].value, i);
+    }
+
+    //a failed copy in the ctor does not leak the constructed part
+    std::vector<MoveCounter> source(10, MoveCounter(1));
+    MoveCounter::copies_before_throw = 4;
+    ASSERT_THROW(my_stl::vector<MoveCounter> bad(source.data(), source.data() + 10), std::runtime_error);
+    MoveCounter::copies_before_throw = -1;
+}
+
+TEST(VectorTest, TestRelocation) {
+    static_assert(my_stl::is_trivially_relocatable<my_stl::vector<int>>::value, "vector is relocatable");
+    static_assert(my_stl::is_trivially_relocatable<my_stl::unique_ptr<int>>::value, "unique_ptr is relocatable");
+
+    //vector of vectors, the inner storage is carried over by memcpy
+    my_stl::vector<my_stl::vector<int>> vv;
+    std::vector<int*> inner_storage;
+    for (int i = 0; i < 200; ++i) {
+        vv.push_back(my_stl::vector<int>(i + 1, i));
+        inner_storage.push_back(&vv.back()[0]);
+    }
+    vv.insert(vv.begin() + 50, 2, my_stl::vector<int>(3, -1));
+    vv.erase(vv.begin() + 10, vv.begin() + 20);
+    vv.reserve(1000);
+    ASSERT_EQ(vv.size(), 192);
+    for (int i = 0; i < 192; ++i) {
+        int orig = i < 10 ? i : (i < 40 ? i + 10 : (i < 42 ? -1 : i + 8));
+        if (orig == -1) {
+            ASSERT_EQ(vv[i].size(), 3);
+            ASSERT_EQ(vv[i][0], -1);
+        }
+        else {
+            ASSERT_EQ(vv[i].size(), orig + 1);
+            ASSERT_EQ(vv[i][orig], orig);
+            //the element storage is never copied
+            ASSERT_EQ(&vv[i][0], inner_storage[orig]);
+        }
+    }
+
+    //the same through the pooled allocator, which grows the block by reallocate
+    my_stl::vector<my_stl::unique_ptr<int>, my_stl::alloc> uv;
+    for (int i = 0; i < 1000; ++i) {
+        uv.push_back(my_stl::unique_ptr<int>(new int(i)));
+        //the argument refers to an element of the vector itself
+        if (uv.size() == uv.capacity()) uv.push_back(std::move(uv.back()));
+    }
+    //the first element has been moved to the back
+    ASSERT_EQ(uv[0] ? true : false, false);
+    uv.erase(uv.begin());
+    int owned = 0;
+    long long sum = 0;
+    for (size_t i = 0; i < uv.size(); ++i) {
+        if (uv[i]) {
+            ++owned;
+            sum += *uv[i];
+        }
+    }
+    ASSERT_EQ(owned, 1000);
+    ASSERT_EQ(sum, 999 * 1000 / 2);
+
+    //a stateful allocator without reallocate uses new storage plus memcpy
+    size_t counter = 0;
+    {
+        my_stl::vector<my_stl::vector<int>, CountingAlloc> cv((CountingAlloc(&counter)));
+        for (int i = 0; i < 100; ++i) {
+            cv.emplace_back(10, i);
+        }
+        ASSERT_EQ(counter, cv.capacity() * sizeof(my_stl::vector<int>));
+        ASSERT_EQ(cv[99][9], 99);
+    }
+    ASSERT_EQ(counter, 0);
+}
+
+template <typename T>
+void testFill(const T& value, const T& zero) {
+    for (size_t n: {0, 1, 3, 17, 100, 1001}) {
+        std::vector<T> sv(n, value);
+        my_stl::vector<T> mv(n, value);
+        assertSizeAndCapacity(sv, mv);
+        assertElementsEqual(sv, mv);
+        sv.resize(2 * n + 5, zero);
+        mv.resize(2 * n + 5, zero);
+        assertElementsEqual(sv, mv);
+        sv.insert(sv.begin() + n / 2, n + 3, value);
+        mv.insert(mv.begin() + n / 2, n + 3, value);
+        assertSizeAndCapacity(sv, mv);
+        assertElementsEqual(sv, mv);
+        //copy of a trivially copyable range
+        my_stl::vector<T> cv(mv);
+        ASSERT_EQ(cv == mv, true);
+    }
+}
+
+TEST(VectorTest, TestTrivialFill) {
+    testFill<char>('x', 0);
+    testFill<short>(-3, 0);
+    testFill<int>(0x01020304, 0);
+    testFill<double>(-0.0, 0.0);
+    testFill<long long>(1ll << 40, 0);
+    testFill(Test_FOO_Simple(1, 2, 'c'), Test_FOO_Simple(0, 0, 0));
+    testFill(Test_FOO_Array(7), Test_FOO_Array(0));
+}
+
+//capacities the vector goes through on push_back
+template <typename Vec>
+std::vector<size_t> growthSteps(size_t n) {
+    Vec v;
+    std::vector<size_t> caps;
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(typename Vec::value_type());
+        if (caps.empty() || caps.back() != v.capacity()) caps.push_back(v.capacity());
+    }
+    return caps;
+}
+
+TEST(VectorTest, TestGrowthPolicy) {
+    typedef my_stl::__malloc_alloc<0> malloc_alloc;
+    //the default is the same as std::vector, checked everywhere above
+    ASSERT_EQ(growthSteps<my_stl::vector<int>>(20), std::vector<size_t>({1, 2, 4, 8, 16, 32}));
+    ASSERT_EQ((growthSteps<my_stl::vector<int, malloc_alloc, my_stl::one_and_half_growth<>>>(20)),
+            std::vector<size_t>({1, 2, 3, 4, 6, 9, 13, 19, 28}));
+    //minimum first allocation
+    ASSERT_EQ((growthSteps<my_stl::vector<int, malloc_alloc, my_stl::double_growth<16>>>(40)),
+            std::vector<size_t>({16, 32, 64}));
+    ASSERT_EQ((growthSteps<my_stl::vector<int, malloc_alloc, my_stl::one_and_half_growth<10>>>(20)),
+            std::vector<size_t>({10, 15, 22}));
+
+    //rounded up to the size classes of the pool, a char vector starts with 8
+    typedef my_stl::vector<char, my_stl::alloc, my_stl::size_class_growth<>> class_vector;
+    std::vector<size_t> caps = growthSteps<class_vector>(5000);
+    ASSERT_EQ(caps[0], 8u);
+    for (size_t i = 0; i < caps.size(); ++i) {
+        ASSERT_EQ(my_stl::alloc::good_size(caps[i]), caps[i]);
+        if (i) {
+            ASSERT_GE(caps[i], 2 * caps[i - 1]);
+        }
+    }
+    //the rounding never goes below what the element size allows
+    typedef my_stl::vector<Test_FOO_Array, my_stl::alloc, my_stl::size_class_growth<>> array_vector;
+    for (size_t cap : growthSteps<array_vector>(100)) {
+        ASSERT_LE(my_stl::alloc::good_size(cap * sizeof(Test_FOO_Array)),
+                (cap + 1) * sizeof(Test_FOO_Array));
+    }
+
+    //insert goes through the policy as well
+    my_stl::vector<int, malloc_alloc, my_stl::double_growth<16>> v;
+    v.insert(v.begin(), 3, 1);
+    ASSERT_EQ(v.capacity(), 16u);
+    v.insert(v.begin(), 40, 2);
+    ASSERT_EQ(v.capacity(), 43u);
+    ASSERT_EQ(v.size(), 43u);
+    for (size_t i = 0; i < v.size(); ++i) ASSERT_EQ(v[i], i < 40 ? 2 : 1);
+}
+
+//a single pass iterator over a std::vector, its length is not known up front
+template <typename T>
+struct OnePassIter {
+    typedef my_stl::input_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+    const T* p;
+    const T& operator*() const {return *p;}
+    OnePassIter& operator++() {++p; return *this;}
+    bool operator!=(const OnePassIter& rhs) const {return p != rhs.p;}
+    bool operator==(const OnePassIter& rhs) const {return p == rhs.p;}
+};
+
+template <typename T> T rangeValue(int i) {return T(i);}
+template <> std::string rangeValue<std::string>(int i) {return std::to_string(i);}
+
+template <typename T>
+void testRangeInsert() {
+    std::vector<T> src, lcopy;
+    my_stl::list<T> lsrc;
+    for (int i = 0; i < 50; ++i) {
+        src.push_back(rangeValue<T>(i));
+        lcopy.push_back(rangeValue<T>(i + 100));
+        lsrc.push_back(rangeValue<T>(i + 100));
+    }
+    for (size_t n : {0, 3, 10}) {
+        for (size_t len : {0, 1, 7, 50}) {
+            for (size_t at : {size_t(0), n / 2, n}) {
+                //random access, forward and single pass ranges, with and without room left
+                for (size_t room : {size_t(0), len}) {
+                    std::vector<T> sv(src.begin(), src.begin() + n);
+                    my_stl::vector<T> mv(src.data(), src.data() + n);
+                    mv.reserve(n + room);
+                    auto it = mv.insert(mv.begin() + at, src.data(), src.data() + len);
+                    sv.insert(sv.begin() + at, src.begin(), src.begin() + len);
+                    ASSERT_EQ(it, mv.begin() + at);
+                    assertElementsEqual(sv, mv);
+
+                    auto lend = lsrc.begin();
+                    my_stl::advance(lend, len);
+                    mv.insert(mv.begin() + at, lsrc.begin(), lend);
+                    sv.insert(sv.begin() + at, lcopy.begin(), lcopy.begin() + len);
+                    assertElementsEqual(sv, mv);
+
+                    OnePassIter<T> first = {src.data()}, last = {src.data() + len};
+                    mv.insert(mv.begin() + at, first, last);
+                    sv.insert(sv.begin() + at, src.begin(), src.begin() + len);
+                    assertElementsEqual(sv, mv);
+                }
+            }
+        }
+    }
+    //append, through realloc for the relocatable types
+    my_stl::vector<T> mv;
+    std::vector<T> sv;
+    for (int round = 0; round < 20; ++round) {
+        mv.append(src.data(), src.data() + round);
+        sv.insert(sv.end(), src.begin(), src.begin() + round);
+    }
+    assertElementsEqual(sv, mv);
+    //construction from a forward range allocates once
+    my_stl::vector<T> lv(lsrc.begin(), lsrc.end());
+    ASSERT_EQ(lv.capacity(), 50u);
+    ASSERT_TRUE(lv[49] == lcopy[49]);
+}
+
+TEST(VectorTest, TestRangeInsert) {
+    testRangeInsert<int>();
+    testRangeInsert<Test_FOO_Heap>();
+    testRangeInsert<std::string>();
+    //two integers are still count and value
+    my_stl::vector<int> v;
+    v.insert(v.begin(), 3, 7);
+    ASSERT_EQ(v.size(), 3u);
+    ASSERT_EQ(v[2], 7);
+}
+
+TEST(VectorTest, TestElementAccess) {
+    my_stl::vector<int> v;
+    ASSERT_EQ(v.data(), nullptr);
+    ASSERT_THROW(v.at(0), std::out_of_range);
+    for (int i = 0; i < 10; ++i) v.push_back(i);
+    ASSERT_EQ(v.data(), &v[0]);
+    ASSERT_EQ(v.data() + 10, v.end());
+    v.at(3) = 30;
+    ASSERT_EQ(v[3], 30);
+    const my_stl::vector<int>& cv = v;
+    ASSERT_EQ(cv.at(9), 9);
+    ASSERT_EQ(cv.data(), v.data());
+    ASSERT_THROW(cv.at(10), std::out_of_range);
+    ASSERT_THROW(v.at(size_t(-1)), std::out_of_range);
+}
@@ -97,7 +97,7 @@ Test_FOO_Heap& Test_FOO_Heap::operator=(Test_FOO_Heap&& rhs) noexcept {
     return *this;
 }
 
-Test_FOO_Heap::Test_FOO_Heap(Test_FOO_Heap&& foo): m1(foo.m1), m2(foo.m2) {
+Test_FOO_Heap::Test_FOO_Heap(Test_FOO_Heap&& foo) noexcept: m1(foo.m1), m2(foo.m2) {
     foo.m1 = nullptr;
     foo.m2 = nullptr;
 }
@@ -50,7 +50,7 @@ class Test_FOO_Heap {
         Test_FOO_Heap(const Test_FOO_Heap& foo);
         Test_FOO_Heap& operator=(const Test_FOO_Heap& foo);
 
-        Test_FOO_Heap(Test_FOO_Heap&& foo);
+        Test_FOO_Heap(Test_FOO_Heap&& foo) noexcept;
         Test_FOO_Heap& operator=(Test_FOO_Heap&& rhs) noexcept;
 
         bool operator==(const Test_FOO_Heap& rhs) const;